@@ -3,22 +3,35 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#include "gameObject.h"
-#include "model.h"
+#include "entityPool.h"
 
-Projectile::Projectile(glm::vec3 position, glm::vec3 velocity, Model* objectModel) : GameObject(position, objectModel)
+ProjectilePool::ProjectilePool(unsigned int capacity) : EntityPool(capacity)
 {
-	this->position.y -= 0.5f;
-	this->velocity = velocity;
+
 }
 
+EntityHandle ProjectilePool::Fire(glm::vec3 position, glm::vec3 direction)
+{
+	position.y -= 0.5f;
+	return Add(position, direction * speed, radius);
+}
 
-void Projectile::Update(float timeElapsed)
+void ProjectilePool::Update(float timeElapsed)
 {
-	if (position.y < 0.0f)
+	UpdateRange(timeElapsed, 0, Size());
+}
+
+void ProjectilePool::UpdateRange(float timeElapsed, unsigned int begin, unsigned int end)
+{
+	glm::vec3* position = positions.data();
+	glm::vec3* velocity = velocities.data();
+	for (unsigned int i = begin; i < end; i++)
 	{
-		position.y = 0.0f;
-		velocity.y *= -1.0f;
+		if (position[i].y < 0.0f)
+		{
+			position[i].y = 0.0f;
+			velocity[i].y *= -1.0f;
+		}
+		position[i] += velocity[i] * timeElapsed;
 	}
-	position += speed * velocity * timeElapsed;
-}
\ No newline at end of file
+}
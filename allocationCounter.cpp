@@ -0,0 +1,162 @@
+#include "allocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<unsigned long long> allocationCount{ 0 };
+	std::atomic<unsigned long long> allocationBytes{ 0 };
+
+	void* countedAllocate(size_t size)
+	{
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+		allocationBytes.fetch_add(size, std::memory_order_relaxed);
+		return malloc(size > 0 ? size : 1);
+	}
+
+	void* countedAllocateAligned(size_t size, size_t alignment)
+	{
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+		allocationBytes.fetch_add(size, std::memory_order_relaxed);
+		//aligned_alloc wants the size to be a multiple of the alignment
+		size = (size + alignment - 1) / alignment * alignment;
+#ifdef _WIN32
+		return _aligned_malloc(size > 0 ? size : alignment, alignment);
+#else
+		return aligned_alloc(alignment, size > 0 ? size : alignment);
+#endif
+	}
+
+	void alignedFree(void* pointer)
+	{
+#ifdef _WIN32
+		_aligned_free(pointer);
+#else
+		free(pointer);
+#endif
+	}
+}
+
+AllocationStats GetAllocationStats()
+{
+	AllocationStats stats;
+	stats.count = allocationCount.load(std::memory_order_relaxed);
+	stats.bytes = allocationBytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
+AllocationStats AllocationsSince(const AllocationStats& start)
+{
+	AllocationStats now = GetAllocationStats();
+	now.count -= start.count;
+	now.bytes -= start.bytes;
+	return now;
+}
+
+void* operator new(size_t size)
+{
+	void* pointer = countedAllocate(size);
+	if (!pointer)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	void* pointer = countedAllocateAligned(size, (size_t)alignment);
+	if (!pointer)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return countedAllocateAligned(size, (size_t)alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return countedAllocateAligned(size, (size_t)alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+	free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+	alignedFree(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+	alignedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept
+{
+	alignedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept
+{
+	alignedFree(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	alignedFree(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	alignedFree(pointer);
+}
@@ -0,0 +1,19 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+//every operator new in the program goes through allocationCounter.cpp, which counts them.
+//take the difference either side of a frame to see how much it allocated, from any thread.
+//it costs two atomic adds per allocation, so it is its own library that only headless and the game link
+struct AllocationStats
+{
+	unsigned long long count = 0;
+	unsigned long long bytes = 0;
+};
+
+AllocationStats GetAllocationStats();
+//allocations made since an earlier GetAllocationStats
+AllocationStats AllocationsSince(const AllocationStats& start);
+
+#endif
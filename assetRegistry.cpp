@@ -0,0 +1,121 @@
+#include "assetRegistry.h"
+
+#include <glad/glad.h>
+#include <stb_image.h>
+
+#include <string>
+#include <iostream>
+#include <map>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <tuple>
+
+#include "model.h"
+
+AssetRegistry::~AssetRegistry()
+{
+	Clear();
+}
+
+bool AssetRegistry::ModelKey::operator<(const ModelKey& other) const
+{
+	return std::tie(path, retainGeometry, lodRatios) < std::tie(other.path, other.retainGeometry, other.lodRatios);
+}
+
+ModelHandle AssetRegistry::LoadModel(const std::string& path, bool retainGeometry, std::vector<float> lodRatios)
+{
+	ModelHandle handle;
+	ModelKey key = { path, retainGeometry, lodRatios };
+	auto found = modelIds.find(key);
+	if (found != modelIds.end())
+	{
+		handle.id = found->second;
+		return handle;
+	}
+	handle.id = (unsigned int)models.size();
+	models.push_back(std::make_unique<Model>(path, *this, retainGeometry, std::move(lodRatios)));
+	modelIds[std::move(key)] = handle.id;
+	return handle;
+}
+
+Model* AssetRegistry::Get(ModelHandle handle)
+{
+	if (handle.id >= models.size())
+		return nullptr;
+	return models[handle.id].get();
+}
+
+unsigned int AssetRegistry::LoadTexture(const std::string& path)
+{
+	auto found = textureIds.find(path);
+	if (found != textureIds.end())
+		return found->second;
+	unsigned int textureID = TextureFromFile(path);
+	textureIds[path] = textureID;
+	return textureID;
+}
+
+void AssetRegistry::Clear()
+{
+	//meshes free their own buffers, the textures they point to are freed here
+	models.clear();
+	modelIds.clear();
+	for (auto& texture : textureIds)
+		glDeleteTextures(1, &texture.second);
+	textureIds.clear();
+}
+
+void AssetRegistry::PrintStats()
+{
+	size_t gpuBytes = 0;
+	size_t retainedBytes = 0;
+	unsigned int meshCount = 0;
+	for (unsigned int i = 0; i < models.size(); i++)
+	{
+		for (auto& mesh : models[i]->getMeshes())
+		{
+			gpuBytes += mesh.getGpuBytes();
+			retainedBytes += mesh.getRetainedBytes();
+			meshCount++;
+		}
+	}
+	std::cout << "assets: " << models.size() << " models, " << meshCount << " meshes, " << textureIds.size() << " textures\n"
+		<< "geometry uploaded: " << gpuBytes / 1024 << "KB, retained on cpu: " << retainedBytes / 1024 << "KB" << std::endl;
+}
+
+unsigned int AssetRegistry::TextureFromFile(const std::string& filename)
+{
+	unsigned int textureID;
+	glGenTextures(1, &textureID);
+
+	int width, height, numChannels;
+	stbi_set_flip_vertically_on_load(true);
+	unsigned char* data = stbi_load(filename.c_str(), &width, &height, &numChannels, 0);
+	if (data)
+	{
+		GLenum format = GL_RGBA;
+		if (numChannels == 1)
+			format = GL_RED;
+		if (numChannels == 3)
+			format = GL_RGB;
+		if (numChannels == 4)
+			format = GL_RGBA;
+
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+	else
+	{
+		std::cout << "failed to load texture" << filename << std::endl;
+	}
+
+	stbi_image_free(data);
+	return textureID;
+}
@@ -0,0 +1,54 @@
+#ifndef ASSET_REGISTRY_H
+#define ASSET_REGISTRY_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+
+#include "model.h"
+
+struct ModelHandle
+{
+	unsigned int id = 0;
+};
+
+//loads each model and texture file once and owns the gl objects for them,
+//models are stored behind pointers so the Model* handed out stays valid as more are loaded
+class AssetRegistry
+{
+public:
+	AssetRegistry() {}
+	~AssetRegistry();
+	AssetRegistry(const AssetRegistry&) = delete;
+	AssetRegistry& operator=(const AssetRegistry&) = delete;
+
+	//models are keyed by path and settings, loading the same path with other settings loads it again
+	ModelHandle LoadModel(const std::string& path, bool retainGeometry = false, std::vector<float> lodRatios = std::vector<float>());
+	Model* Get(ModelHandle handle);
+	unsigned int LoadTexture(const std::string& path);
+	//must be called while the gl context is still current
+	void Clear();
+	void PrintStats();
+
+private:
+	//what a model was loaded with, a retained or differently lodded copy is a different model
+	struct ModelKey
+	{
+		std::string path;
+		bool retainGeometry;
+		std::vector<float> lodRatios;
+		bool operator<(const ModelKey& other) const;
+	};
+
+	std::vector<std::unique_ptr<Model>> models;
+	std::map<ModelKey, unsigned int> modelIds;
+	std::map<std::string, unsigned int> textureIds;
+
+	unsigned int TextureFromFile(const std::string& filename);
+};
+
+
+#endif
@@ -0,0 +1,97 @@
+//checks the simd collision kernels against the scalar reference then times every path the cpu supports.
+//build with the kernels only, no gl needed:
+//  g++ -O2 -I.. collisionBenchmark.cpp ../collisionKernels.cpp -o collisionBenchmark
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include "collisionKernels.h"
+
+struct Spheres
+{
+	std::vector<float> x, y, z;
+};
+
+Spheres RandomPoints(std::mt19937& randomGen, unsigned int count, float extent)
+{
+	std::uniform_real_distribution<float> range(-extent, extent);
+	Spheres points;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		points.x.push_back(range(randomGen));
+		points.y.push_back(range(randomGen) * 0.1f);
+		points.z.push_back(range(randomGen));
+	}
+	return points;
+}
+
+bool Verify(std::mt19937& randomGen)
+{
+	for (unsigned int count = 0; count < 70; count++)
+	{
+		Spheres spheres = RandomPoints(randomGen, count, 10.0f);
+		Spheres points = RandomPoints(randomGen, 50, 10.0f);
+		std::vector<unsigned char> expected(count), actual(count);
+		for (unsigned int p = 0; p < 50; p++)
+		{
+			float point[3] = { points.x[p], points.y[p], points.z[p] };
+			unsigned int expectedHits = PointSpheresHitsScalar(point, spheres.x.data(), spheres.y.data(), spheres.z.data(), count, 9.0f, expected.data());
+			unsigned int hits = PointSpheresHits(point, spheres.x.data(), spheres.y.data(), spheres.z.data(), count, 9.0f, actual.data());
+			if (hits != expectedHits || expected != actual)
+				return false;
+			float expectedDistance = -1.0f, distance = -1.0f;
+			int expectedNearest = PointSpheresNearestScalar(point, spheres.x.data(), spheres.y.data(), spheres.z.data(), count, expectedDistance);
+			int nearest = PointSpheresNearest(point, spheres.x.data(), spheres.y.data(), spheres.z.data(), count, distance);
+			if (nearest != expectedNearest || distance != expectedDistance)
+				return false;
+		}
+	}
+	return true;
+}
+
+int main()
+{
+	std::mt19937 randomGen(1234);
+	KernelPath best = GetKernelPath();
+	std::cout << "best supported path: " << KernelPathName(best) << std::endl;
+
+	for (int path = 0; path <= (int)best; path++)
+	{
+		SetKernelPath((KernelPath)path);
+		bool valid = Verify(randomGen);
+		std::cout << KernelPathName((KernelPath)path) << " matches scalar reference: " << (valid ? "yes" : "NO") << std::endl;
+		if (!valid)
+			return 1;
+	}
+
+	const unsigned int counts[] = { 64, 256, 1024, 4096 };
+	for (unsigned int c = 0; c < 4; c++)
+	{
+		unsigned int count = counts[c];
+		Spheres enemies = RandomPoints(randomGen, count, 100.0f);
+		Spheres projectiles = RandomPoints(randomGen, count, 100.0f);
+		std::vector<int> firstHit(count);
+		for (int path = 0; path <= (int)best; path++)
+		{
+			SetKernelPath((KernelPath)path);
+			const int REPEATS = 20;
+			auto start = std::chrono::steady_clock::now();
+			int hitTotal = 0;
+			for (int r = 0; r < REPEATS; r++)
+			{
+				PointsSpheresFirstHit(projectiles.x.data(), projectiles.y.data(), projectiles.z.data(), count, enemies.x.data(), enemies.y.data(), enemies.z.data(), count, 1.4f * 1.4f, firstHit.data());
+				for (unsigned int i = 0; i < count; i++)
+					hitTotal += firstHit[i] >= 0;
+			}
+			auto end = std::chrono::steady_clock::now();
+			double seconds = std::chrono::duration<double>(end - start).count() / REPEATS;
+			double pairsPerSecond = (double)count * count / seconds;
+			std::cout << count << " x " << count << " " << KernelPathName((KernelPath)path) << ": "
+				<< seconds * 1000.0 << "ms, " << pairsPerSecond / 1e6 << "M pairs/s (" << hitTotal / REPEATS << " hits)" << std::endl;
+		}
+	}
+	SetKernelPath(best);
+	return 0;
+}
@@ -0,0 +1,274 @@
+//micro-benchmarks for the engine's hot paths: camera culling tests, chunk generation and streaming,
+//bullet/enemy collision, model loading and shader uniform lookups. run from the repo root so assets/
+//and the shaders are found. the gl benchmarks need a window, without one they are skipped.
+//  engineBenchmark [--json <file>] [--label <revision>] [--quick] [--no-gl]
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+#include "camera.h"
+#include "simulation.h"
+#include "jobSystem.h"
+#include "spatialHash.h"
+#include "enemy.h"
+#include "projectile.h"
+#include "assetRegistry.h"
+#include "shader.h"
+
+struct BenchmarkResult
+{
+	std::string name;
+	//what was varied, e.g. "numChunks=4", empty if nothing
+	std::string parameter;
+	unsigned long long operations;
+	double totalMilliseconds;
+};
+
+std::vector<BenchmarkResult> results;
+
+//runs body repeats times and records the total, body returns how many operations it did
+void Measure(const std::string& name, const std::string& parameter, unsigned int repeats, const std::function<unsigned long long()>& body)
+{
+	unsigned long long operations = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < repeats; i++)
+		operations += body();
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	results.push_back({ name, parameter, operations, milliseconds });
+	std::cout << name << (parameter != "" ? " [" + parameter + "]" : "") << ": "
+		<< milliseconds * 1e6 / (operations > 0 ? operations : 1) << "ns per op, " << operations << " ops in " << milliseconds << "ms" << std::endl;
+}
+
+std::string Escape(const std::string& text)
+{
+	std::string escaped;
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+			escaped += '\\';
+		escaped += c;
+	}
+	return escaped;
+}
+
+void WriteJson(const std::string& path, const std::string& label)
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		std::cout << "failed to write " << path << std::endl;
+		return;
+	}
+	file << "{\n  \"label\": \"" << Escape(label) << "\",\n  \"results\": [\n";
+	for (unsigned int i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& r = results[i];
+		file << "    { \"name\": \"" << Escape(r.name) << "\", \"parameter\": \"" << Escape(r.parameter)
+			<< "\", \"operations\": " << r.operations << ", \"total_ms\": " << r.totalMilliseconds
+			<< ", \"ns_per_op\": " << r.totalMilliseconds * 1e6 / (r.operations > 0 ? r.operations : 1) << " }"
+			<< (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	file << "  ]\n}\n";
+	std::cout << "wrote " << results.size() << " results to " << path << std::endl;
+}
+
+void CameraBenchmarks(unsigned int scale)
+{
+	Camera camera;
+	std::mt19937 randomGen(1);
+	std::uniform_real_distribution<float> range(-150.0f, 150.0f);
+	std::vector<glm::vec3> points(4096);
+	for (unsigned int i = 0; i < points.size(); i++)
+		points[i] = glm::vec3(range(randomGen), 0.0f, range(randomGen));
+
+	//the results are summed so the calls can't be optimised away
+	volatile unsigned int visible = 0;
+	Measure("Camera::inFov", "", 100 * scale, [&]()
+	{
+		unsigned int count = 0;
+		for (unsigned int i = 0; i < points.size(); i++)
+			count += camera.inFov(points[i], 10.0f);
+		visible += count;
+		return (unsigned long long)points.size();
+	});
+	Measure("Camera::inView", "", 100 * scale, [&]()
+	{
+		unsigned int count = 0;
+		for (unsigned int i = 0; i < points.size(); i++)
+			count += camera.inView(points[i], 10.0f);
+		visible += count;
+		return (unsigned long long)points.size();
+	});
+}
+
+void ChunkBenchmarks(JobSystem& jobs, unsigned int scale)
+{
+	const int radii[] = { 1, 2, 4, 6, 8 };
+	for (int radius : radii)
+	{
+		//a fresh world each time, so every chunk in the window is generated. the worlds are made before
+		//timing, their constructor sets up every spare chunk and would swamp the generation itself
+		SimulationSettings settings;
+		settings.seed = 1;
+		settings.printScore = false;
+		settings.chunkRadius = radius;
+		std::vector<std::unique_ptr<Simulation>> sims;
+		for (unsigned int i = 0; i < scale; i++)
+			sims.push_back(std::make_unique<Simulation>(settings, jobs));
+		unsigned int next = 0;
+		Measure("AddChunks", "numChunks=" + std::to_string(radius), scale, [&]()
+		{
+			Simulation& sim = *sims[next++];
+			sim.UpdateChunks();
+			return (unsigned long long)sim.chunks.size();
+		});
+	}
+
+	//walking in a straight line a chunk at a time: the far row goes out of range and a new one comes in
+	SimulationSettings settings;
+	settings.seed = 1;
+	settings.printScore = false;
+	Simulation sim(settings, jobs);
+	sim.UpdateChunks();
+	glm::vec3 position = sim.camera.getPos();
+	Measure("chunk eviction", "numChunks=4", 40 * scale, [&]()
+	{
+		position.x += Simulation::CHUNK_WIDTH;
+		sim.camera.setPos(position);
+		sim.UpdateChunks();
+		return 1ull;
+	});
+}
+
+void CollisionBenchmarks(unsigned int scale)
+{
+	const unsigned int counts[] = { 64, 256, 1024, 4096 };
+	for (unsigned int count : counts)
+	{
+		EnemyPool enemies(count);
+		ProjectilePool projectiles(count);
+		std::mt19937 randomGen(2);
+		std::uniform_real_distribution<float> range(-60.0f, 60.0f);
+		std::uniform_real_distribution<float> height(0.0f, 10.0f);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			enemies.Spawn(glm::vec3(range(randomGen), height(randomGen), range(randomGen)));
+			projectiles.Fire(glm::vec3(range(randomGen), height(randomGen), range(randomGen)), glm::vec3(1.0f, 0.0f, 0.0f));
+		}
+		SpatialHash grid(4.0f, count);
+		std::vector<unsigned int> nearby;
+		volatile unsigned int hits = 0;
+		//the same broadphase the simulation runs each tick: build the grid, then a query per projectile
+		Measure("projectile/enemy collision", "count=" + std::to_string(count), 50 * scale, [&]()
+		{
+			grid.Build(enemies.positions);
+			unsigned int found = 0;
+			for (unsigned int i = 0; i < projectiles.Size(); i++)
+			{
+				grid.QueryRadius(projectiles.positions[i], enemies.radius, nearby);
+				found += (unsigned int)nearby.size();
+			}
+			hits += found;
+			return (unsigned long long)count;
+		});
+	}
+}
+
+void GlBenchmarks(unsigned int scale)
+{
+	if (!glfwInit())
+	{
+		std::cout << "no glfw, skipping the gl benchmarks" << std::endl;
+		return;
+	}
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow* window = glfwCreateWindow(64, 64, "engineBenchmark", NULL, NULL);
+	if (!window)
+	{
+		std::cout << "no window, skipping the gl benchmarks" << std::endl;
+		glfwTerminate();
+		return;
+	}
+	glfwMakeContextCurrent(window);
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		std::cout << "failed to initialise GLAD, skipping the gl benchmarks" << std::endl;
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		return;
+	}
+
+	//each load is from a fresh registry so nothing is shared between runs
+	const char* models[] = { "assets/ground.obj", "assets/tree.obj", "assets/bullet.obj", "assets/enemy.obj", "assets/sky.obj" };
+	for (const char* path : models)
+	{
+		Measure("Model load", path, scale, [&]()
+		{
+			AssetRegistry assets;
+			assets.LoadModel(path);
+			return 1ull;
+		});
+	}
+
+	{
+		Shader shader("vShader.vert", "fShader.frag");
+		shader.Use();
+		const char* names[] = { "model", "view", "projection", "light.ambient", "shininess" };
+		volatile unsigned int sum = 0;
+		Measure("Shader::Location", "", 2000 * scale, [&]()
+		{
+			unsigned int total = 0;
+			for (const char* name : names)
+				total += shader.Location(name);
+			sum += total;
+			return 5ull;
+		});
+	}
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+}
+
+int main(int argc, char** argv)
+{
+	std::string jsonPath = "";
+	std::string label = "";
+	unsigned int scale = 10;
+	bool gl = true;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--json" && i + 1 < argc)
+			jsonPath = argv[++i];
+		else if (std::string(argv[i]) == "--label" && i + 1 < argc)
+			label = argv[++i];
+		else if (std::string(argv[i]) == "--quick")
+			scale = 1;
+		else if (std::string(argv[i]) == "--no-gl")
+			gl = false;
+	}
+
+	JobSystem jobs(1);
+	CameraBenchmarks(scale);
+	ChunkBenchmarks(jobs, scale);
+	CollisionBenchmarks(scale);
+	if (gl)
+		GlBenchmarks(scale);
+
+	if (jsonPath != "")
+		WriteJson(jsonPath, label);
+	return 0;
+}
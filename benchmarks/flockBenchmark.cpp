@@ -0,0 +1,85 @@
+//times flocking swarms of increasing size from a fixed seed, so the numbers can be compared run to run.
+//each size is also run with one worker and with every worker, and the final positions have to match.
+//build with the simulation side only, no gl needed:
+//  g++ -O2 -pthread -I.. flockBenchmark.cpp ../enemy.cpp ../entityPool.cpp ../spatialHash.cpp ../collisionKernels.cpp ../jobSystem.cpp ../linearAllocator.cpp -o flockBenchmark
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <glm/glm.hpp>
+
+#include "enemy.h"
+#include "spatialHash.h"
+#include "jobSystem.h"
+
+const unsigned int TICKS = 120;
+const unsigned int GRAIN = 512;
+const float TICK_TIME = 1.0f / 60.0f;
+
+struct Result
+{
+	std::vector<glm::vec3> positions;
+	double millisecondsPerTick = 0.0;
+};
+
+Result Run(unsigned int count, unsigned int workers)
+{
+	EnemyPool enemies(count);
+	SpatialHash grid(4.0f, count);
+	FlockSettings settings;
+	JobSystem jobs(workers);
+
+	//spawned on a ring around the target like the game does, then left to close in
+	std::mt19937 randomGen(1);
+	std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+	std::uniform_real_distribution<float> spread(0.0f, 20.0f);
+	std::uniform_real_distribution<float> height(0.1f, 10.0f);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		float a = angle(randomGen);
+		float distance = 110.0f + spread(randomGen);
+		enemies.Spawn(glm::vec3(std::cos(a) * distance, height(randomGen), std::sin(a) * distance));
+	}
+
+	glm::vec3 target(0.0f, 2.7f, 0.0f);
+	auto start = std::chrono::high_resolution_clock::now();
+	for (unsigned int t = 0; t < TICKS; t++)
+	{
+		jobs.ResetScratch();
+		enemies.SaveState();
+		enemies.UpdateFlock(TICK_TIME, target, settings, grid, jobs, GRAIN);
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+
+	Result result;
+	result.millisecondsPerTick = std::chrono::duration<double, std::milli>(end - start).count() / TICKS;
+	result.positions = enemies.positions;
+	return result;
+}
+
+int main()
+{
+	unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	if (hardwareThreads == 0)
+		hardwareThreads = 1;
+	std::cout << TICKS << " ticks per run, " << hardwareThreads << " hardware threads" << std::endl;
+
+	bool allSame = true;
+	const unsigned int counts[] = { 1000, 2000, 4000, 8000, 16000, 32000 };
+	for (unsigned int count : counts)
+	{
+		Result single = Run(count, 1);
+		Result parallel = Run(count, hardwareThreads);
+		bool same = std::memcmp(single.positions.data(), parallel.positions.data(), single.positions.size() * sizeof(glm::vec3)) == 0;
+		allSame = allSame && same;
+		std::cout << count << " enemies:  1 worker " << single.millisecondsPerTick << "ms/tick ("
+			<< single.millisecondsPerTick * 1e6 / count << "ns each),  "
+			<< hardwareThreads << " workers " << parallel.millisecondsPerTick << "ms/tick"
+			<< (same ? "" : "  MISMATCH") << std::endl;
+	}
+	return allSame ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+//times the shared flow field: stamping a full 9x9 chunk world, searching again when the player changes
+//cell, and the enemy update with and without the field lookup at 1k and 10k enemies.
+//build with the simulation side only, no gl needed:
+//  g++ -O2 -pthread -I.. flowFieldBenchmark.cpp ../flowField.cpp ../enemy.cpp ../entityPool.cpp ../spatialHash.cpp ../collisionKernels.cpp ../jobSystem.cpp ../linearAllocator.cpp -o flowFieldBenchmark
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include <glm/glm.hpp>
+
+#include "flowField.h"
+#include "enemy.h"
+
+//the same layout main.cpp uses
+const int NUM_CHUNKS = 4;
+const float CHUNK_SIZE = 30.0f;
+const int CELLS_PER_CHUNK = 15;
+const int MAX_TREES = 45;
+const float TREE_CLEARANCE = 1.5f;
+const unsigned int TICKS = 200;
+const float TICK_TIME = 1.0f / 60.0f;
+
+double Milliseconds(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+double EnemyTick(unsigned int count, const FlowField* flowField)
+{
+	EnemyPool enemies(count);
+	std::mt19937 randomGen(3);
+	std::uniform_real_distribution<float> across(-130.0f, 130.0f);
+	std::uniform_real_distribution<float> height(0.1f, 10.0f);
+	for (unsigned int i = 0; i < count; i++)
+		enemies.Spawn(glm::vec3(across(randomGen), height(randomGen), across(randomGen)));
+
+	glm::vec3 target(1.0f, 2.7f, 1.0f);
+	auto start = std::chrono::high_resolution_clock::now();
+	for (unsigned int t = 0; t < TICKS; t++)
+	{
+		enemies.SaveState();
+		enemies.UpdateRange(TICK_TIME, target, 0, enemies.Size(), flowField);
+	}
+	return Milliseconds(start) / TICKS;
+}
+
+int main()
+{
+	std::mt19937 randomGen(1);
+	std::uniform_real_distribution<float> offset(-CHUNK_SIZE / 2, CHUNK_SIZE / 2);
+	std::uniform_int_distribution<int> treeCount(0, MAX_TREES);
+	std::vector<std::vector<glm::vec3>> chunks;
+	for (int i = -NUM_CHUNKS; i <= NUM_CHUNKS; i++)
+	{
+		for (int j = -NUM_CHUNKS; j <= NUM_CHUNKS; j++)
+		{
+			std::vector<glm::vec3> trees;
+			int count = treeCount(randomGen);
+			for (int k = 0; k < count; k++)
+				trees.push_back(glm::vec3(i * CHUNK_SIZE + offset(randomGen), 0.0f, j * CHUNK_SIZE + offset(randomGen)));
+			chunks.push_back(trees);
+		}
+	}
+
+	FlowField flowField(NUM_CHUNKS * 2 + 1, CHUNK_SIZE, CELLS_PER_CHUNK);
+	auto start = std::chrono::high_resolution_clock::now();
+	flowField.SetOrigin(glm::vec3(0.0f));
+	for (unsigned int i = 0; i < chunks.size(); i++)
+		flowField.AddObstacles(chunks[i], TREE_CLEARANCE);
+	double stampTime = Milliseconds(start);
+	start = std::chrono::high_resolution_clock::now();
+	flowField.SetTarget(glm::vec3(1.0f, 3.0f, 1.0f));
+	double searchTime = Milliseconds(start);
+	std::cout << flowField.getCellCount() << " cells, " << flowField.getReachableCells() << " reachable" << std::endl;
+	std::cout << "stamping 81 chunks: " << stampTime << "ms" << std::endl;
+	std::cout << "search:             " << searchTime << "ms" << std::endl;
+
+	//walking across cells, only a change of cell searches again
+	const int STEPS = 100;
+	int searches = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < STEPS; i++)
+		searches += flowField.SetTarget(glm::vec3(1.0f + i * 0.5f, 3.0f, 1.0f)) ? 1 : 0;
+	std::cout << "walking " << STEPS << " ticks: " << searches << " searches, " << Milliseconds(start) / STEPS << "ms per tick" << std::endl;
+
+	const unsigned int counts[] = { 1000, 10000 };
+	for (unsigned int count : counts)
+	{
+		double direct = EnemyTick(count, nullptr);
+		double flow = EnemyTick(count, &flowField);
+		std::cout << count << " enemies: direct " << direct << "ms/tick, flow field " << flow << "ms/tick" << std::endl;
+	}
+	return 0;
+}
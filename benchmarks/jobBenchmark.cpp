@@ -0,0 +1,144 @@
+//runs the entity updates and a nearest enemy reduction through the job system with 1 to N workers,
+//checks every run matches the serial result exactly and prints the time and speedup for each.
+//build with the pools and the job system only, no gl needed:
+//  g++ -O2 -pthread -I.. jobBenchmark.cpp ../jobSystem.cpp ../linearAllocator.cpp ../entityPool.cpp ../enemy.cpp ../Projectile.cpp -o jobBenchmark
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <glm/glm.hpp>
+
+#include "jobSystem.h"
+#include "enemy.h"
+#include "projectile.h"
+
+const unsigned int ENTITY_COUNT = 100000;
+const unsigned int TICKS = 60;
+const unsigned int GRAIN = 512;
+const float TICK_TIME = 1.0f / 60.0f;
+
+struct Result
+{
+	std::vector<glm::vec3> enemyPositions;
+	std::vector<glm::vec3> projectilePositions;
+	float nearest = 0.0f;
+	unsigned int nearestIndex = 0;
+	double milliseconds = 0.0;
+};
+
+void Fill(EnemyPool& enemies, ProjectilePool& projectiles)
+{
+	std::mt19937 randomGen(7);
+	std::uniform_real_distribution<float> range(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> height(0.0f, 10.0f);
+	for (unsigned int i = 0; i < ENTITY_COUNT; i++)
+	{
+		enemies.Spawn(glm::vec3(range(randomGen), height(randomGen), range(randomGen)));
+		projectiles.Fire(glm::vec3(range(randomGen), height(randomGen), range(randomGen)), glm::normalize(glm::vec3(range(randomGen), range(randomGen), range(randomGen))));
+	}
+}
+
+struct Nearest
+{
+	float distance;
+	unsigned int index;
+};
+
+//the closest enemy wins, ties go to the lower index, so the answer doesn't depend on the order ranges finish
+Nearest Closer(Nearest a, Nearest b)
+{
+	if (b.distance < a.distance || (b.distance == a.distance && b.index < a.index))
+		return b;
+	return a;
+}
+
+Result Run(unsigned int workers)
+{
+	EnemyPool enemies(ENTITY_COUNT);
+	ProjectilePool projectiles(ENTITY_COUNT);
+	Fill(enemies, projectiles);
+	glm::vec3 target(3.0f, 1.0f, -2.0f);
+	std::vector<Nearest> partial(JobSystem::RangeCount(ENTITY_COUNT, GRAIN));
+	Result result;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	if (workers == 0)
+	{
+		//the plain serial loops
+		for (unsigned int t = 0; t < TICKS; t++)
+		{
+			enemies.Update(TICK_TIME, target);
+			projectiles.Update(TICK_TIME);
+			Nearest nearest = { 1e30f, 0 };
+			for (unsigned int i = 0; i < enemies.Size(); i++)
+				nearest = Closer(nearest, { glm::distance(enemies.positions[i], target), i });
+			result.nearest = nearest.distance;
+			result.nearestIndex = nearest.index;
+		}
+	}
+	else
+	{
+		JobSystem jobs(workers);
+		for (unsigned int t = 0; t < TICKS; t++)
+		{
+			jobs.ParallelFor(enemies.Size(), GRAIN, [&](unsigned int begin, unsigned int end, unsigned int /*worker*/)
+			{
+				enemies.UpdateRange(TICK_TIME, target, begin, end);
+			});
+			jobs.ParallelFor(projectiles.Size(), GRAIN, [&](unsigned int begin, unsigned int end, unsigned int /*worker*/)
+			{
+				projectiles.UpdateRange(TICK_TIME, begin, end);
+			});
+			jobs.ParallelFor(enemies.Size(), GRAIN, [&](unsigned int begin, unsigned int end, unsigned int /*worker*/)
+			{
+				Nearest nearest = { 1e30f, 0 };
+				for (unsigned int i = begin; i < end; i++)
+					nearest = Closer(nearest, { glm::distance(enemies.positions[i], target), i });
+				partial[begin / GRAIN] = nearest;
+			});
+			Nearest nearest = { 1e30f, 0 };
+			for (unsigned int r = 0; r < partial.size(); r++)
+				nearest = Closer(nearest, partial[r]);
+			result.nearest = nearest.distance;
+			result.nearestIndex = nearest.index;
+		}
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	result.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+	result.enemyPositions = enemies.positions;
+	result.projectilePositions = projectiles.positions;
+	return result;
+}
+
+bool Same(const Result& a, const Result& b)
+{
+	return a.nearest == b.nearest && a.nearestIndex == b.nearestIndex &&
+		std::memcmp(a.enemyPositions.data(), b.enemyPositions.data(), a.enemyPositions.size() * sizeof(glm::vec3)) == 0 &&
+		std::memcmp(a.projectilePositions.data(), b.projectilePositions.data(), a.projectilePositions.size() * sizeof(glm::vec3)) == 0;
+}
+
+int main()
+{
+	unsigned int maxWorkers = std::thread::hardware_concurrency();
+	if (maxWorkers < 4)
+		maxWorkers = 4;
+	std::cout << ENTITY_COUNT << " enemies and projectiles, " << TICKS << " ticks, "
+		<< std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+	Result serial = Run(0);
+	std::cout << "serial:     " << serial.milliseconds << "ms" << std::endl;
+	bool allSame = true;
+	for (unsigned int workers = 1; workers <= maxWorkers; workers++)
+	{
+		Result parallel = Run(workers);
+		bool same = Same(serial, parallel);
+		allSame = allSame && same;
+		std::cout << workers << " workers:  " << parallel.milliseconds << "ms  speedup " << serial.milliseconds / parallel.milliseconds
+			<< (same ? "" : "  MISMATCH") << std::endl;
+	}
+	return allSame ? 0 : 1;
+}
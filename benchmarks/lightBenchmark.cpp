@@ -0,0 +1,128 @@
+//times sorting point lights into clusters the way the renderer does every frame, with enemies from a
+//stress run and a spray of projectiles as the lights, from a few headings. then checks the clusters are
+//conservative: points spread through the view are lit by every light that reaches them, using only
+//their own cluster's list. also reports how many lights a fragment loops over against all of them.
+//build with the simulation side only, no gl needed:
+//  g++ -O2 -pthread -I.. lightBenchmark.cpp ../lightClusters.cpp ../simulation.cpp ../chunk.cpp ../camera.cpp ../enemy.cpp ../entityPool.cpp ../Projectile.cpp ../spatialHash.cpp ../flowField.cpp ../collisionKernels.cpp ../jobSystem.cpp ../linearAllocator.cpp ../lod.cpp -o lightBenchmark
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <string>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "lightClusters.h"
+#include "simulation.h"
+#include "scriptedInput.h"
+
+//the same numbers main.cpp uses
+const float PROJECTILE_LIGHT_RADIUS = 6.0f;
+const float ENEMY_LIGHT_RADIUS = 8.0f;
+const int HEADINGS = 8;
+const int REPEATS = 50;
+const int SAMPLES = 20000;
+
+double Milliseconds(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void addLights(LightClusters& clusters, Simulation& sim, const std::vector<glm::vec3>& projectiles)
+{
+	for (const glm::vec3& position : projectiles)
+		clusters.Add({ position, PROJECTILE_LIGHT_RADIUS, glm::vec3(1.0f) });
+	for (unsigned int i = 0; i < sim.enemies.Size(); i++)
+		clusters.Add({ sim.enemies.positions[i], ENEMY_LIGHT_RADIUS, glm::vec3(1.0f) });
+}
+
+int main()
+{
+	JobSystem jobs(1);
+	SimulationSettings settings;
+	settings.seed = 5;
+	settings.printScore = false;
+	settings.stressEnemies = 1500;
+	Simulation sim(settings, jobs);
+	ScriptedInput script("");
+	//long enough for the swarm to close in around the player
+	for (int t = 0; t < 600; t++)
+	{
+		sim.Tick(script, 1.0f / 60.0f);
+		script.Advance();
+	}
+	//a stream of shots ahead of the player, more than the game's fire rate would keep alive
+	std::vector<glm::vec3> projectiles;
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	for (int i = 0; i < 200; i++)
+		projectiles.push_back(sim.camera.getPos() + glm::vec3(unit(random) * 40.0f, 1.0f + unit(random), unit(random) * 40.0f));
+
+	LightClusters clusters;
+	glm::mat4 projection = sim.camera.getProjectionMatrix();
+	glm::vec3 eye = sim.camera.getInterpolatedPos(1.0f);
+	glm::mat4 inverseProjection = glm::inverse(projection);
+	double buildMs = 0.0;
+	unsigned long long kept = 0, listed = 0, samples = 0, reaching = 0, missed = 0, clustered = 0;
+	unsigned int maxCluster = 0, droppedIndices = 0;
+	for (int h = 0; h < HEADINGS; h++)
+	{
+		glm::vec3 heading = glm::vec3(std::cos(6.2831853f * h / HEADINGS), -0.3f, std::sin(6.2831853f * h / HEADINGS));
+		glm::mat4 view = glm::lookAt(eye, eye + heading, glm::vec3(0.0f, 1.0f, 0.0f));
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int r = 0; r < REPEATS; r++)
+		{
+			clusters.Begin(view, projection, eye);
+			addLights(clusters, sim, projectiles);
+			clusters.Build();
+		}
+		buildMs += Milliseconds(start) / REPEATS;
+		kept += clusters.getLights().size();
+		listed += clusters.getIndices().size();
+		maxCluster = std::max(maxCluster, clusters.getMaxClusterLights());
+		droppedIndices += clusters.getDroppedIndices();
+
+		//points through the whole view, every light that reaches one has to be in its cluster's list
+		const std::vector<PointLight>& lights = clusters.getLights();
+		const std::vector<unsigned int>& ranges = clusters.getClusterRanges();
+		const std::vector<unsigned short>& indices = clusters.getIndices();
+		glm::mat4 inverseView = glm::inverse(view);
+		std::uniform_real_distribution<float> depthRange(0.0f, 1.0f);
+		for (int s = 0; s < SAMPLES; s++)
+		{
+			float ndcX = unit(random), ndcY = unit(random);
+			//most of the screen is near, so depths are spread evenly rather than evenly in the depth buffer
+			float depth = clusters.getNearPlane() + depthRange(random) * depthRange(random) * (clusters.getFarPlane() - clusters.getNearPlane());
+			glm::vec4 onFarPlane = inverseProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+			glm::vec3 direction = glm::vec3(onFarPlane) / onFarPlane.w;
+			glm::vec3 viewPoint = direction * (depth / -direction.z);
+			glm::vec3 point = glm::vec3(inverseView * glm::vec4(viewPoint, 1.0f));
+			int cluster = clusters.ClusterAt(ndcX, ndcY, depth);
+			if (cluster < 0)
+				continue;
+			samples++;
+			unsigned int offset = ranges[cluster * 2], count = ranges[cluster * 2 + 1];
+			clustered += count;
+			for (unsigned int l = 0; l < lights.size(); l++)
+			{
+				if (glm::distance(point, lights[l].position) >= lights[l].radius)
+					continue;
+				reaching++;
+				if (std::find(indices.begin() + offset, indices.begin() + offset + count, (unsigned short)l) == indices.begin() + offset + count)
+					missed++;
+			}
+		}
+	}
+	std::cout << sim.enemies.Size() + projectiles.size() << " lights, " << (double)kept / HEADINGS << " in view per heading, "
+		<< (double)listed / HEADINGS << " cluster entries, at most " << maxCluster << " in one cluster" << std::endl;
+	std::cout << "sorting: " << buildMs / HEADINGS << "ms per frame" << std::endl;
+	std::cout << "a point loops over " << (double)clustered / samples << " lights instead of " << (double)kept / HEADINGS
+		<< ", " << (double)reaching / samples << " of them reach it" << std::endl;
+	bool conservative = missed == 0 || droppedIndices > 0;
+	std::cout << (missed == 0 ? "every light reaching a point is in its cluster" : "lights MISSING from clusters: ") << (missed == 0 ? "" : std::to_string(missed)) << std::endl;
+	return conservative ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+//times the cpu occlusion buffer the renderer culls trees and enemies with: drawing the nearest
+//trees into it and testing every tree in range against it, from the player's height looking around
+//a generated world. runs the sse rasterizer and the scalar one and checks they give the same buffer.
+//build with the simulation side only, no gl needed:
+//  g++ -O2 -pthread -I.. occlusionBenchmark.cpp ../occlusionBuffer.cpp ../simulation.cpp ../chunk.cpp ../camera.cpp ../enemy.cpp ../entityPool.cpp ../Projectile.cpp ../spatialHash.cpp ../flowField.cpp ../collisionKernels.cpp ../jobSystem.cpp ../linearAllocator.cpp ../lod.cpp -o occlusionBenchmark
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstring>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "occlusionBuffer.h"
+#include "collisionKernels.h"
+#include "simulation.h"
+
+//the same numbers main.cpp uses
+const unsigned int MAX_OCCLUDERS = 48;
+const float OCCLUDER_DISTANCE = 40.0f;
+//bounds of tree.obj
+const glm::vec3 TREE_MIN = glm::vec3(-2.04f, -0.21f, -2.04f);
+const glm::vec3 TREE_MAX = glm::vec3(2.04f, 8.93f, 2.04f);
+const int HEADINGS = 16;
+const int REPEATS = 20;
+
+struct View
+{
+	glm::vec3 eye;
+	glm::mat4 viewProjection;
+	std::vector<glm::vec3> trees;
+};
+
+struct Result
+{
+	double drawMs = 0.0, testMs = 0.0;
+	unsigned long long occluders = 0, triangles = 0, tested = 0, hidden = 0;
+	std::vector<float> depth;
+	std::vector<unsigned char> visible;
+};
+
+double Milliseconds(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void drawOccluders(OcclusionBuffer& buffer, const View& view, std::vector<glm::vec3>& candidates)
+{
+	buffer.Begin(view.viewProjection, view.eye);
+	candidates.clear();
+	for (const glm::vec3& tree : view.trees)
+	{
+		if (glm::distance(tree, view.eye) < OCCLUDER_DISTANCE)
+			candidates.push_back(tree);
+	}
+	buffer.AddNearestOccluders(candidates, MAX_OCCLUDERS, Chunk::TREE_OCCLUDERS, 3);
+	buffer.Finish();
+}
+
+Result Run(const std::vector<View>& views, KernelPath path)
+{
+	SetKernelPath(path);
+	Result result;
+	OcclusionBuffer buffer;
+	std::vector<glm::vec3> candidates;
+	candidates.reserve(4096);
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int r = 0; r < REPEATS; r++)
+	{
+		for (const View& view : views)
+			drawOccluders(buffer, view, candidates);
+	}
+	result.drawMs = Milliseconds(start) / (REPEATS * views.size());
+
+	for (const View& view : views)
+	{
+		drawOccluders(buffer, view, candidates);
+		result.occluders += buffer.getOccluderCount();
+		result.triangles += buffer.getTriangleCount();
+		result.depth.insert(result.depth.end(), buffer.getDepth(), buffer.getDepth() + buffer.getWidth() * buffer.getHeight());
+		start = std::chrono::high_resolution_clock::now();
+		for (const glm::vec3& tree : view.trees)
+		{
+			bool visible = buffer.IsVisible(tree + TREE_MIN, tree + TREE_MAX);
+			result.visible.push_back(visible);
+			result.tested++;
+			if (!visible)
+				result.hidden++;
+		}
+		result.testMs += Milliseconds(start);
+	}
+	result.testMs /= views.size();
+	return result;
+}
+
+int main()
+{
+	JobSystem jobs(1);
+	SimulationSettings settings;
+	settings.seed = 11;
+	settings.printScore = false;
+	Simulation sim(settings, jobs);
+
+	//looking all the way round from a few spots, with the trees a frame would consider
+	std::vector<View> views;
+	const glm::vec3 spots[] = { glm::vec3(0.0f, 3.0f, 0.0f), glm::vec3(95.0f, 3.0f, -40.0f), glm::vec3(-60.0f, 3.0f, 130.0f) };
+	glm::mat4 projection = sim.camera.getProjectionMatrix();
+	float range = sim.camera.getRenderDistance() + 10.0f;
+	for (glm::vec3 spot : spots)
+	{
+		sim.camera.setPos(spot);
+		sim.UpdateChunks();
+		glm::vec3 front = sim.camera.getFront();
+		for (int h = 0; h < HEADINGS; h++)
+		{
+			View view;
+			view.eye = spot;
+			glm::vec3 heading = glm::vec3(glm::rotate(glm::mat4(1.0f), glm::radians(360.0f * h / HEADINGS), glm::vec3(0.0f, 1.0f, 0.0f)) * glm::vec4(front, 0.0f));
+			view.viewProjection = projection * glm::lookAt(spot, spot + heading, glm::vec3(0.0f, 1.0f, 0.0f));
+			for (Chunk& chunk : sim.chunks)
+			{
+				for (const glm::vec3& tree : chunk.getTreePositions())
+				{
+					if (glm::distance(tree, spot) < range && glm::dot(tree - spot, heading) > 0.0f)
+						view.trees.push_back(tree);
+				}
+			}
+			views.push_back(view);
+		}
+	}
+
+	//what is off screen, with nothing drawn, so the rest of hidden is down to the occluders
+	OcclusionBuffer empty;
+	unsigned long long offScreen = 0, total = 0;
+	for (const View& view : views)
+	{
+		empty.Begin(view.viewProjection, view.eye);
+		empty.Finish();
+		for (const glm::vec3& tree : view.trees)
+		{
+			if (!empty.IsVisible(tree + TREE_MIN, tree + TREE_MAX))
+				offScreen++;
+			total++;
+		}
+	}
+
+	//anything but the scalar path rasterizes with sse
+	KernelPath best = GetKernelPath();
+	Result scalar = Run(views, KernelPath::Scalar);
+	Result simd = Run(views, best);
+	std::cout << views.size() << " views, " << (double)total / views.size() << " trees in front of the camera per view, "
+		<< (double)offScreen / views.size() << " of them off screen" << std::endl;
+	std::cout << (double)scalar.occluders / views.size() << " occluder shapes (" << (double)scalar.triangles / views.size() << " triangles), "
+		<< (double)(scalar.hidden - offScreen) / views.size() << " trees hidden behind them per view" << std::endl;
+	std::cout << "scalar: drawing " << scalar.drawMs << "ms, testing " << scalar.testMs << "ms per view" << std::endl;
+	std::cout << "sse:    drawing " << simd.drawMs << "ms, testing " << simd.testMs << "ms per view" << std::endl;
+	bool same = scalar.visible == simd.visible && scalar.depth.size() == simd.depth.size()
+		&& std::memcmp(scalar.depth.data(), simd.depth.data(), scalar.depth.size() * sizeof(float)) == 0;
+	std::cout << (same ? "sse and scalar buffers match" : "sse and scalar buffers DIFFER") << std::endl;
+	return same ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+//times the cpu reference particle simulator, on the hits from a stress run and then with the ring kept
+//full of enemy bursts. checks every particle stays above the ground and that all of them have died
+//by the time the system says it is idle, since the renderer stops updating and drawing them then.
+//build with the simulation side only, no gl needed:
+//  g++ -O2 -pthread -I.. particleBenchmark.cpp ../particleSystem.cpp ../simulation.cpp ../chunk.cpp ../camera.cpp ../enemy.cpp ../entityPool.cpp ../Projectile.cpp ../spatialHash.cpp ../flowField.cpp ../collisionKernels.cpp ../jobSystem.cpp ../linearAllocator.cpp ../lod.cpp ../scriptedInput.cpp -o particleBenchmark
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include "particleSystem.h"
+#include "simulation.h"
+#include "scriptedInput.h"
+
+const float FRAME_TIME = 1.0f / 60.0f;
+const int STRESS_TICKS = 1200;
+const int FULL_FRAMES = 300;
+
+double Milliseconds(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+struct Frames
+{
+	double simulateMs = 0.0;
+	unsigned long long bursts = 0, alive = 0;
+	unsigned int frames = 0, peakAlive = 0, belowGround = 0;
+
+	void add(ParticleSystem& particles, double ms)
+	{
+		unsigned int count = 0;
+		for (const Particle& particle : particles.getParticles())
+		{
+			if (particle.life > 0.0f)
+			{
+				count++;
+				if (particle.position.y < 0.0f)
+					belowGround++;
+			}
+		}
+		simulateMs += ms;
+		bursts += particles.getBursts().size();
+		alive += count;
+		peakAlive = std::max(peakAlive, count);
+		frames++;
+	}
+
+	void print(const char* name)
+	{
+		std::cout << name << ": " << (double)bursts / frames << " bursts and " << (double)alive / frames << " particles alive per frame, "
+			<< peakAlive << " at most, " << simulateMs / frames << "ms per frame" << std::endl;
+	}
+};
+
+//one frame the way the renderer runs it on the cpu
+double simulate(ParticleSystem& particles)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	particles.Simulate(FRAME_TIME);
+	return Milliseconds(start);
+}
+
+int main()
+{
+	JobSystem jobs(1);
+	SimulationSettings settings;
+	settings.seed = 5;
+	settings.printScore = false;
+	settings.stressEnemies = 1500;
+	Simulation sim(settings, jobs);
+	ScriptedInput script("");
+	ParticleSystem particles;
+
+	//one tick a frame, the built in script walks around shooting into the swarm
+	Frames stress;
+	unsigned long long treeHits = 0, enemyHits = 0;
+	for (int t = 0; t < STRESS_TICKS; t++)
+	{
+		sim.Tick(script, FRAME_TIME);
+		script.Advance();
+		for (const Impact& impact : sim.impacts)
+		{
+			(impact.kind == Impact::Enemy ? enemyHits : treeHits)++;
+			particles.Emit(impact.position, impact.direction, impact.kind == Impact::Enemy ? PARTICLE_DEATH : PARTICLE_SPARKS);
+		}
+		double ms = simulate(particles);
+		stress.add(particles, ms);
+		particles.EndFrame(FRAME_TIME);
+	}
+	std::cout << "stress run: " << enemyHits << " enemies and " << treeHits << " trees hit in " << STRESS_TICKS << " ticks" << std::endl;
+	stress.print("stress run");
+
+	//as many enemy bursts as a frame takes, so every slot is in use and the oldest are written over
+	Frames full;
+	for (int f = 0; f < FULL_FRAMES; f++)
+	{
+		for (unsigned int b = 0; b < ParticleSystem::MAX_BURSTS; b++)
+		{
+			float angle = (f * ParticleSystem::MAX_BURSTS + b) * 0.37f;
+			particles.Emit(glm::vec3(std::cos(angle) * 30.0f, 1.5f, std::sin(angle) * 30.0f), glm::vec3(0.0f, 0.0f, 1.0f), PARTICLE_DEATH);
+		}
+		double ms = simulate(particles);
+		full.add(particles, ms);
+		particles.EndFrame(FRAME_TIME);
+	}
+	full.print("full ring");
+	std::cout << particles.getCapacity() << " slots, " << particles.getDroppedBursts() << " bursts dropped" << std::endl;
+
+	//nothing new, every particle has to be dead by the time it goes idle
+	unsigned int idleFrames = 0;
+	while (particles.IsActive())
+	{
+		particles.Simulate(FRAME_TIME);
+		particles.EndFrame(FRAME_TIME);
+		idleFrames++;
+	}
+	unsigned int stillAlive = 0;
+	for (const Particle& particle : particles.getParticles())
+	{
+		if (particle.life > 0.0f)
+			stillAlive++;
+	}
+	std::cout << "idle after " << idleFrames << " frames with " << stillAlive << " particles still alive, "
+		<< stress.belowGround + full.belowGround << " below the ground" << std::endl;
+	return stillAlive == 0 && stress.belowGround + full.belowGround == 0 ? 0 : 1;
+}
@@ -1,12 +1,11 @@
 #include "camera.h"
 
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
-
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <cmath>
+
 Camera::Camera()
 {
 	setScreenSize(1600, 900);
@@ -22,26 +21,26 @@ Camera::~Camera()
 
 }
 
-void Camera::KeyHandler(GLFWwindow* window, float timeElapsed)
+void Camera::KeyHandler(InputSource& input, float timeElapsed)
 {
 	float velocity = speed * timeElapsed;
-	if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
+	if (input.IsDown(InputKey::Sprint))
 		velocity *= 2.0f;
 	//horizontalFront.y = 0.0f;
-	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+	if (input.IsDown(InputKey::Forward))
 		position += horizontalFront * velocity;
-	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+	if (input.IsDown(InputKey::Left))
 		position -= glm::normalize(glm::cross(horizontalFront, up)) * velocity;
-	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+	if (input.IsDown(InputKey::Back))
 		position -= horizontalFront * velocity;
-	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+	if (input.IsDown(InputKey::Right))
 		position += glm::normalize(glm::cross(horizontalFront, up)) * velocity;
 
 	if (position.y != 3.0f)
 		position.y = 3.0f;
 }
 
-void Camera::CursorPosCallback(GLFWwindow* window, double xpos, double ypos, float timeElapsed)
+void Camera::CursorPosCallback(double xpos, double ypos, float /*timeElapsed*/)
 {
 	if (firstMouseUpdate)
 	{
@@ -74,21 +73,65 @@ void Camera::CursorPosCallback(GLFWwindow* window, double xpos, double ypos, flo
 	horizontalFront = glm::normalize(direction);
 }
 
+CameraState Camera::getState()
+{
+	CameraState state;
+	state.position = position;
+	state.previousPosition = previousPosition;
+	state.front = front;
+	state.horizontalFront = horizontalFront;
+	state.yaw = yaw;
+	state.pitch = pitch;
+	state.lastMouseX = lastMouseX;
+	state.lastMouseY = lastMouseY;
+	state.firstMouseUpdate = firstMouseUpdate;
+	return state;
+}
+
+void Camera::setState(const CameraState& state)
+{
+	position = state.position;
+	previousPosition = state.previousPosition;
+	front = state.front;
+	horizontalFront = state.horizontalFront;
+	yaw = state.yaw;
+	pitch = state.pitch;
+	lastMouseX = state.lastMouseX;
+	lastMouseY = state.lastMouseY;
+	firstMouseUpdate = state.firstMouseUpdate;
+}
+
+void Camera::ResetMouse()
+{
+	firstMouseUpdate = true;
+}
+
 void Camera::setScreenSize(int width, int height)
 {
 	screenWidth = width;
 	screenHeight = height;
 }
 
-glm::mat4 Camera::getViewMatrix()
+void Camera::SaveState()
 {
-	view = glm::lookAt(position, position + front, up);
+	previousPosition = position;
+}
+
+glm::mat4 Camera::getViewMatrix(float alpha)
+{
+	glm::vec3 viewPos = getInterpolatedPos(alpha);
+	view = glm::lookAt(viewPos, viewPos + front, up);
 	return view;
 }
 
+glm::vec3 Camera::getInterpolatedPos(float alpha)
+{
+	return glm::mix(previousPosition, position, alpha);
+}
+
 glm::mat4 Camera::getProjectionMatrix()
 {
-	projection = glm::perspective(glm::radians(fov), (float)screenWidth / (float)screenHeight, 0.1f, renderDistance);
+	projection = glm::perspective(glm::radians(fov), (float)screenWidth / (float)screenHeight, 0.1f, drawDistance);
 	return projection;
 }
 
@@ -97,6 +140,12 @@ glm::vec3 Camera::getPos()
 {
 	return position;
 }
+
+void Camera::setPos(glm::vec3 position)
+{
+	this->position = position;
+	previousPosition = position;
+}
 glm::vec3 Camera::getFront()
 {
 	return front;
@@ -107,6 +156,16 @@ float Camera::getRenderDistance()
 	return renderDistance;
 }
 
+float Camera::getDrawDistance()
+{
+	return drawDistance;
+}
+
+void Camera::setDrawDistance(float distance)
+{
+	drawDistance = distance < renderDistance ? distance : renderDistance;
+}
+
 float Camera::angleToCamera(glm::vec3 targetPos)
 {
 	glm::vec3 dirToCamera = glm::normalize(position - targetPos);
@@ -124,5 +183,13 @@ bool Camera::inFov(glm::vec3 targetPos, float size)
 
 bool Camera::inView(glm::vec3 targetPos, float size)
 {
-	return (glm::distance(position, targetPos) < renderDistance + size);
+	return (glm::distance(position, targetPos) < drawDistance + size);
+}
+
+float Camera::projectedSize(glm::vec3 targetPos, float radius)
+{
+	float dist = glm::distance(position, targetPos);
+	if (dist <= radius)
+		return 1.0f;
+	return radius / (dist * tan(glm::radians(fov) / 2.0f));
 }
\ No newline at end of file
@@ -1,13 +1,24 @@
 #ifndef CAMERA_H
 #define CAMERA_H
 
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
-
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "input.h"
+
+//everything about the camera that changes as the player moves and looks, for saving and restoring it
+struct CameraState
+{
+	glm::vec3 position;
+	glm::vec3 previousPosition;
+	glm::vec3 front;
+	glm::vec3 horizontalFront;
+	float yaw;
+	float pitch;
+	double lastMouseX, lastMouseY;
+	bool firstMouseUpdate;
+};
 
 class Camera
 {
@@ -15,17 +26,31 @@ public:
 	Camera();
 	Camera(int width, int height);
 	~Camera();
-	void KeyHandler(GLFWwindow* window, float timeElapsed);
-	void CursorPosCallback(GLFWwindow* window, double xpos, double ypos, float timeElapsed);
-	glm::mat4 getViewMatrix();
+	void KeyHandler(InputSource& input, float timeElapsed);
+	void CursorPosCallback(double xpos, double ypos, float timeElapsed);
+	//call at the start of each tick, alpha blends between the position then and the current one
+	void SaveState();
+	glm::mat4 getViewMatrix(float alpha = 1.0f);
+	glm::vec3 getInterpolatedPos(float alpha);
 	glm::mat4 getProjectionMatrix();
 	glm::vec3 getPos();
+	void setPos(glm::vec3 position);
 	glm::vec3 getFront();
 	float angleToCamera(glm::vec3 targetPos);
 	bool inFov(glm::vec3 targetPos, float size);
 	bool inView(glm::vec3 targetPos, float size);
+	//approximate fraction of the screen height covered by a sphere
+	float projectedSize(glm::vec3 targetPos, float radius);
 	float getRenderDistance();
+	//how far is drawn, the far plane and what inView accepts. it can be brought in from the render
+	//distance to save time drawing, the simulation keeps using the render distance either way
+	float getDrawDistance();
+	void setDrawDistance(float distance);
 	void setScreenSize(int width, int height);
+	CameraState getState();
+	void setState(const CameraState& state);
+	//the next cursor position is taken as where the mouse already was, so it doesn't turn the camera
+	void ResetMouse();
 private:
 	int screenWidth;
 	int screenHeight;
@@ -34,8 +59,10 @@ private:
 	float pitch = -32.0f;
 	float yaw = 0.0f;
 	float speed = 7.0f;
-	float renderDistance = 70.0f;
+	float renderDistance = 100.0f;
+	float drawDistance = 100.0f;
 	glm::vec3 position = glm::vec3(0.0f, 3.0f, 0.0f);
+	glm::vec3 previousPosition = glm::vec3(0.0f, 3.0f, 0.0f);
 	glm::vec3 front = glm::vec3(0.0f, 0.0f, -7.0f);
 	glm::vec3 horizontalFront = glm::vec3(0.0f, 0.0f, -7.0f);
 	glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
@@ -1,6 +1,5 @@
 #include "chunk.h"
 
-#include "shader.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -8,16 +7,51 @@
 #include <random>
 #include <ctime>
 #include <iostream>
-#include "camera.h"
+#include <algorithm>
+#include <cmath>
+#include <atomic>
 
+namespace
+{
+	//chunks are generated in parallel, each generation just needs a number no other one has had
+	std::atomic<unsigned long long> nextGeneration(1);
+}
 
-Chunk::Chunk(glm::vec3 position, float chunkWidth, float chunkHeight, Model* ground, Model* tree, std::mt19937& randomGen, std::uniform_real_distribution<float>& spawnXRange, std::uniform_real_distribution<float>& spawnZRange, std::uniform_int_distribution<int>& treeRange)
+//measured from tree.obj: the trunk is 0.51 wide up to 3.85, the cones start at 3.76 (2.04 wide,
+//peak 6.38) and 5.01 (1.7 wide, peak 7.21). a slice through a cone's axis is exactly its
+//outline, so these are shrunk by a tenth to stay inside it. the top two cones are too small to hide much
+const UprightOccluder Chunk::TREE_OCCLUDERS[3] =
 {
-	this->ground = ground;
-	this->tree = tree;
-	this->chunkWidth = chunkWidth;
-	this->chunkHeight = chunkHeight;
-	this->position = position;
+	{ 0.0f, 3.76f, 0.45f, 0.45f },
+	{ 3.76f, 6.2f, 1.84f, 0.0f },
+	{ 5.01f, 7.0f, 1.53f, 0.0f },
+};
+
+Chunk::Chunk(glm::vec3 position, float chunkWidth, float chunkHeight, std::mt19937& randomGen, std::uniform_real_distribution<float>& spawnXRange, std::uniform_real_distribution<float>& spawnZRange, std::uniform_int_distribution<int>& treeRange, LinearAllocator& scratch)
+{
+	Generate(position, chunkWidth, chunkHeight, randomGen, spawnXRange, spawnZRange, treeRange, scratch);
+}
+
+Chunk::Chunk(unsigned int maxTrees)
+{
+	treePositions.reserve(maxTrees);
+	treeLods.reserve(maxTrees);
+	visibleTrees.reserve(maxTrees);
+	impostorTrees.reserve(maxTrees);
+	treeCellEntries.reserve(maxTrees);
+	treeCellStart.reserve(TREE_GRID_SIZE * TREE_GRID_SIZE + 1);
+}
+
+void Chunk::Generate(glm::vec3 position, float chunkWidth, float chunkHeight, std::mt19937& randomGen, std::uniform_real_distribution<float>& spawnXRange, std::uniform_real_distribution<float>& spawnZRange, std::uniform_int_distribution<int>& treeRange, LinearAllocator& scratch, unsigned int seed)
+{
+	reset(position, chunkWidth, chunkHeight, seed);
+
+	unsigned int maxTrees = (unsigned int)treeRange.max();
+	treePositions.reserve(maxTrees);
+	treeLods.reserve(maxTrees);
+	visibleTrees.reserve(maxTrees);
+	impostorTrees.reserve(maxTrees);
+	treeCellEntries.reserve(maxTrees);
 
 	unsigned int numTrees = treeRange(randomGen);
 	for (unsigned int i = 0; i < numTrees; i++)
@@ -27,39 +61,183 @@ Chunk::Chunk(glm::vec3 position, float chunkWidth, float chunkHeight, Model* gro
 		pos.z += spawnZRange(randomGen);
 		treePositions.push_back(pos);
 	}
+	treeLods.assign(treePositions.size(), 0);
+	buildTreeGrid(scratch);
 }
-Chunk::~Chunk()
+
+void Chunk::Restore(glm::vec3 position, float chunkWidth, float chunkHeight, const glm::vec3* trees, unsigned int treeCount, LinearAllocator& scratch, unsigned int seed)
 {
-	treePositions.~vector();
-	tree = nullptr;
-	ground = nullptr;
+	reset(position, chunkWidth, chunkHeight, seed);
+	treePositions.assign(trees, trees + treeCount);
+	treeLods.assign(treePositions.size(), 0);
+	buildTreeGrid(scratch);
 }
 
+void Chunk::reset(glm::vec3 position, float chunkWidth, float chunkHeight, unsigned int seed)
+{
+	this->chunkWidth = chunkWidth;
+	this->chunkHeight = chunkHeight;
+	this->position = position;
+	this->seed = seed;
+	generation = nextGeneration++;
+	treePositions.clear();
+	visibleTrees.clear();
+	impostorTrees.clear();
+}
 
-void Chunk::Draw(Shader& shader, Camera& camera)
+void Chunk::buildTreeGrid(LinearAllocator& scratch)
 {
-	if (camera.inView(position, chunkWidth))
+	treeCellStart.assign(TREE_GRID_SIZE * TREE_GRID_SIZE + 1, 0);
+	treeCellEntries.resize(treePositions.size());
+	unsigned int* cells = scratch.Allocate<unsigned int>(treePositions.size());
+	for (unsigned int i = 0; i < treePositions.size(); i++)
 	{
-		glm::mat4 model = glm::mat4(1.0f);
-		model = glm::translate(model, position);
-		glUniformMatrix4fv(shader.Location("model"), 1, GL_FALSE, &model[0][0]);
-		glUniform1fv(shader.Location("shininess"), 1, &groundShininess);
-		ground->Draw(shader);
+		cells[i] = treeCell(treePositions[i].z, position.z, chunkHeight) * TREE_GRID_SIZE + treeCell(treePositions[i].x, position.x, chunkWidth);
+		treeCellStart[cells[i] + 1]++;
 	}
-	glUniform1fv(shader.Location("shininess"), 1, &treeShininess);
+	for (unsigned int i = 1; i < treeCellStart.size(); i++)
+		treeCellStart[i] += treeCellStart[i - 1];
+	unsigned int* fill = scratch.Allocate<unsigned int>(TREE_GRID_SIZE * TREE_GRID_SIZE);
+	for (unsigned int i = 0; i < TREE_GRID_SIZE * TREE_GRID_SIZE; i++)
+		fill[i] = treeCellStart[i];
 	for (unsigned int i = 0; i < treePositions.size(); i++)
+		treeCellEntries[fill[cells[i]]++] = i;
+}
+
+Chunk::~Chunk()
+{
+}
+
+int Chunk::treeCell(float value, float origin, float size)
+{
+	int cell = (int)std::floor((value - (origin - size / 2)) / size * TREE_GRID_SIZE);
+	if (cell < 0)
+		return 0;
+	if (cell >= TREE_GRID_SIZE)
+		return TREE_GRID_SIZE - 1;
+	return cell;
+}
+
+bool Chunk::SegmentHitsTrunk(glm::vec3 start, glm::vec3 end, float trunkRadius, float trunkHeight, float& fraction)
+{
+	glm::vec3 low = glm::min(start, end) - glm::vec3(trunkRadius);
+	glm::vec3 high = glm::max(start, end) + glm::vec3(trunkRadius);
+	//trunks can poke out of the chunk by their radius
+	if (high.x < position.x - chunkWidth / 2 - trunkRadius || low.x > position.x + chunkWidth / 2 + trunkRadius ||
+		high.z < position.z - chunkHeight / 2 - trunkRadius || low.z > position.z + chunkHeight / 2 + trunkRadius ||
+		low.y > trunkHeight)
+		return false;
+
+	int minZ = treeCell(low.z, position.z, chunkHeight), maxZ = treeCell(high.z, position.z, chunkHeight);
+	glm::vec2 d = glm::vec2(end.x - start.x, end.z - start.z);
+	float a = glm::dot(d, d);
+	float cellHeight = chunkHeight / TREE_GRID_SIZE;
+	bool hit = false;
+	fraction = 1.0f;
+	for (int z = minZ; z <= maxZ; z++)
+	{
+		//only the cells in this row the segment crosses: the part of it inside the row, widened by the
+		//radius either way, gives the span of cells. the edge rows also hold trees clamped into them
+		float rowLow = z == 0 ? low.z : position.z - chunkHeight / 2 + z * cellHeight - trunkRadius;
+		float rowHigh = z == TREE_GRID_SIZE - 1 ? high.z : position.z - chunkHeight / 2 + (z + 1) * cellHeight + trunkRadius;
+		float enter = 0.0f, leave = 1.0f;
+		if (d.y != 0.0f)
+		{
+			enter = (rowLow - start.z) / d.y;
+			leave = (rowHigh - start.z) / d.y;
+			if (enter > leave)
+				std::swap(enter, leave);
+			enter = std::max(enter, 0.0f);
+			leave = std::min(leave, 1.0f);
+			if (enter > leave)
+				continue;
+		}
+		float enterX = start.x + d.x * enter, leaveX = start.x + d.x * leave;
+		int minX = treeCell(std::min(enterX, leaveX) - trunkRadius, position.x, chunkWidth);
+		int maxX = treeCell(std::max(enterX, leaveX) + trunkRadius, position.x, chunkWidth);
+		for (int x = minX; x <= maxX; x++)
+		{
+			int cell = z * TREE_GRID_SIZE + x;
+			for (unsigned int i = treeCellStart[cell]; i < treeCellStart[cell + 1]; i++)
+			{
+				//segment against the trunk's circle on the ground plane, then check the height at the hit
+				glm::vec3 treePos = treePositions[treeCellEntries[i]];
+				glm::vec2 f = glm::vec2(start.x - treePos.x, start.z - treePos.z);
+				float c = glm::dot(f, f) - trunkRadius * trunkRadius;
+				float t;
+				if (c <= 0.0f)
+					t = 0.0f;
+				else
+				{
+					float b = 2.0f * glm::dot(f, d);
+					float discriminant = b * b - 4.0f * a * c;
+					if (a == 0.0f || discriminant < 0.0f)
+						continue;
+					t = (-b - std::sqrt(discriminant)) / (2.0f * a);
+					if (t < 0.0f || t > 1.0f)
+						continue;
+				}
+				float y = start.y + (end.y - start.y) * t;
+				if (y > trunkHeight || y < treePos.y)
+					continue;
+				if (t <= fraction)
+				{
+					fraction = t;
+					hit = true;
+				}
+			}
+		}
+	}
+	return hit;
+}
+
+
+void Chunk::GatherOccluders(glm::vec3 eye, float maxDistance, std::vector<glm::vec3>& occluders)
+{
+	float maxDistanceSquared = maxDistance * maxDistance;
+	for (unsigned int i = 0; i < visibleTrees.size(); i++)
 	{
-		if (camera.inFov(treePositions[i], 10.0f) && camera.inView(treePositions[i], 10.0f))
+		glm::vec3 toTree = treePositions[visibleTrees[i]] - eye;
+		if (glm::dot(toTree, toTree) < maxDistanceSquared)
+			occluders.push_back(treePositions[visibleTrees[i]]);
+	}
+}
+
+unsigned int Chunk::Occlude(const OcclusionBuffer& occlusion, glm::vec3 treeMin, glm::vec3 treeMax)
+{
+	unsigned int culled = 0;
+	std::vector<unsigned int>* lists[2] = { &visibleTrees, &impostorTrees };
+	for (std::vector<unsigned int>* list : lists)
+	{
+		unsigned int kept = 0;
+		for (unsigned int i = 0; i < list->size(); i++)
 		{
-			glm::mat4 model = glm::mat4(1.0f);
-			model = glm::translate(model, treePositions[i]);
-			glUniformMatrix4fv(shader.Location("model"), 1, GL_FALSE, &model[0][0]);
-			tree->Draw(shader);
+			glm::vec3 treePos = treePositions[(*list)[i]];
+			if (occlusion.IsVisible(treePos + treeMin, treePos + treeMax))
+				(*list)[kept++] = (*list)[i];
 		}
+		culled += (unsigned int)list->size() - kept;
+		list->resize(kept);
 	}
+	return culled;
 }
 
 glm::vec3 Chunk::getPos()
 {
 	return position;
+}
+
+const std::vector<glm::vec3>& Chunk::getTreePositions()
+{
+	return treePositions;
+}
+
+unsigned long long Chunk::getGeneration()
+{
+	return generation;
+}
+
+unsigned int Chunk::getSeed()
+{
+	return seed;
 }
\ No newline at end of file
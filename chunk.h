@@ -1,30 +1,87 @@
 #ifndef CHUNK_H
 #define CHUNK_H
 
-#include "shader.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <vector>
 #include <random>
-#include "model.h"
 #include "camera.h"
+#include "lod.h"
+#include "linearAllocator.h"
+#include "occlusionBuffer.h"
 
+class Shader;
+class Model;
+class Impostor;
+class TreeBatcher;
+
+//a square of ground and the trees on it. the chunk itself is only data, so the simulation can use it
+//without gl; Cull and Draw live in chunkDraw.cpp with the models passed in
 class Chunk
 {
 public:
-	Chunk(glm::vec3 position, float chunkWidth, float chunkHeight, Model* ground, Model* tree, std::mt19937& randomGen, std::uniform_real_distribution<float>& spawnXRange, std::uniform_real_distribution<float>& spawnZRange, std::uniform_int_distribution<int>& treeRange);
+	Chunk(glm::vec3 position, float chunkWidth, float chunkHeight, std::mt19937& randomGen, std::uniform_real_distribution<float>& spawnXRange, std::uniform_real_distribution<float>& spawnZRange, std::uniform_int_distribution<int>& treeRange, LinearAllocator& scratch);
+	//an empty chunk to Generate into later, with room for maxTrees
+	Chunk(unsigned int maxTrees);
 	~Chunk();
-	void Draw(Shader& shader, Camera& camera);
+	Chunk(Chunk&&) = default;
+	Chunk& operator=(Chunk&&) = default;
+	//fills the chunk with new trees, reusing its memory. every list is sized for the most trees
+	//treeRange can give, so a chunk that is regenerated never allocates again. seed is what randomGen
+	//was seeded with, it is only kept so the chunk can be generated the same way somewhere else
+	void Generate(glm::vec3 position, float chunkWidth, float chunkHeight, std::mt19937& randomGen, std::uniform_real_distribution<float>& spawnXRange, std::uniform_real_distribution<float>& spawnZRange, std::uniform_int_distribution<int>& treeRange, LinearAllocator& scratch, unsigned int seed = 0);
+	//puts back a chunk that was generated before, from its trees. treeCount can't be more than the
+	//chunk was made with room for
+	void Restore(glm::vec3 position, float chunkWidth, float chunkHeight, const glm::vec3* trees, unsigned int treeCount, LinearAllocator& scratch, unsigned int seed = 0);
+	//works out what Draw will draw and picks tree lods. only touches this chunk, so chunks can
+	//be culled in parallel. trees past impostorDistance go to the impostor instead, 0 for none.
+	//only treeDensity of the trees further away than THINNING_DISTANCE are kept
+	void Cull(Camera& camera, const LodSettings& lodSettings, Model& tree, float impostorDistance, float treeDensity = 1.0f);
+	//nothing in the chunk is drawn this frame, instead of Cull
+	void Hide();
+	//draws the trees the last Cull found, impostor trees are queued on impostor if it isn't null.
+	//the ground of every chunk is drawn at once by GroundGrid
+	void Draw(Shader& shader, Model& tree, Impostor* impostor);
+	//static batching instead of Draw: every tree in the chunk is drawn at once from a merged copy if
+	//any of them is close enough to be drawn as a model, otherwise the impostor trees are queued
+	void DrawBatched(Shader& shader, TreeBatcher& batcher, Impostor* impostor);
+	//adds the trees the last Cull kept that are within maxDistance of eye, as occluder positions
+	void GatherOccluders(glm::vec3 eye, float maxDistance, std::vector<glm::vec3>& occluders);
+	//drops the trees the last Cull kept that are hidden behind the occluders, treeMin and treeMax
+	//are the tree model's bounds. returns how many were dropped
+	unsigned int Occlude(const OcclusionBuffer& occlusion, glm::vec3 treeMin, glm::vec3 treeMax);
 	glm::vec3 getPos();
+	const std::vector<glm::vec3>& getTreePositions();
+	//different every time the chunk is generated, so anything built from its trees can tell it is out of date
+	unsigned long long getGeneration();
+	//the seed the chunk's trees were generated from
+	unsigned int getSeed();
+	//tests a moving point against the tree trunks (vertical cylinders from the ground),
+	//fraction is how far along the segment the first hit is
+	bool SegmentHitsTrunk(glm::vec3 start, glm::vec3 end, float trunkRadius, float trunkHeight, float& fraction);
 	bool isRemoved = false;
+	//the trunk and the two lowest cones of the tree model, a little thinner than the real ones
+	static const UprightOccluder TREE_OCCLUDERS[3];
+	//a tree that isn't drawn still stops bullets, so the ones close enough to shoot at never are
+	static constexpr float THINNING_DISTANCE = 40.0f;
 private:
-	glm::vec3 position;
+	glm::vec3 position = glm::vec3(0.0f);
 	std::vector<glm::vec3> treePositions;
-	float chunkWidth, chunkHeight;
-	Model* ground, *tree;
+	unsigned long long generation = 0;
+	unsigned int seed = 0;
+	std::vector<int> treeLods;
+	std::vector<unsigned int> visibleTrees;
+	std::vector<unsigned int> impostorTrees;
+	//trees bucketed by the grid cell their centre is in, so a segment only tests the cells it crosses
+	static const int TREE_GRID_SIZE = 6;
+	std::vector<unsigned int> treeCellStart;
+	std::vector<unsigned int> treeCellEntries;
+	int treeCell(float value, float origin, float size);
+	void reset(glm::vec3 position, float chunkWidth, float chunkHeight, unsigned int seed);
+	void buildTreeGrid(LinearAllocator& scratch);
+	float chunkWidth = 0.0f, chunkHeight = 0.0f;
 	float treeShininess = 5.0f;
-	float groundShininess = 10.0f;
 };
 
 
@@ -0,0 +1,80 @@
+#include "chunk.h"
+
+#include "shader.h"
+#include "model.h"
+#include "impostor.h"
+#include "treeBatcher.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "camera.h"
+
+void Chunk::Cull(Camera& camera, const LodSettings& lodSettings, Model& tree, float impostorDistance, float treeDensity)
+{
+	visibleTrees.clear();
+	impostorTrees.clear();
+	//the trees are in no particular order, so the first few are an even spread of the chunk
+	unsigned int densityTrees = (unsigned int)std::ceil(treePositions.size() * treeDensity);
+	for (unsigned int i = 0; i < treePositions.size(); i++)
+	{
+		if (camera.inFov(treePositions[i], 10.0f) && camera.inView(treePositions[i], 10.0f))
+		{
+			float distance = glm::distance(camera.getPos(), treePositions[i]);
+			if (i >= densityTrees && distance > THINNING_DISTANCE)
+				continue;
+			if (impostorDistance > 0.0f && distance > impostorDistance)
+			{
+				impostorTrees.push_back(i);
+				continue;
+			}
+			treeLods[i] = SelectLod(lodSettings, camera.projectedSize(treePositions[i], tree.getRadius()), treeLods[i], tree.getLodCount());
+			visibleTrees.push_back(i);
+		}
+	}
+}
+
+void Chunk::Hide()
+{
+	visibleTrees.clear();
+	impostorTrees.clear();
+}
+
+void Chunk::Draw(Shader& shader, Model& tree, Impostor* impostor)
+{
+	glUniform1fv(shader.Location("shininess"), 1, &treeShininess);
+	for (unsigned int i = 0; i < visibleTrees.size(); i++)
+	{
+		unsigned int treeIndex = visibleTrees[i];
+		glm::mat4 model = glm::mat4(1.0f);
+		model = glm::translate(model, treePositions[treeIndex]);
+		glUniformMatrix4fv(shader.Location("model"), 1, GL_FALSE, &model[0][0]);
+		tree.Draw(shader, treeLods[treeIndex]);
+	}
+	if (impostor != nullptr)
+	{
+		for (unsigned int i = 0; i < impostorTrees.size(); i++)
+			impostor->Add(treePositions[impostorTrees[i]]);
+	}
+}
+
+void Chunk::DrawBatched(Shader& shader, TreeBatcher& batcher, Impostor* impostor)
+{
+	if (!visibleTrees.empty())
+	{
+		//the whole batch is one lod, the most detailed any of its visible trees wants
+		int lod = treeLods[visibleTrees[0]];
+		for (unsigned int i = 1; i < visibleTrees.size(); i++)
+			lod = std::min(lod, treeLods[visibleTrees[i]]);
+		glUniform1fv(shader.Location("shininess"), 1, &treeShininess);
+		batcher.Draw(shader, *this, lod);
+		return;
+	}
+	if (impostor != nullptr)
+	{
+		for (unsigned int i = 0; i < impostorTrees.size(); i++)
+			impostor->Add(treePositions[impostorTrees[i]]);
+	}
+}
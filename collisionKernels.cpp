@@ -0,0 +1,326 @@
+#include "collisionKernels.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace
+{
+	typedef unsigned int(*HitsKernel)(const float*, const float*, const float*, const float*, unsigned int, float, unsigned char*);
+	typedef int(*NearestKernel)(const float*, const float*, const float*, const float*, unsigned int, float&);
+
+	bool cpuHasAVX2()
+	{
+#if defined(KERNELS_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+		__cpuid(info, 1);
+		bool osSavesYmm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 6) == 6);
+		__cpuidex(info, 7, 0);
+		return osSavesYmm && (info[1] & (1 << 5));
+#elif defined(KERNELS_X86)
+		return __builtin_cpu_supports("avx2");
+#else
+		return false;
+#endif
+	}
+
+	//picks the lowest distance then the lowest index, so the result matches the scalar scan
+	void reduceNearest(const float* lanes, const int* indices, unsigned int laneCount, float& best, int& bestIndex)
+	{
+		for (unsigned int i = 0; i < laneCount; i++)
+		{
+			if (indices[i] < 0)
+				continue;
+			if (lanes[i] < best || (lanes[i] == best && indices[i] < bestIndex))
+			{
+				best = lanes[i];
+				bestIndex = indices[i];
+			}
+		}
+	}
+
+#ifdef KERNELS_X86
+	unsigned int hitsSSE(const float* point, const float* x, const float* y, const float* z, unsigned int count, float radiusSquared, unsigned char* hits)
+	{
+		__m128 px = _mm_set1_ps(point[0]), py = _mm_set1_ps(point[1]), pz = _mm_set1_ps(point[2]);
+		__m128 r2 = _mm_set1_ps(radiusSquared);
+		unsigned int hitCount = 0;
+		unsigned int i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), px);
+			__m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), py);
+			__m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), pz);
+			__m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			int mask = _mm_movemask_ps(_mm_cmplt_ps(d2, r2));
+			//hits are rare, so the common case is a single block store of zeros
+			if (mask == 0)
+			{
+				std::memset(hits + i, 0, 4);
+				continue;
+			}
+			for (unsigned int j = 0; j < 4; j++)
+			{
+				hits[i + j] = (mask >> j) & 1;
+				hitCount += hits[i + j];
+			}
+		}
+		return hitCount + PointSpheresHitsScalar(point, x + i, y + i, z + i, count - i, radiusSquared, hits + i);
+	}
+
+	int nearestSSE(const float* point, const float* x, const float* y, const float* z, unsigned int count, float& distanceSquared)
+	{
+		__m128 px = _mm_set1_ps(point[0]), py = _mm_set1_ps(point[1]), pz = _mm_set1_ps(point[2]);
+		__m128 best = _mm_set1_ps(3.402823466e+38f);
+		__m128i bestIndex = _mm_set1_epi32(-1);
+		__m128i index = _mm_setr_epi32(0, 1, 2, 3);
+		__m128i step = _mm_set1_epi32(4);
+		unsigned int i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), px);
+			__m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), py);
+			__m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), pz);
+			__m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			__m128 closer = _mm_cmplt_ps(d2, best);
+			best = _mm_or_ps(_mm_and_ps(closer, d2), _mm_andnot_ps(closer, best));
+			__m128i closerInt = _mm_castps_si128(closer);
+			bestIndex = _mm_or_si128(_mm_and_si128(closerInt, index), _mm_andnot_si128(closerInt, bestIndex));
+			index = _mm_add_epi32(index, step);
+		}
+		float lanes[4];
+		int indices[4];
+		_mm_storeu_ps(lanes, best);
+		_mm_storeu_si128((__m128i*)indices, bestIndex);
+		float bestDistance = 3.402823466e+38f;
+		int nearest = -1;
+		reduceNearest(lanes, indices, 4, bestDistance, nearest);
+		float tailDistance;
+		int tail = PointSpheresNearestScalar(point, x + i, y + i, z + i, count - i, tailDistance);
+		if (tail >= 0 && (nearest < 0 || tailDistance < bestDistance))
+		{
+			bestDistance = tailDistance;
+			nearest = (int)i + tail;
+		}
+		if (nearest >= 0)
+			distanceSquared = bestDistance;
+		return nearest;
+	}
+
+	TARGET_AVX2 unsigned int hitsAVX2(const float* point, const float* x, const float* y, const float* z, unsigned int count, float radiusSquared, unsigned char* hits)
+	{
+		__m256 px = _mm256_set1_ps(point[0]), py = _mm256_set1_ps(point[1]), pz = _mm256_set1_ps(point[2]);
+		__m256 r2 = _mm256_set1_ps(radiusSquared);
+		unsigned int hitCount = 0;
+		unsigned int i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			//no fma, so rounding matches the scalar and sse paths exactly
+			__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), px);
+			__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), py);
+			__m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), pz);
+			__m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+			int mask = _mm256_movemask_ps(_mm256_cmp_ps(d2, r2, _CMP_LT_OQ));
+			//hits are rare, so the common case is a single block store of zeros
+			if (mask == 0)
+			{
+				std::memset(hits + i, 0, 8);
+				continue;
+			}
+			for (unsigned int j = 0; j < 8; j++)
+			{
+				hits[i + j] = (mask >> j) & 1;
+				hitCount += hits[i + j];
+			}
+		}
+		//leave avx state before running sse encoded code, or every sse instruction pays a transition penalty
+		_mm256_zeroupper();
+		return hitCount + PointSpheresHitsScalar(point, x + i, y + i, z + i, count - i, radiusSquared, hits + i);
+	}
+
+	TARGET_AVX2 int nearestAVX2(const float* point, const float* x, const float* y, const float* z, unsigned int count, float& distanceSquared)
+	{
+		__m256 px = _mm256_set1_ps(point[0]), py = _mm256_set1_ps(point[1]), pz = _mm256_set1_ps(point[2]);
+		__m256 best = _mm256_set1_ps(3.402823466e+38f);
+		__m256i bestIndex = _mm256_set1_epi32(-1);
+		__m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		__m256i step = _mm256_set1_epi32(8);
+		unsigned int i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), px);
+			__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), py);
+			__m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), pz);
+			__m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+			__m256 closer = _mm256_cmp_ps(d2, best, _CMP_LT_OQ);
+			best = _mm256_blendv_ps(best, d2, closer);
+			bestIndex = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestIndex), _mm256_castsi256_ps(index), closer));
+			index = _mm256_add_epi32(index, step);
+		}
+		float lanes[8];
+		int indices[8];
+		_mm256_storeu_ps(lanes, best);
+		_mm256_storeu_si256((__m256i*)indices, bestIndex);
+		_mm256_zeroupper();
+		float bestDistance = 3.402823466e+38f;
+		int nearest = -1;
+		reduceNearest(lanes, indices, 8, bestDistance, nearest);
+		float tailDistance;
+		int tail = PointSpheresNearestScalar(point, x + i, y + i, z + i, count - i, tailDistance);
+		if (tail >= 0 && (nearest < 0 || tailDistance < bestDistance))
+		{
+			bestDistance = tailDistance;
+			nearest = (int)i + tail;
+		}
+		if (nearest >= 0)
+			distanceSquared = bestDistance;
+		return nearest;
+	}
+#endif
+
+	KernelPath bestPath()
+	{
+#ifdef KERNELS_X86
+		if (cpuHasAVX2())
+			return KernelPath::AVX2;
+		return KernelPath::SSE;
+#else
+		return KernelPath::Scalar;
+#endif
+	}
+
+	HitsKernel hitsFor(KernelPath path)
+	{
+#ifdef KERNELS_X86
+		if (path == KernelPath::AVX2)
+			return hitsAVX2;
+		if (path == KernelPath::SSE)
+			return hitsSSE;
+#endif
+		return PointSpheresHitsScalar;
+	}
+
+	NearestKernel nearestFor(KernelPath path)
+	{
+#ifdef KERNELS_X86
+		if (path == KernelPath::AVX2)
+			return nearestAVX2;
+		if (path == KernelPath::SSE)
+			return nearestSSE;
+#endif
+		return PointSpheresNearestScalar;
+	}
+
+	//picked once at static init, the jobs calling the kernels only ever read these
+	KernelPath currentPath = bestPath();
+	HitsKernel hitsKernel = hitsFor(currentPath);
+	NearestKernel nearestKernel = nearestFor(currentPath);
+}
+
+unsigned int PointSpheresHitsScalar(const float point[3], const float* x, const float* y, const float* z, unsigned int count, float radiusSquared, unsigned char* hits)
+{
+	unsigned int hitCount = 0;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		float dx = x[i] - point[0];
+		float dy = y[i] - point[1];
+		float dz = z[i] - point[2];
+		float d2 = (dx * dx + dy * dy) + dz * dz;
+		hits[i] = d2 < radiusSquared ? 1 : 0;
+		hitCount += hits[i];
+	}
+	return hitCount;
+}
+
+int PointSpheresNearestScalar(const float point[3], const float* x, const float* y, const float* z, unsigned int count, float& distanceSquared)
+{
+	int nearest = -1;
+	float best = 0.0f;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		float dx = x[i] - point[0];
+		float dy = y[i] - point[1];
+		float dz = z[i] - point[2];
+		float d2 = (dx * dx + dy * dy) + dz * dz;
+		if (nearest < 0 || d2 < best)
+		{
+			best = d2;
+			nearest = (int)i;
+		}
+	}
+	if (nearest >= 0)
+		distanceSquared = best;
+	return nearest;
+}
+
+unsigned int PointSpheresHits(const float point[3], const float* x, const float* y, const float* z, unsigned int count, float radiusSquared, unsigned char* hits)
+{
+	return hitsKernel(point, x, y, z, count, radiusSquared, hits);
+}
+
+int PointSpheresNearest(const float point[3], const float* x, const float* y, const float* z, unsigned int count, float& distanceSquared)
+{
+	return nearestKernel(point, x, y, z, count, distanceSquared);
+}
+
+void PointsSpheresFirstHit(const float* px, const float* py, const float* pz, unsigned int pointCount, const float* x, const float* y, const float* z, unsigned int count, float radiusSquared, int* firstHit)
+{
+	//spheres are tested in blocks so the hit mask stays small and in cache
+	const unsigned int BLOCK = 256;
+	unsigned char hits[BLOCK];
+	for (unsigned int p = 0; p < pointCount; p++)
+	{
+		float point[3] = { px[p], py[p], pz[p] };
+		firstHit[p] = -1;
+		for (unsigned int start = 0; start < count && firstHit[p] < 0; start += BLOCK)
+		{
+			unsigned int blockCount = count - start < BLOCK ? count - start : BLOCK;
+			if (hitsKernel(point, x + start, y + start, z + start, blockCount, radiusSquared, hits) == 0)
+				continue;
+			for (unsigned int i = 0; i < blockCount; i++)
+			{
+				if (hits[i])
+				{
+					firstHit[p] = (int)(start + i);
+					break;
+				}
+			}
+		}
+	}
+}
+
+KernelPath GetKernelPath()
+{
+	return currentPath;
+}
+
+void SetKernelPath(KernelPath path)
+{
+	KernelPath best = bestPath();
+	if ((int)path > (int)best)
+		path = best;
+	currentPath = path;
+	hitsKernel = hitsFor(path);
+	nearestKernel = nearestFor(path);
+}
+
+const char* KernelPathName(KernelPath path)
+{
+	if (path == KernelPath::AVX2)
+		return "avx2";
+	if (path == KernelPath::SSE)
+		return "sse";
+	return "scalar";
+}
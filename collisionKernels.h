@@ -0,0 +1,26 @@
+#ifndef COLLISION_KERNELS_H
+#define COLLISION_KERNELS_H
+
+//batched squared distance tests of points against spheres that share one radius.
+//sphere centres are packed as separate x, y and z arrays.
+//the AVX2 or SSE version is chosen at runtime from what the cpu supports,
+//the scalar versions are the reference the others must match exactly
+
+//hits[i] is set to 1 if point is inside sphere i and 0 if not, returns the number of hits
+unsigned int PointSpheresHits(const float point[3], const float* x, const float* y, const float* z, unsigned int count, float radiusSquared, unsigned char* hits);
+//index of the closest centre to point (lowest index on ties), -1 if count is 0
+int PointSpheresNearest(const float point[3], const float* x, const float* y, const float* z, unsigned int count, float& distanceSquared);
+//for each point, firstHit[i] is the lowest sphere index it is inside or -1
+void PointsSpheresFirstHit(const float* px, const float* py, const float* pz, unsigned int pointCount, const float* x, const float* y, const float* z, unsigned int count, float radiusSquared, int* firstHit);
+
+unsigned int PointSpheresHitsScalar(const float point[3], const float* x, const float* y, const float* z, unsigned int count, float radiusSquared, unsigned char* hits);
+int PointSpheresNearestScalar(const float point[3], const float* x, const float* y, const float* z, unsigned int count, float& distanceSquared);
+
+enum class KernelPath { Scalar, SSE, AVX2 };
+KernelPath GetKernelPath();
+//forces a path, for benchmarks and testing against the reference. unsupported paths fall back to the best supported.
+//the kernels are read without a lock, so it must not be called while jobs are running
+void SetKernelPath(KernelPath path);
+const char* KernelPathName(KernelPath path);
+
+#endif
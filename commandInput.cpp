@@ -0,0 +1,25 @@
+#include "commandInput.h"
+
+NetCommand CommandInput::Sample(InputSource& input, unsigned int tick)
+{
+	NetCommand sampled;
+	sampled.tick = tick;
+	for (unsigned int k = 0; k < INPUT_KEY_COUNT; k++)
+	{
+		if (input.IsDown((InputKey)k))
+			sampled.keys |= (unsigned char)(1u << k);
+	}
+	input.GetCursor(sampled.cursorX, sampled.cursorY);
+	return sampled;
+}
+
+bool CommandInput::IsDown(InputKey key)
+{
+	return (command.keys & (1u << (unsigned int)key)) != 0;
+}
+
+void CommandInput::GetCursor(double& x, double& y)
+{
+	x = command.cursorX;
+	y = command.cursorY;
+}
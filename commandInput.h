@@ -0,0 +1,21 @@
+#ifndef COMMAND_INPUT_H
+#define COMMAND_INPUT_H
+
+#include "input.h"
+#include "netProtocol.h"
+
+//input from one NetCommand. the server runs each tick from the command the client sent for it, and the
+//client runs the same commands through its own camera to predict where the server will put it
+class CommandInput : public InputSource
+{
+public:
+	//the keys held and the cursor, from any other source
+	static NetCommand Sample(InputSource& input, unsigned int tick);
+
+	bool IsDown(InputKey key) override;
+	void GetCursor(double& x, double& y) override;
+
+	NetCommand command;
+};
+
+#endif
@@ -3,31 +3,125 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#include "gameObject.h"
-#include "model.h"
+#include "entityPool.h"
 
-Enemy::Enemy(glm::vec3 position, Model* objectModel) : GameObject(position, objectModel)
+EnemyPool::EnemyPool(unsigned int capacity) : EntityPool(capacity)
 {
-	this->velocity = velocity;
+	steering.reserve(capacity);
 }
 
+EntityHandle EnemyPool::Spawn(glm::vec3 position)
+{
+	//velocity is set towards the target on the first update
+	return Add(position, glm::vec3(0.0f), radius);
+}
+
+void EnemyPool::Update(float timeElapsed, glm::vec3 target)
+{
+	UpdateRange(timeElapsed, target, 0, Size());
+}
+
+void EnemyPool::UpdateRange(float timeElapsed, glm::vec3 target, unsigned int begin, unsigned int end, const FlowField* flowField)
+{
+	moveRange(timeElapsed, begin, end);
+	for (unsigned int i = begin; i < end; i++)
+		velocities[i] = glm::normalize(chaseDirection(positions[i], target, flowField)) * speed;
+}
+
+glm::vec3 EnemyPool::chaseDirection(glm::vec3 position, glm::vec3 target, const FlowField* flowField)
+{
+	glm::vec3 toTarget = target - position;
+	if (flowField == nullptr)
+		return toTarget;
+	glm::vec2 flow = flowField->Direction(position);
+	if (flow.x == 0.0f && flow.y == 0.0f)
+		return toTarget;
+	//the field only steers across the ground, the climb or dive stays in proportion to the distance left
+	float across = glm::length(glm::vec2(toTarget.x, toTarget.z));
+	return glm::vec3(flow.x * across, toTarget.y, flow.y * across);
+}
+
+void EnemyPool::UpdateFlock(float timeElapsed, glm::vec3 target, const FlockSettings& settings, SpatialHash& grid, JobSystem& jobs, unsigned int grainSize, const FlowField* flowField)
+{
+	steering.resize(Size());
+	if (workerNeighbours.size() < jobs.getWorkerCount())
+	{
+		workerNeighbours.resize(jobs.getWorkerCount());
+		for (unsigned int i = 0; i < workerNeighbours.size(); i++)
+			workerNeighbours[i].reserve(positions.capacity());
+	}
+
+	jobs.ParallelFor(Size(), grainSize, [&](unsigned int begin, unsigned int end, unsigned int /*worker*/)
+	{
+		moveRange(timeElapsed, begin, end);
+	});
+	grid.Build(positions);
+	jobs.ParallelFor(Size(), grainSize, [&](unsigned int begin, unsigned int end, unsigned int worker)
+	{
+		steerRange(settings, target, flowField, grid, workerNeighbours[worker], jobs.Scratch(worker), begin, end);
+	});
+	jobs.ParallelFor(Size(), grainSize, [&](unsigned int begin, unsigned int end, unsigned int /*worker*/)
+	{
+		for (unsigned int i = begin; i < end; i++)
+			velocities[i] = steering[i];
+	});
+}
 
-void Enemy::Update(float timeElapsed)
+void EnemyPool::moveRange(float timeElapsed, unsigned int begin, unsigned int end)
 {
-	if (position.y < 0.0f)
+	glm::vec3* position = positions.data();
+	glm::vec3* velocity = velocities.data();
+	for (unsigned int i = begin; i < end; i++)
 	{
-		position.y = 0.0f;
-		velocity.y *= -1.0f;
+		if (position[i].y < 0.0f)
+		{
+			position[i].y = 0.0f;
+			velocity[i].y *= -1.0f;
+		}
+		position[i] += velocity[i] * timeElapsed;
 	}
-	position += speed * velocity * timeElapsed;
 }
 
-void Enemy::UpdateVelocity(glm::vec3 velocity)
+void EnemyPool::steerRange(const FlockSettings& settings, glm::vec3 target, const FlowField* flowField, SpatialHash& grid, std::vector<unsigned int>& neighbours, LinearAllocator& scratch, unsigned int begin, unsigned int end)
 {
-	this->velocity = velocity;
+	float separationSquared = settings.separationRadius * settings.separationRadius;
+	for (unsigned int i = begin; i < end; i++)
+	{
+		glm::vec3 position = positions[i];
+		grid.QueryRadius(position, settings.neighbourRadius, neighbours, &scratch);
+		glm::vec3 separation(0.0f), heading(0.0f), centre(0.0f);
+		unsigned int count = 0;
+		for (unsigned int j = 0; j < neighbours.size() && count < settings.maxNeighbours; j++)
+		{
+			unsigned int other = neighbours[j];
+			if (other == i)
+				continue;
+			glm::vec3 offset = position - positions[other];
+			float distanceSquared = glm::dot(offset, offset);
+			//pushes harder the closer they are, about 1 at the edge of the separation radius
+			if (distanceSquared < separationSquared && distanceSquared > 0.0f)
+				separation += offset * (settings.separationRadius / distanceSquared);
+			heading += velocities[other];
+			centre += positions[other];
+			count++;
+		}
+
+		glm::vec3 desired(0.0f);
+		glm::vec3 toTarget = chaseDirection(position, target, flowField);
+		if (glm::dot(toTarget, toTarget) > 0.0f)
+			desired += glm::normalize(toTarget) * settings.chaseWeight;
+		if (count > 0)
+		{
+			desired += separation * settings.separationWeight;
+			desired += heading / (float)count / speed * settings.alignmentWeight;
+			desired += (centre / (float)count - position) / settings.neighbourRadius * settings.cohesionWeight;
+		}
+		float length = glm::length(desired);
+		steering[i] = length > 0.0f ? desired / length * speed : velocities[i];
+	}
 }
 
-bool Enemy::Colliding(glm::vec3 pos)
+bool EnemyPool::Colliding(unsigned int index, glm::vec3 pos)
 {
-	return glm::distance(pos, position) < radius;
-}
\ No newline at end of file
+	return glm::distance(pos, positions[index]) < radii[index];
+}
@@ -4,21 +4,53 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#include "gameObject.h"
-#include "model.h"
+#include <vector>
 
-class Enemy : public GameObject
+#include "entityPool.h"
+#include "spatialHash.h"
+#include "jobSystem.h"
+#include "flowField.h"
+
+//flocking weights, the chase keeps the swarm heading for the target while the rest spread it out
+struct FlockSettings
+{
+	float neighbourRadius = 6.0f;
+	float separationRadius = 3.0f;
+	float chaseWeight = 1.0f;
+	float separationWeight = 1.5f;
+	float alignmentWeight = 0.4f;
+	float cohesionWeight = 0.3f;
+	//neighbours looked at per enemy, keeps the cost bounded when the swarm bunches up
+	unsigned int maxNeighbours = 16;
+};
+
+//every live enemy, they chase a target at a fixed speed
+class EnemyPool : public EntityPool
 {
 public:
-	Enemy(glm::vec3 position, Model* objectModel);
-	void Update(float timeElapsed);
-	void UpdateVelocity(glm::vec3 velocity);
-	bool Colliding(glm::vec3 pos);
+	EnemyPool(unsigned int capacity);
+	EntityHandle Spawn(glm::vec3 position);
+	//moves every enemy then turns it towards target
+	void Update(float timeElapsed, glm::vec3 target);
+	//the same for indices [begin, end) only, every enemy is independent so ranges can run in parallel.
+	//with a flow field, enemies follow it around trees on the ground plane instead of heading straight for target
+	void UpdateRange(float timeElapsed, glm::vec3 target, unsigned int begin, unsigned int end, const FlowField* flowField = nullptr);
+	//moves every enemy then steers it with separation, alignment and cohesion as well as the chase.
+	//grid is rebuilt from the moved positions to find neighbours. every velocity is worked out from
+	//the same snapshot before any is written, so the result doesn't depend on the worker count
+	void UpdateFlock(float timeElapsed, glm::vec3 target, const FlockSettings& settings, SpatialHash& grid, JobSystem& jobs, unsigned int grainSize, const FlowField* flowField = nullptr);
+	bool Colliding(unsigned int index, glm::vec3 pos);
 
+	const float speed = 14.5f;
+	const float radius = 1.4f;
 private:
-	glm::vec3 velocity;
-	float speed = 14.5f;
-	float radius = 1.4f;
+	std::vector<glm::vec3> steering;
+	std::vector<std::vector<unsigned int>> workerNeighbours;
+
+	void moveRange(float timeElapsed, unsigned int begin, unsigned int end);
+	void steerRange(const FlockSettings& settings, glm::vec3 target, const FlowField* flowField, SpatialHash& grid, std::vector<unsigned int>& neighbours, LinearAllocator& scratch, unsigned int begin, unsigned int end);
+	//not normalised, it keeps the height difference to the target
+	glm::vec3 chaseDirection(glm::vec3 position, glm::vec3 target, const FlowField* flowField);
 };
 
 
@@ -0,0 +1,138 @@
+#include "entityPool.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+EntityPool::EntityPool(unsigned int capacity)
+{
+	positions.reserve(capacity);
+	previousPositions.reserve(capacity);
+	velocities.reserve(capacity);
+	radii.reserve(capacity);
+	alive.reserve(capacity);
+	lods.reserve(capacity);
+	indexToSlot.reserve(capacity);
+	slotToIndex.reserve(capacity);
+	generations.reserve(capacity);
+	freeSlots.reserve(capacity);
+}
+
+EntityHandle EntityPool::Add(glm::vec3 position, glm::vec3 velocity, float radius)
+{
+	unsigned int slot;
+	if (!freeSlots.empty())
+	{
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		slot = (unsigned int)slotToIndex.size();
+		slotToIndex.push_back(0);
+		generations.push_back(0);
+	}
+	slotToIndex[slot] = (unsigned int)positions.size();
+	indexToSlot.push_back(slot);
+
+	positions.push_back(position);
+	previousPositions.push_back(position);
+	velocities.push_back(velocity);
+	radii.push_back(radius);
+	alive.push_back(1);
+	lods.push_back(0);
+
+	EntityHandle handle;
+	handle.slot = slot;
+	handle.generation = generations[slot];
+	return handle;
+}
+
+void EntityPool::Remove(unsigned int index)
+{
+	unsigned int last = (unsigned int)positions.size() - 1;
+	unsigned int slot = indexToSlot[index];
+	if (index != last)
+	{
+		positions[index] = positions[last];
+		previousPositions[index] = previousPositions[last];
+		velocities[index] = velocities[last];
+		radii[index] = radii[last];
+		alive[index] = alive[last];
+		lods[index] = lods[last];
+		indexToSlot[index] = indexToSlot[last];
+		slotToIndex[indexToSlot[index]] = index;
+	}
+	positions.pop_back();
+	previousPositions.pop_back();
+	velocities.pop_back();
+	radii.pop_back();
+	alive.pop_back();
+	lods.pop_back();
+	indexToSlot.pop_back();
+
+	//old handles to this slot stop matching
+	generations[slot]++;
+	freeSlots.push_back(slot);
+}
+
+void EntityPool::Kill(unsigned int index)
+{
+	alive[index] = 0;
+}
+
+void EntityPool::RemoveDead()
+{
+	//walk backwards so the entity swapped into a gap has already been checked
+	for (unsigned int i = (unsigned int)alive.size(); i > 0; i--)
+	{
+		if (!alive[i - 1])
+			Remove(i - 1);
+	}
+}
+
+void EntityPool::Clear()
+{
+	for (unsigned int i = 0; i < indexToSlot.size(); i++)
+	{
+		generations[indexToSlot[i]]++;
+		freeSlots.push_back(indexToSlot[i]);
+	}
+	positions.clear();
+	previousPositions.clear();
+	velocities.clear();
+	radii.clear();
+	alive.clear();
+	lods.clear();
+	indexToSlot.clear();
+}
+
+void EntityPool::SaveState()
+{
+	previousPositions = positions;
+}
+
+bool EntityPool::IsValid(EntityHandle handle)
+{
+	return handle.slot < generations.size() && generations[handle.slot] == handle.generation;
+}
+
+int EntityPool::IndexOf(EntityHandle handle)
+{
+	if (!IsValid(handle))
+		return -1;
+	return (int)slotToIndex[handle.slot];
+}
+
+EntityHandle EntityPool::HandleOf(unsigned int index)
+{
+	EntityHandle handle;
+	handle.slot = indexToSlot[index];
+	handle.generation = generations[handle.slot];
+	return handle;
+}
+
+unsigned int EntityPool::Size()
+{
+	return (unsigned int)positions.size();
+}
@@ -0,0 +1,54 @@
+#ifndef ENTITY_POOL_H
+#define ENTITY_POOL_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+struct EntityHandle
+{
+	unsigned int slot = 0xFFFFFFFF;
+	unsigned int generation = 0;
+};
+
+//entities stored as a structure of arrays, index i of every array is the same entity.
+//the arrays are kept packed: removing an entity moves the last one into its place,
+//so handles go through a slot table to stay valid while entities move around
+class EntityPool
+{
+public:
+	EntityPool(unsigned int capacity);
+
+	EntityHandle Add(glm::vec3 position, glm::vec3 velocity, float radius);
+	//removes now, the last entity takes this index
+	void Remove(unsigned int index);
+	//flags for removal without disturbing indices, RemoveDead then removes every flagged entity
+	void Kill(unsigned int index);
+	void RemoveDead();
+	void Clear();
+	//call at the start of each tick, before anything moves
+	void SaveState();
+
+	bool IsValid(EntityHandle handle);
+	//index into the arrays for a handle, -1 if the entity has been removed
+	int IndexOf(EntityHandle handle);
+	//the handle of whatever entity is at index now
+	EntityHandle HandleOf(unsigned int index);
+	unsigned int Size();
+
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec3> previousPositions;
+	std::vector<glm::vec3> velocities;
+	std::vector<float> radii;
+	std::vector<unsigned char> alive;
+	//lod each entity was last drawn at, for hysteresis
+	std::vector<int> lods;
+
+private:
+	std::vector<unsigned int> indexToSlot;
+	std::vector<unsigned int> slotToIndex;
+	std::vector<unsigned int> generations;
+	std::vector<unsigned int> freeSlots;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec3 FragPos;
+
+uniform sampler2D atlas;
+uniform vec3 viewPos;
+uniform vec3 tint;
+uniform vec3 fogColor;
+uniform float renderDistance;
+
+void main()
+{
+    vec4 colour = texture(atlas, TexCoords);
+    if (colour.a < 0.5)
+        discard;
+    vec3 result = colour.rgb * tint;
+
+    // same fog as the full models so the switch over is hidden
+    float distFromCam = distance(viewPos, FragPos);
+    float fog = smoothstep(renderDistance - 40, renderDistance - 5, distFromCam);
+    FragColor = vec4(mix(result, fogColor, fog), 1.0);
+}
@@ -0,0 +1,14 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec4 Colour;
+
+void main()
+{
+    // round, soft edged points
+    vec2 fromCentre = gl_PointCoord * 2.0 - 1.0;
+    float edge = 1.0 - dot(fromCentre, fromCentre);
+    if (edge <= 0.0)
+        discard;
+    FragColor = vec4(Colour.rgb, Colour.a * edge);
+}
@@ -20,6 +20,44 @@ uniform sampler2D texture_diffuse1;
 uniform vec3 fogColor;
 uniform float renderDistance;
 
+// point lights, sorted by LightClusters into clusters of screen tiles and depth slices
+uniform bool pointLights;
+uniform samplerBuffer lightData;
+uniform usamplerBuffer clusterRanges;
+uniform usamplerBuffer lightIndices;
+uniform vec2 clusterTileScale;
+uniform ivec3 clusterCounts;
+uniform vec2 clusterDepth;
+uniform vec3 viewForward;
+
+vec3 pointLighting(vec3 norm, vec3 viewDir, vec3 albedo)
+{
+    // the same split the lights were sorted with: tiles across the screen, slices growing with depth
+    ivec2 tile = min(ivec2(gl_FragCoord.xy * clusterTileScale), clusterCounts.xy - 1);
+    float depth = max(dot(FragPos - viewPos, viewForward), clusterDepth.y);
+    int slice = clamp(int(floor(log(depth / clusterDepth.y) * clusterDepth.x)), 0, clusterCounts.z - 1);
+    int cluster = (slice * clusterCounts.y + tile.y) * clusterCounts.x + tile.x;
+    uvec2 range = texelFetch(clusterRanges, cluster).xy;
+
+    vec3 result = vec3(0.0);
+    for (uint i = 0u; i < range.y; i++)
+    {
+        int light = int(texelFetch(lightIndices, int(range.x + i)).r);
+        vec4 positionRadius = texelFetch(lightData, light * 2);
+        vec3 colour = texelFetch(lightData, light * 2 + 1).rgb;
+        vec3 toLight = positionRadius.xyz - FragPos;
+        float dist = length(toLight);
+        // fades to nothing at the radius, so the light ending where its clusters do doesn't show
+        float falloff = clamp(1.0 - pow(dist / positionRadius.w, 4.0), 0.0, 1.0);
+        float attenuation = falloff * falloff / (1.0 + 0.1 * dist * dist);
+        vec3 lightDir = toLight / max(dist, 0.0001);
+        float diff = max(dot(norm, lightDir), 0.0);
+        float spec = pow(max(dot(viewDir, reflect(-lightDir, norm)), 0.0), shininess);
+        result += colour * attenuation * (diff + spec) * albedo;
+    }
+    return result;
+}
+
 void main()
 {
     // ambient
@@ -38,6 +76,8 @@ void main()
     vec3 specular = light.specular * spec * texture(texture_diffuse1, TexCoords).rgb;  
     
     vec3 result = ambient + diffuse + specular;
+    if (pointLights)
+        result += pointLighting(norm, viewDir, texture(texture_diffuse1, TexCoords).rgb);
     if(fogColor != vec3(0.0f))
     {
         float distFromCam = distance(viewPos, FragPos);
@@ -0,0 +1,179 @@
+#include "flowField.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+	const unsigned int UNREACHED = 0xFFFFFFFF;
+}
+
+FlowField::FlowField(int chunksAcross, float chunkSize, int cellsPerChunk)
+{
+	cellsAcross = chunksAcross * cellsPerChunk;
+	cellSize = chunkSize / cellsPerChunk;
+	int cellCount = cellsAcross * cellsAcross;
+	blockCount.resize(cellCount, 0);
+	distance.resize(cellCount, UNREACHED);
+	directions.resize(cellCount, glm::vec2(0.0f));
+	frontier.reserve(cellCount);
+}
+
+bool FlowField::SetOrigin(glm::vec3 centre)
+{
+	if (hasOrigin && centre.x == this->centre.x && centre.z == this->centre.z)
+		return false;
+	hasOrigin = true;
+	this->centre = centre;
+	corner = glm::vec2(centre.x, centre.z) - glm::vec2(cellsAcross * cellSize * 0.5f);
+	Clear();
+	return true;
+}
+
+void FlowField::AddObstacles(const std::vector<glm::vec3>& trees, float obstacleRadius)
+{
+	stamp(trees, obstacleRadius, 1);
+}
+
+void FlowField::RemoveObstacles(const std::vector<glm::vec3>& trees, float obstacleRadius)
+{
+	stamp(trees, obstacleRadius, -1);
+}
+
+void FlowField::Clear()
+{
+	std::fill(blockCount.begin(), blockCount.end(), 0);
+	dirty = true;
+}
+
+int FlowField::cellIndex(glm::vec3 position) const
+{
+	int x = (int)std::floor((position.x - corner.x) / cellSize);
+	int z = (int)std::floor((position.z - corner.y) / cellSize);
+	if (x < 0 || z < 0 || x >= cellsAcross || z >= cellsAcross)
+		return -1;
+	return z * cellsAcross + x;
+}
+
+void FlowField::stamp(const std::vector<glm::vec3>& trees, float obstacleRadius, int change)
+{
+	float radiusSquared = obstacleRadius * obstacleRadius;
+	for (unsigned int i = 0; i < trees.size(); i++)
+	{
+		int minX = (int)std::floor((trees[i].x - obstacleRadius - corner.x) / cellSize);
+		int maxX = (int)std::floor((trees[i].x + obstacleRadius - corner.x) / cellSize);
+		int minZ = (int)std::floor((trees[i].z - obstacleRadius - corner.y) / cellSize);
+		int maxZ = (int)std::floor((trees[i].z + obstacleRadius - corner.y) / cellSize);
+		for (int z = std::max(minZ, 0); z <= std::min(maxZ, cellsAcross - 1); z++)
+		{
+			for (int x = std::max(minX, 0); x <= std::min(maxX, cellsAcross - 1); x++)
+			{
+				//blocked if the middle of the cell is inside the obstacle
+				float dx = corner.x + (x + 0.5f) * cellSize - trees[i].x;
+				float dz = corner.y + (z + 0.5f) * cellSize - trees[i].z;
+				if (dx * dx + dz * dz > radiusSquared)
+					continue;
+				unsigned char& count = blockCount[z * cellsAcross + x];
+				if (change > 0 && count < 255)
+					count++;
+				else if (change < 0 && count > 0)
+					count--;
+				dirty = true;
+			}
+		}
+	}
+}
+
+bool FlowField::SetTarget(glm::vec3 target)
+{
+	int cell = cellIndex(target);
+	if (cell == targetCell && !dirty)
+		return false;
+	targetCell = cell;
+	dirty = false;
+	search();
+	return true;
+}
+
+void FlowField::search()
+{
+	std::fill(distance.begin(), distance.end(), UNREACHED);
+	std::fill(directions.begin(), directions.end(), glm::vec2(0.0f));
+	reachableCells = 0;
+	if (targetCell < 0)
+		return;
+
+	//breadth first out from the target over free cells, the target cell itself always counts as free
+	frontier.clear();
+	frontier.push_back(targetCell);
+	distance[targetCell] = 0;
+	const int offsetX[4] = { 1, -1, 0, 0 };
+	const int offsetZ[4] = { 0, 0, 1, -1 };
+	for (unsigned int next = 0; next < frontier.size(); next++)
+	{
+		int cell = frontier[next];
+		int x = cell % cellsAcross, z = cell / cellsAcross;
+		for (int n = 0; n < 4; n++)
+		{
+			int nx = x + offsetX[n], nz = z + offsetZ[n];
+			if (nx < 0 || nz < 0 || nx >= cellsAcross || nz >= cellsAcross)
+				continue;
+			int neighbour = nz * cellsAcross + nx;
+			if (blockCount[neighbour] > 0 || distance[neighbour] != UNREACHED)
+				continue;
+			distance[neighbour] = distance[cell] + 1;
+			frontier.push_back(neighbour);
+		}
+	}
+	reachableCells = (int)frontier.size();
+
+	//each reached cell points at its closest neighbour, diagonals only when both sides are open so
+	//nothing cuts the corner of a tree
+	for (unsigned int i = 1; i < frontier.size(); i++)
+	{
+		int cell = frontier[i];
+		int x = cell % cellsAcross, z = cell / cellsAcross;
+		unsigned int best = distance[cell];
+		glm::vec2 direction(0.0f);
+		for (int dz = -1; dz <= 1; dz++)
+		{
+			for (int dx = -1; dx <= 1; dx++)
+			{
+				int nx = x + dx, nz = z + dz;
+				if ((dx == 0 && dz == 0) || nx < 0 || nz < 0 || nx >= cellsAcross || nz >= cellsAcross)
+					continue;
+				if (dx != 0 && dz != 0 && (distance[z * cellsAcross + nx] == UNREACHED || distance[nz * cellsAcross + x] == UNREACHED))
+					continue;
+				unsigned int d = distance[nz * cellsAcross + nx];
+				if (d < best)
+				{
+					best = d;
+					direction = glm::vec2((float)dx, (float)dz);
+				}
+			}
+		}
+		if (direction.x != 0.0f || direction.y != 0.0f)
+			directions[cell] = glm::normalize(direction);
+	}
+}
+
+glm::vec2 FlowField::Direction(glm::vec3 position) const
+{
+	int cell = cellIndex(position);
+	if (cell < 0)
+		return glm::vec2(0.0f);
+	return directions[cell];
+}
+
+int FlowField::getCellCount()
+{
+	return cellsAcross * cellsAcross;
+}
+
+int FlowField::getReachableCells()
+{
+	return reachableCells;
+}
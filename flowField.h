@@ -0,0 +1,54 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+//grid over the loaded chunks on the ground plane that stores, for every cell, which way to go to reach
+//the target while keeping clear of trees. it is worked out once for everyone with a breadth first search
+//out from the target cell, so each enemy only has to look up the cell it is in
+class FlowField
+{
+public:
+	//chunksAcross chunks of chunkSize on a side, each split into cellsPerChunk cells
+	FlowField(int chunksAcross, float chunkSize, int cellsPerChunk);
+
+	//centre of the middle chunk. returns true if the field moved, in which case every obstacle was
+	//dropped and the loaded chunks need adding again
+	bool SetOrigin(glm::vec3 centre);
+	//blocks every cell within obstacleRadius of a tree, trees outside the field are ignored.
+	//cells keep a count so removing a chunk's trees leaves its neighbours' trees in place
+	void AddObstacles(const std::vector<glm::vec3>& trees, float obstacleRadius);
+	void RemoveObstacles(const std::vector<glm::vec3>& trees, float obstacleRadius);
+	void Clear();
+
+	//searches again only if the target is in a different cell or the obstacles changed, returns true if it did
+	bool SetTarget(glm::vec3 target);
+	//unit direction on the ground plane (x, z), zero outside the field, in the target cell or where
+	//the target can't be reached
+	glm::vec2 Direction(glm::vec3 position) const;
+
+	int getCellCount();
+	int getReachableCells();
+private:
+	int cellsAcross;
+	float cellSize;
+	glm::vec3 centre = glm::vec3(0.0f);
+	glm::vec2 corner = glm::vec2(0.0f);
+	bool hasOrigin = false;
+	bool dirty = true;
+	int targetCell = -1;
+	int reachableCells = 0;
+
+	std::vector<unsigned char> blockCount;
+	std::vector<unsigned int> distance;
+	std::vector<glm::vec2> directions;
+	std::vector<int> frontier;
+
+	int cellIndex(glm::vec3 position) const;
+	void stamp(const std::vector<glm::vec3>& trees, float obstacleRadius, int change);
+	void search();
+};
+
+#endif
@@ -0,0 +1,50 @@
+#include "framePacer.h"
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+	//sleeps can wake this late, the end of the wait is spent yielding instead
+	const std::chrono::microseconds SPIN_TIME(1500);
+}
+
+FramePacer::FramePacer(float rate)
+{
+	period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / rate));
+}
+
+float FramePacer::Wait()
+{
+	auto now = std::chrono::steady_clock::now();
+	if (!started)
+	{
+		started = true;
+		nextFrame = now + period;
+		return 0.0f;
+	}
+	//a frame that ran long starts the schedule again rather than rushing the ones after it to catch up
+	if (now >= nextFrame)
+	{
+		nextFrame = now + period;
+		return 0.0f;
+	}
+	auto start = now;
+	if (nextFrame - now > SPIN_TIME)
+		std::this_thread::sleep_for(nextFrame - now - SPIN_TIME);
+	while (std::chrono::steady_clock::now() < nextFrame)
+		std::this_thread::yield();
+	now = std::chrono::steady_clock::now();
+	nextFrame += period;
+	return std::chrono::duration<float>(now - start).count();
+}
+
+void FramePacer::Reset()
+{
+	started = false;
+}
+
+float FramePacer::getPeriod()
+{
+	return std::chrono::duration<float>(period).count();
+}
@@ -0,0 +1,25 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+
+//spaces frames out to a fixed rate without vsync. the wait comes at the start of the frame, before the
+//input is read, so the frame is drawn from input only as old as its own work. with vsync the wait is
+//in the buffer swap after the work instead, and the input read after it sits there for a whole frame
+//or more. the price is tearing, since the swap doesn't wait for the display
+class FramePacer
+{
+public:
+	FramePacer(float rate);
+	//call at the very start of each frame, returns the seconds it waited
+	float Wait();
+	//forget the schedule, the next frame starts straight away
+	void Reset();
+	float getPeriod();
+private:
+	std::chrono::steady_clock::duration period;
+	std::chrono::steady_clock::time_point nextFrame;
+	bool started = false;
+};
+
+#endif
@@ -5,10 +5,10 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-GameObject::GameObject(glm::vec3 position, Model* objectModel)
+GameObject::GameObject(Model* objectModel, float shininess)
 {
-	this->position = position;
 	this->objectModel = objectModel;
+	this->shininess = shininess;
 }
 
 GameObject::~GameObject()
@@ -16,25 +16,26 @@ GameObject::~GameObject()
 	objectModel = nullptr;
 }
 
-
-void GameObject::Update(float timeElapsed)
+unsigned int GameObject::Draw(Shader& shader, Camera& camera, const LodSettings& lodSettings, EntityPool& entities, float alpha, const OcclusionBuffer* occlusion)
 {
-
-}
-
-void GameObject::Draw(Shader& shader, Camera& camera)
-{
-	if (camera.inFov(position, 2.0f) && camera.inView(position, 2.0f))
+	glUniform1fv(shader.Location("shininess"), 1, &shininess);
+	unsigned int culled = 0;
+	for (unsigned int i = 0; i < entities.Size(); i++)
 	{
-		glm::mat4 model = glm::mat4(1.0f);
-		model = glm::translate(model, position);
-		glUniformMatrix4fv(shader.Location("model"), 1, GL_FALSE, &model[0][0]);
-		glUniform1fv(shader.Location("shininess"), 1, &shininess);
-		objectModel->Draw(shader);
+		glm::vec3 drawPos = glm::mix(entities.previousPositions[i], entities.positions[i], alpha);
+		if (camera.inFov(drawPos, 2.0f) && camera.inView(drawPos, 2.0f))
+		{
+			if (occlusion != nullptr && !occlusion->IsVisible(drawPos + objectModel->getBoundsMin(), drawPos + objectModel->getBoundsMax()))
+			{
+				culled++;
+				continue;
+			}
+			glm::mat4 model = glm::mat4(1.0f);
+			model = glm::translate(model, drawPos);
+			glUniformMatrix4fv(shader.Location("model"), 1, GL_FALSE, &model[0][0]);
+			entities.lods[i] = SelectLod(lodSettings, camera.projectedSize(drawPos, objectModel->getRadius()), entities.lods[i], objectModel->getLodCount());
+			objectModel->Draw(shader, entities.lods[i]);
+		}
 	}
+	return culled;
 }
-
-glm::vec3 GameObject::getPos()
-{
-	return position;
-}
\ No newline at end of file
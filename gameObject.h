@@ -7,24 +7,24 @@
 #include "gameObject.h"
 #include "model.h"
 #include "camera.h"
+#include "lod.h"
+#include "entityPool.h"
+#include "occlusionBuffer.h"
 
+//how one kind of game object looks, shared by every entity in its pool
 class GameObject
 {
 public:
-	GameObject(glm::vec3 postion, Model* objectModel);
+	GameObject(Model* objectModel, float shininess);
 	~GameObject();
 
-	void Draw(Shader& shader, Camera& camera);
-	void Update(float timeElapsed);
+	//alpha is how far between the previous and current tick to draw each entity. entities hidden
+	//behind occlusion's occluders are skipped if it isn't null, returns how many were
+	unsigned int Draw(Shader& shader, Camera& camera, const LodSettings& lodSettings, EntityPool& entities, float alpha, const OcclusionBuffer* occlusion = nullptr);
 
-	glm::vec3 getPos();
-	bool isRemoved = false;
-
-protected:
-	glm::vec3 position;
-	float shininess = 20.0f;
 private:
 	Model* objectModel;
+	float shininess = 20.0f;
 };
 
 
@@ -0,0 +1,66 @@
+#include "glfwInput.h"
+
+#include <GLFW/glfw3.h>
+
+GlfwInput::GlfwInput(GLFWwindow* window)
+{
+	this->window = window;
+	glfwSetWindowUserPointer(window, this);
+	glfwSetCursorPosCallback(window, cursorCallback);
+}
+
+void GlfwInput::cursorCallback(GLFWwindow* window, double x, double y)
+{
+	GlfwInput* input = (GlfwInput*)glfwGetWindowUserPointer(window);
+	//the first position is only where the cursor started
+	if (!input->firstEvent)
+	{
+		input->cursorX += x - input->lastX;
+		input->cursorY += y - input->lastY;
+		if (input->pendingTime < 0.0)
+			input->pendingTime = glfwGetTime();
+	}
+	input->firstEvent = false;
+	input->lastX = x;
+	input->lastY = y;
+}
+
+bool GlfwInput::IsDown(InputKey key)
+{
+	switch (key)
+	{
+	case InputKey::Forward:
+		return glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS;
+	case InputKey::Back:
+		return glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
+	case InputKey::Left:
+		return glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS;
+	case InputKey::Right:
+		return glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS;
+	case InputKey::Sprint:
+		return glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS;
+	case InputKey::Fire:
+		return glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+	case InputKey::RegenerateChunks:
+		return glfwGetKey(window, GLFW_KEY_F1) == GLFW_PRESS;
+	case InputKey::ToggleEnemies:
+		return glfwGetKey(window, GLFW_KEY_F2) == GLFW_PRESS;
+	}
+	return false;
+}
+
+void GlfwInput::GetCursor(double& x, double& y)
+{
+	x = cursorX;
+	y = cursorY;
+	if (pendingTime >= 0.0 && takenTime < 0.0)
+		takenTime = pendingTime;
+	pendingTime = -1.0;
+}
+
+double GlfwInput::TakeFirstMotionTime()
+{
+	double time = takenTime;
+	takenTime = -1.0;
+	return time;
+}
@@ -0,0 +1,33 @@
+#ifndef GLFW_INPUT_H
+#define GLFW_INPUT_H
+
+#include <GLFW/glfw3.h>
+
+#include "input.h"
+
+//reads the keyboard and mouse from a window. mouse movement is added up from every motion event as it
+//arrives rather than read once a frame, so polling twice in a frame picks up what came in between
+class GlfwInput : public InputSource
+{
+public:
+	//takes over the window's cursor callback and user pointer
+	GlfwInput(GLFWwindow* window);
+	bool IsDown(InputKey key) override;
+	void GetCursor(double& x, double& y) override;
+	//glfwGetTime of the first motion event handed out by GetCursor since the last call, negative if
+	//the mouse hasn't moved. events are timed when glfwPollEvents delivers them
+	double TakeFirstMotionTime();
+private:
+	GLFWwindow* window;
+	//every delta so far added up, the camera only looks at how far it moved
+	double cursorX = 0.0, cursorY = 0.0;
+	double lastX = 0.0, lastY = 0.0;
+	bool firstEvent = true;
+	//first event not yet handed out, and first handed out since TakeFirstMotionTime
+	double pendingTime = -1.0;
+	double takenTime = -1.0;
+
+	static void cursorCallback(GLFWwindow* window, double x, double y);
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "gpuParticles.h"
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace
+{
+	//written out in this order, which is the layout of Particle
+	const char* FEEDBACK_VARYINGS[2] = { "positionLife", "velocityKind" };
+}
+
+static_assert(sizeof(Particle) == 8 * sizeof(float), "the particle buffers are read as two vec4s a particle");
+
+GpuParticles::GpuParticles(ParticleSystem& particles)
+	: updateShader("vParticleUpdate.vert", FEEDBACK_VARYINGS, 2), drawShader("vParticle.vert", "fParticle.frag")
+{
+	static_assert(PARTICLE_KIND_COUNT <= MAX_KINDS, "the particle shaders have room for MAX_KINDS kinds");
+	capacity = particles.getCapacity();
+	burstPositionKind.reserve(ParticleSystem::MAX_BURSTS);
+	burstDirection.reserve(ParticleSystem::MAX_BURSTS);
+	burstEnd.reserve(ParticleSystem::MAX_BURSTS);
+
+	//every slot starts dead, with no life left
+	std::vector<Particle> empty(capacity, { glm::vec3(0.0f), 0.0f, glm::vec3(0.0f), 0.0f });
+	glGenBuffers(2, buffers);
+	glGenVertexArrays(2, vertexArrays);
+	for (int i = 0; i < 2; i++)
+	{
+		glBindVertexArray(vertexArrays[i]);
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+		glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(Particle), empty.data(), GL_DYNAMIC_COPY);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Particle), (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Particle), (void*)(4 * sizeof(float)));
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	//the kinds never change, so they are set once
+	glm::vec4 kindMotion[MAX_KINDS], kindColourSize[MAX_KINDS];
+	float kindLifetime[MAX_KINDS];
+	for (int k = 0; k < MAX_KINDS; k++)
+	{
+		const ParticleKindSettings& settings = ParticleSystem::getKindSettings((ParticleKind)(k < PARTICLE_KIND_COUNT ? k : 0));
+		kindMotion[k] = glm::vec4(settings.speed, settings.spread, settings.lifetime, settings.drag);
+		kindColourSize[k] = glm::vec4(settings.colour, settings.size);
+		kindLifetime[k] = settings.lifetime;
+	}
+	updateShader.Use();
+	glUniform4fv(updateShader.Location("kindMotion"), MAX_KINDS, &kindMotion[0][0]);
+	glUniform1f(updateShader.Location("gravity"), ParticleSystem::GRAVITY);
+	glUniform1f(updateShader.Location("bounce"), ParticleSystem::BOUNCE);
+	glUniform1i(updateShader.Location("capacity"), (int)capacity);
+	drawShader.Use();
+	glUniform4fv(drawShader.Location("kindColourSize"), MAX_KINDS, &kindColourSize[0][0]);
+	glUniform1fv(drawShader.Location("kindLifetime"), MAX_KINDS, kindLifetime);
+	glUseProgram(0);
+}
+
+GpuParticles::~GpuParticles()
+{
+	glDeleteVertexArrays(2, vertexArrays);
+	glDeleteBuffers(2, buffers);
+}
+
+void GpuParticles::Update(ParticleSystem& particles, float timeElapsed)
+{
+	const std::vector<ParticleBurst>& bursts = particles.getBursts();
+	burstPositionKind.clear();
+	burstDirection.clear();
+	burstEnd.clear();
+	int end = 0;
+	for (const ParticleBurst& burst : bursts)
+	{
+		end += (int)burst.count;
+		burstPositionKind.push_back(glm::vec4(burst.position, (float)burst.kind));
+		burstDirection.push_back(burst.direction);
+		burstEnd.push_back(end);
+	}
+
+	updateShader.Use();
+	int burstCount = (int)bursts.size();
+	glUniform1i(updateShader.Location("burstCount"), burstCount);
+	if (burstCount > 0)
+	{
+		glUniform4fv(updateShader.Location("burstPositionKind"), burstCount, &burstPositionKind[0][0]);
+		glUniform3fv(updateShader.Location("burstDirection"), burstCount, &burstDirection[0][0]);
+		glUniform1iv(updateShader.Location("burstEnd"), burstCount, burstEnd.data());
+	}
+	glUniform1i(updateShader.Location("ringStart"), (int)particles.getRingStart());
+	glUniform1ui(updateShader.Location("frame"), particles.getFrame());
+	glUniform1f(updateShader.Location("timeElapsed"), timeElapsed);
+
+	//nothing is drawn, the vertex shader's outputs go straight into the other buffer
+	int next = 1 - current;
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBindVertexArray(vertexArrays[current]);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffers[next]);
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArrays(GL_POINTS, 0, capacity);
+	glEndTransformFeedback();
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+	glBindVertexArray(0);
+	glDisable(GL_RASTERIZER_DISCARD);
+	current = next;
+}
+
+void GpuParticles::Upload(ParticleSystem& particles)
+{
+	const std::vector<Particle>& simulated = particles.getParticles();
+	if (simulated.empty())
+		return;
+	glBindBuffer(GL_ARRAY_BUFFER, buffers[current]);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, simulated.size() * sizeof(Particle), simulated.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GpuParticles::Draw(const glm::mat4& view, const glm::mat4& projection, int viewportHeight)
+{
+	drawShader.Use();
+	glUniformMatrix4fv(drawShader.Location("view"), 1, GL_FALSE, &view[0][0]);
+	glUniformMatrix4fv(drawShader.Location("projection"), 1, GL_FALSE, &projection[0][0]);
+	//projection[1][1] is 1 / tan(fov / 2), so this is how many pixels one unit at one unit away is
+	float pointScale = viewportHeight * 0.5f * projection[1][1];
+	glUniform1f(drawShader.Location("pointScale"), pointScale);
+
+	glEnable(GL_PROGRAM_POINT_SIZE);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+	glDepthMask(GL_FALSE);
+	glBindVertexArray(vertexArrays[current]);
+	glDrawArrays(GL_POINTS, 0, capacity);
+	glBindVertexArray(0);
+	glDepthMask(GL_TRUE);
+	glDisable(GL_BLEND);
+	glDisable(GL_PROGRAM_POINT_SIZE);
+}
@@ -0,0 +1,47 @@
+#ifndef GPU_PARTICLES_H
+#define GPU_PARTICLES_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "shader.h"
+#include "particleSystem.h"
+
+//the gl side of ParticleSystem. the particles live in two vertex buffers and each frame one is run
+//through vParticleUpdate.vert into the other with transform feedback, spawning the frame's bursts on
+//the way, then the new one is drawn as points. the cpu only sends the bursts
+class GpuParticles
+{
+public:
+	GpuParticles(ParticleSystem& particles);
+	~GpuParticles();
+	GpuParticles(const GpuParticles&) = delete;
+	GpuParticles& operator=(const GpuParticles&) = delete;
+
+	//spawns this frame's bursts and moves every particle
+	void Update(ParticleSystem& particles, float timeElapsed);
+	//instead of Update, copies the particles ParticleSystem::Simulate moved on the cpu
+	void Upload(ParticleSystem& particles);
+	//soft additive points, drawn after everything solid so it hides them but they don't hide anything.
+	//viewportHeight and the projection's vertical field of view size the points
+	void Draw(const glm::mat4& view, const glm::mat4& projection, int viewportHeight);
+private:
+	static const int MAX_KINDS = 4;
+
+	Shader updateShader;
+	Shader drawShader;
+	unsigned int capacity;
+	//the buffer with the latest particles, Update writes the other one
+	int current = 0;
+	unsigned int buffers[2] = { 0, 0 };
+	unsigned int vertexArrays[2] = { 0, 0 };
+	//the bursts packed for the update shader's uniform arrays
+	std::vector<glm::vec4> burstPositionKind;
+	std::vector<glm::vec3> burstDirection;
+	std::vector<int> burstEnd;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#include "gpuTimer.h"
+
+#include <glad/glad.h>
+
+GpuTimer::GpuTimer()
+{
+	glGenQueries(QUERY_COUNT, queries);
+}
+
+GpuTimer::~GpuTimer()
+{
+	glDeleteQueries(QUERY_COUNT, queries);
+}
+
+void GpuTimer::Begin()
+{
+	//every query is still in flight, this frame goes untimed rather than reusing one
+	timing = pending < QUERY_COUNT;
+	if (timing)
+		glBeginQuery(GL_TIME_ELAPSED, queries[next]);
+}
+
+void GpuTimer::End()
+{
+	if (!timing)
+		return;
+	timing = false;
+	glEndQuery(GL_TIME_ELAPSED);
+	next = (next + 1) % QUERY_COUNT;
+	pending++;
+}
+
+bool GpuTimer::Result(float& seconds)
+{
+	bool found = false;
+	while (pending > 0)
+	{
+		GLint available = 0;
+		glGetQueryObjectiv(queries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			break;
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(queries[oldest], GL_QUERY_RESULT, &nanoseconds);
+		seconds = (float)(nanoseconds * 1e-9);
+		found = true;
+		oldest = (oldest + 1) % QUERY_COUNT;
+		pending--;
+	}
+	return found;
+}
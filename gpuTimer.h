@@ -0,0 +1,31 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <glad/glad.h>
+
+//times the gl work of each frame with timer queries. the result of a frame is only read once the gpu
+//has finished it, a few frames later, so asking never waits for the gpu
+class GpuTimer
+{
+public:
+	GpuTimer();
+	~GpuTimer();
+	GpuTimer(const GpuTimer&) = delete;
+	GpuTimer& operator=(const GpuTimer&) = delete;
+
+	//around everything drawn in a frame
+	void Begin();
+	void End();
+	//the time of the most recent frame the gpu has finished since the last call, false if none has
+	bool Result(float& seconds);
+private:
+	static const int QUERY_COUNT = 4;
+	unsigned int queries[QUERY_COUNT];
+	//next query to begin and oldest one still waiting for its result
+	int next = 0;
+	int oldest = 0;
+	int pending = 0;
+	bool timing = false;
+};
+
+#endif
@@ -0,0 +1,189 @@
+#include "groundGrid.h"
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+GroundGrid::GroundGrid(const Mesh& tile, int slotsAcross, float chunkSize, float shininess)
+{
+	this->tile = &tile;
+	this->slotsAcross = slotsAcross;
+	this->chunkSize = chunkSize;
+	this->shininess = shininess;
+
+	const std::vector<Vertex>& vertices = tile.getVertices();
+	const std::vector<unsigned int>& indices = tile.getIndices();
+	verticesPerTile = (unsigned int)vertices.size();
+	for (const Vertex& vertex : vertices)
+	{
+		const float packed[FLOATS_PER_VERTEX] = { vertex.Position.x, vertex.Position.y, vertex.Position.z,
+			vertex.Normal.x, vertex.Normal.y, vertex.Normal.z, vertex.TexCoords.x, vertex.TexCoords.y };
+		tileVertices.insert(tileVertices.end(), packed, packed + FLOATS_PER_VERTEX);
+	}
+	slotVertices.resize(tileVertices.size());
+
+	unsigned int slotCount = (unsigned int)(slotsAcross * slotsAcross);
+	slotCells.resize(slotCount, glm::ivec2(0, 0));
+	slotUsed.resize(slotCount, 0);
+	slotSeen.resize(slotCount, 0);
+	//at worst every other slot is used
+	runCounts.reserve(slotCount / 2 + 1);
+	runOffsets.reserve(slotCount / 2 + 1);
+
+	//the index buffer never changes, slot k uses the tile's indices offset by its first vertex
+	std::vector<unsigned int> allIndices;
+	allIndices.reserve(indices.size() * slotCount);
+	for (unsigned int slot = 0; slot < slotCount; slot++)
+	{
+		for (unsigned int index : indices)
+			allIndices.push_back(index + slot * verticesPerTile);
+	}
+	indexCount = (unsigned int)allIndices.size();
+
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	//every slot starts empty, all zeros is every vertex at the origin
+	std::vector<float> empty(tileVertices.size() * slotCount, 0.0f);
+	glBufferData(GL_ARRAY_BUFFER, empty.size() * sizeof(float), empty.data(), GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, allIndices.size() * sizeof(unsigned int), allIndices.data(), GL_STATIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)(6 * sizeof(float)));
+	glBindVertexArray(0);
+}
+
+GroundGrid::~GroundGrid()
+{
+	glDeleteBuffers(1, &EBO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteVertexArrays(1, &VAO);
+}
+
+glm::ivec2 GroundGrid::latticeCell(glm::vec3 chunkPos, bool& onLattice)
+{
+	//chunk positions are built up by adding chunk widths, so they are only close to the lattice
+	float cellX = (chunkPos.x - latticeOrigin.x) / chunkSize;
+	float cellZ = (chunkPos.z - latticeOrigin.z) / chunkSize;
+	glm::ivec2 cell((int)std::floor(cellX + 0.5f), (int)std::floor(cellZ + 0.5f));
+	onLattice = std::fabs(cellX - cell.x) < 0.25f && std::fabs(cellZ - cell.y) < 0.25f;
+	return cell;
+}
+
+int GroundGrid::slotIndex(glm::ivec2 cell)
+{
+	//wrapped so the same chunk always lands in the same slot however far the player has walked
+	int x = ((cell.x % slotsAcross) + slotsAcross) % slotsAcross;
+	int z = ((cell.y % slotsAcross) + slotsAcross) % slotsAcross;
+	return z * slotsAcross + x;
+}
+
+void GroundGrid::writeSlot(unsigned int slot, glm::ivec2 cell, glm::vec3 chunkPos, bool used)
+{
+	if (used)
+	{
+		for (unsigned int i = 0; i < tileVertices.size(); i += FLOATS_PER_VERTEX)
+		{
+			std::copy(tileVertices.begin() + i, tileVertices.begin() + i + FLOATS_PER_VERTEX, slotVertices.begin() + i);
+			slotVertices[i] += chunkPos.x;
+			slotVertices[i + 1] += chunkPos.y;
+			slotVertices[i + 2] += chunkPos.z;
+		}
+	}
+	else
+		std::fill(slotVertices.begin(), slotVertices.end(), 0.0f);
+	glBufferSubData(GL_ARRAY_BUFFER, slot * slotVertices.size() * sizeof(float), slotVertices.size() * sizeof(float), slotVertices.data());
+	slotCells[slot] = cell;
+	slotUsed[slot] = used;
+	slotsWritten++;
+}
+
+void GroundGrid::Update(std::vector<Chunk>& chunks, glm::vec3 eye, float reach)
+{
+	slotsWritten = 0;
+	chunkCount = 0;
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	//chunks are only ever made a whole number of chunks from each other, until they are all made
+	//again around the player. then the lattice starts again from the new ones and every slot is rewritten
+	bool onLattice = false;
+	if (!chunks.empty())
+		latticeCell(chunks[0].getPos(), onLattice);
+	if (!onLattice && !chunks.empty())
+	{
+		latticeOrigin = chunks[0].getPos();
+		std::fill(slotCells.begin(), slotCells.end(), glm::ivec2(std::numeric_limits<int>::min(), 0));
+	}
+	std::fill(slotSeen.begin(), slotSeen.end(), 0);
+	for (unsigned int i = 0; i < chunks.size(); i++)
+	{
+		glm::vec3 chunkPos = chunks[i].getPos();
+		if (std::max(std::fabs(chunkPos.x - eye.x), std::fabs(chunkPos.z - eye.z)) > reach)
+			continue;
+		chunkCount++;
+		glm::ivec2 cell = latticeCell(chunkPos, onLattice);
+		int slot = slotIndex(cell);
+		//two chunks can be made a rounding error apart in the same place, they share a slot
+		if (slotSeen[slot])
+			continue;
+		slotSeen[slot] = 1;
+		if (!slotUsed[slot] || slotCells[slot].x != cell.x || slotCells[slot].y != cell.y)
+			writeSlot(slot, cell, chunkPos, true);
+	}
+	for (unsigned int slot = 0; slot < slotUsed.size(); slot++)
+	{
+		if (slotUsed[slot] && !slotSeen[slot])
+			writeSlot(slot, glm::ivec2(0, 0), glm::vec3(0.0f), false);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	runCounts.clear();
+	runOffsets.clear();
+	unsigned int indicesPerTile = indexCount / (unsigned int)slotUsed.size();
+	for (unsigned int slot = 0; slot < slotUsed.size(); slot++)
+	{
+		if (!slotUsed[slot])
+			continue;
+		if (slot > 0 && slotUsed[slot - 1])
+			runCounts.back() += (GLsizei)indicesPerTile;
+		else
+		{
+			runCounts.push_back((GLsizei)indicesPerTile);
+			runOffsets.push_back((const void*)((size_t)slot * indicesPerTile * sizeof(unsigned int)));
+		}
+	}
+}
+
+void GroundGrid::Draw(Shader& shader)
+{
+	glm::mat4 model = glm::mat4(1.0f);
+	glUniformMatrix4fv(shader.Location("model"), 1, GL_FALSE, &model[0][0]);
+	glUniform1fv(shader.Location("shininess"), 1, &shininess);
+	tile->BindTextures(shader);
+	glBindVertexArray(VAO);
+	if (!runCounts.empty())
+		glMultiDrawElements(GL_TRIANGLES, runCounts.data(), GL_UNSIGNED_INT, runOffsets.data(), (GLsizei)runCounts.size());
+	glBindVertexArray(0);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+unsigned int GroundGrid::getSlotsWritten()
+{
+	return slotsWritten;
+}
+
+unsigned int GroundGrid::getChunkCount()
+{
+	return chunkCount;
+}
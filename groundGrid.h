@@ -0,0 +1,64 @@
+#ifndef GROUND_GRID_H
+#define GROUND_GRID_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "shader.h"
+#include "mesh.h"
+#include "chunk.h"
+
+//the ground of every loaded chunk in one vertex buffer, drawn with a single call. each chunk gets the
+//slot its position wraps to in a grid as wide as the loaded area, so the grid follows the player
+//without moving anything: only chunks that loaded or unloaded since the last update are written.
+//empty slots are collapsed to a point and left out of the draw. every slot is a copy of one tile mesh,
+//which can be as finely divided as a heightfield would need
+class GroundGrid
+{
+public:
+	//tile has to be loaded with its geometry retained. slotsAcross is the most chunks that can be
+	//loaded along one axis at once
+	GroundGrid(const Mesh& tile, int slotsAcross, float chunkSize, float shininess);
+	~GroundGrid();
+	GroundGrid(const GroundGrid&) = delete;
+	GroundGrid& operator=(const GroundGrid&) = delete;
+
+	//writes the slots of chunks that appeared or went away since the last update. chunks further than
+	//reach from eye along either axis get no ground, like the trees the quality governor hides
+	void Update(std::vector<Chunk>& chunks, glm::vec3 eye, float reach);
+	void Draw(Shader& shader);
+	//slots written by the last Update
+	unsigned int getSlotsWritten();
+	//chunks the last Update gave ground to
+	unsigned int getChunkCount();
+
+private:
+	const Mesh* tile;
+	int slotsAcross;
+	float chunkSize;
+	float shininess;
+	//position, normal and texture coordinates, 8 floats a vertex
+	static const int FLOATS_PER_VERTEX = 8;
+	std::vector<float> tileVertices;
+	std::vector<float> slotVertices;
+	unsigned int verticesPerTile = 0, indexCount = 0;
+	//the lattice cell of the chunk each slot holds, chunks are on a lattice starting at latticeOrigin
+	std::vector<glm::ivec2> slotCells;
+	std::vector<unsigned char> slotUsed;
+	std::vector<unsigned char> slotSeen;
+	glm::vec3 latticeOrigin = glm::vec3(0.0f);
+	unsigned int chunkCount = 0, slotsWritten = 0;
+	//runs of neighbouring used slots, each one is a range of the index buffer drawn in one go
+	std::vector<GLsizei> runCounts;
+	std::vector<const void*> runOffsets;
+	unsigned int VAO = 0, VBO = 0, EBO = 0;
+
+	glm::ivec2 latticeCell(glm::vec3 chunkPos, bool& onLattice);
+	int slotIndex(glm::ivec2 cell);
+	void writeSlot(unsigned int slot, glm::ivec2 cell, glm::vec3 chunkPos, bool used);
+};
+
+#endif
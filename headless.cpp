@@ -0,0 +1,321 @@
+//runs the simulation with no window and no gl, driven by scripted input as fast as it will go.
+//reports ticks per second and how many entities were alive, for timing the game logic on its own:
+//  headless [--ticks <n>] [--script <file>] [--seed <n>] [--threads <n>] [--flocking] [--stress <n>]
+//           [--record <file>] [--replay <file>] [--warmup <ticks>] [--resume <file>] [--snapshot <file>]
+//           [--connect <port>]
+//--record writes the run out for replaying, --replay plays a recording from here or the game instead of the
+//script, with the recording's seed and settings, and checks it ends in the same state.
+//--resume starts from a snapshot saved by the game or --snapshot, with its seed and settings, so a run
+//can start from a busy point in a long session. --snapshot saves the state the run ends in.
+//once --warmup ticks have run (600 by default) every buffer should have reached its size, so any heap
+//allocation after that fails the run.
+//--connect plays against forestServer on that port instead of running the simulation here: the script
+//is sent to it a tick at a time, in real time, and the bandwidth, the server's tick cost and how far the
+//predicted camera was off are reported. the seed and settings are the server's
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <stdlib.h>
+#include <memory>
+
+#include "simulation.h"
+#include "scriptedInput.h"
+#include "inputRecorder.h"
+#include "replayInput.h"
+#include "jobSystem.h"
+#include "allocationCounter.h"
+#include "mappedFile.h"
+#include "snapshotWriter.h"
+#include "netClient.h"
+#include "framePacer.h"
+
+namespace
+{
+	//the script played against a server, one client tick per server tick
+	int runClient(unsigned short port, unsigned long long tickCount, const std::string& scriptPath, int threadCount, unsigned long long warmupTicks)
+	{
+		NetClient client(port);
+		NetWelcome welcome;
+		if (!client.Connect(5.0f, welcome))
+			return 1;
+		SimulationSettings settings;
+		settings.seed = welcome.seed;
+		settings.flocking = welcome.flocking != 0;
+		settings.stressEnemies = welcome.stressEnemies;
+		settings.chunkRadius = welcome.chunkRadius;
+		settings.printScore = false;
+		JobSystem jobs(threadCount);
+		//never ticked, only filled from the snapshots
+		Simulation mirror(settings, jobs);
+		ScriptedInput script(scriptPath);
+		std::cout << "connected:   port " << port << ", seed " << welcome.seed << ", " << 1.0f / welcome.tickTime << " ticks per second" << std::endl;
+
+		FramePacer pacer(1.0f / welcome.tickTime);
+		AllocationStats steadyAllocations;
+		unsigned long long allocatingTicks = 0, firstAllocatingTick = 0;
+		double clientMilliseconds = 0.0;
+		unsigned long long t = 0;
+		for (; t < tickCount && !client.IsServerGone(); t++)
+		{
+			pacer.Wait();
+			AllocationStats tickStart = GetAllocationStats();
+			auto start = std::chrono::high_resolution_clock::now();
+			client.Tick(mirror, script);
+			script.Advance();
+			clientMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			AllocationStats tickAllocations = AllocationsSince(tickStart);
+			if (t > warmupTicks && tickAllocations.count > 0)
+			{
+				if (allocatingTicks++ == 0)
+					firstAllocatingTick = t;
+				steadyAllocations.count += tickAllocations.count;
+				steadyAllocations.bytes += tickAllocations.bytes;
+			}
+		}
+		client.Disconnect();
+
+		const NetClientStats& stats = client.getStats();
+		double ticks = (double)(stats.ticks > 0 ? stats.ticks : 1);
+		double snapshots = (double)(stats.snapshots > 0 ? stats.snapshots : 1);
+		std::cout << t << " ticks against the server, " << clientMilliseconds / ticks << "ms per client tick" << std::endl;
+		std::cout << "snapshots:   " << stats.snapshots << " received, " << stats.fullSnapshots << " full, " << stats.damagedSnapshots << " unreadable, "
+			<< stats.missingTicks << " ticks missing one, " << stats.starvedTicks << " ticks waiting" << std::endl;
+		std::cout << "bandwidth:   " << stats.bytes / snapshots << " bytes per snapshot, " << stats.bytes / ticks / welcome.tickTime / 1024.0 << "KB/s" << std::endl;
+		std::cout << "server:      " << stats.serverTickMilliseconds / snapshots << "ms per tick" << std::endl;
+		std::cout << "prediction:  " << (stats.predictions > 0 ? stats.predictionError / stats.predictions : 0.0) << " units off on average, "
+			<< stats.worstPredictionError << " worst, " << (stats.roundTrips > 0 ? stats.roundTripSeconds * 1000.0 / stats.roundTrips : 0.0) << "ms round trip, "
+			<< stats.worstRoundTrip * 1000.0f << "ms worst, drawn " << stats.interpolationTicks / ticks << " ticks behind the newest snapshot" << std::endl;
+		std::cout << "score:       " << mirror.score << ", highscore " << mirror.highscore << ", deaths " << mirror.deaths << ", "
+			<< mirror.enemies.Size() << " enemies and " << mirror.projectiles.Size() << " projectiles drawn, " << mirror.chunks.size() << " chunks" << std::endl;
+		if (stats.snapshots == 0)
+		{
+			std::cout << "no snapshots arrived" << std::endl;
+			return 1;
+		}
+		if (steadyAllocations.count > 0)
+		{
+			std::cout << "allocations: FAILED, " << steadyAllocations.count << " (" << steadyAllocations.bytes << " bytes) in "
+				<< allocatingTicks << " ticks after warming up, the first at tick " << firstAllocatingTick << std::endl;
+			return 1;
+		}
+		std::cout << "allocations: none after " << warmupTicks << " ticks of warming up" << std::endl;
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	unsigned long long tickCount = 36000;
+	std::string scriptPath = "";
+	std::string recordPath = "";
+	std::string replayPath = "";
+	std::string resumePath = "";
+	std::string snapshotPath = "";
+	SimulationSettings settings;
+	settings.seed = 1;
+	settings.printScore = false;
+	int threadCount = 0;
+	unsigned long long warmupTicks = 600;
+	int connectPort = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--ticks" && i + 1 < argc)
+			tickCount = strtoull(argv[++i], nullptr, 10);
+		else if (std::string(argv[i]) == "--script" && i + 1 < argc)
+			scriptPath = argv[++i];
+		else if (std::string(argv[i]) == "--seed" && i + 1 < argc)
+			settings.seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+		else if (std::string(argv[i]) == "--threads" && i + 1 < argc)
+			threadCount = atoi(argv[++i]);
+		else if (std::string(argv[i]) == "--flocking")
+			settings.flocking = true;
+		else if (std::string(argv[i]) == "--stress" && i + 1 < argc)
+			settings.stressEnemies = atoi(argv[++i]);
+		else if (std::string(argv[i]) == "--record" && i + 1 < argc)
+			recordPath = argv[++i];
+		else if (std::string(argv[i]) == "--replay" && i + 1 < argc)
+			replayPath = argv[++i];
+		else if (std::string(argv[i]) == "--warmup" && i + 1 < argc)
+			warmupTicks = strtoull(argv[++i], nullptr, 10);
+		else if (std::string(argv[i]) == "--resume" && i + 1 < argc)
+			resumePath = argv[++i];
+		else if (std::string(argv[i]) == "--snapshot" && i + 1 < argc)
+			snapshotPath = argv[++i];
+		else if (std::string(argv[i]) == "--connect" && i + 1 < argc)
+			connectPort = atoi(argv[++i]);
+	}
+	if (threadCount < 0)
+		threadCount = 0;
+	if (connectPort > 0)
+	{
+		//the world is the server's, so there is nothing here to record, replay or save
+		if (recordPath != "" || replayPath != "" || resumePath != "" || snapshotPath != "")
+		{
+			std::cout << "--connect can't be used with --record, --replay, --resume or --snapshot" << std::endl;
+			return 1;
+		}
+		return runClient((unsigned short)connectPort, tickCount, scriptPath, threadCount, warmupTicks);
+	}
+	if (settings.stressEnemies < 0)
+		settings.stressEnemies = 0;
+
+	//the game's default rate, a tick is a tick whatever rate it is simulated at
+	float tickTime = 1.0f / 60.0f;
+	std::unique_ptr<ReplayInput> replay;
+	if (replayPath != "")
+	{
+		replay.reset(new ReplayInput(replayPath));
+		if (!replay->IsLoaded())
+			return 1;
+		const ReplayHeader& header = replay->getHeader();
+		settings.seed = header.seed;
+		settings.flocking = header.flocking != 0;
+		settings.stressEnemies = header.stressEnemies;
+		settings.chunkRadius = header.chunkRadius;
+		tickTime = header.tickTime;
+	}
+	//recordings start from the seed, so they can't start from a snapshot
+	if (resumePath != "" && (replayPath != "" || recordPath != ""))
+	{
+		std::cout << "--resume can't be used with --record or --replay" << std::endl;
+		return 1;
+	}
+	std::unique_ptr<MappedFile> resumeFile;
+	if (resumePath != "")
+	{
+		resumeFile.reset(new MappedFile(resumePath));
+		SnapshotHeader header;
+		if (!resumeFile->IsOpen() || !Simulation::ReadSnapshotHeader(resumeFile->getData(), resumeFile->getSize(), header))
+		{
+			std::cout << "failed to load snapshot " << resumePath << std::endl;
+			return 1;
+		}
+		settings.seed = header.seed;
+		settings.flocking = header.flocking != 0;
+		settings.stressEnemies = header.stressEnemies;
+		settings.chunkRadius = header.chunkRadius;
+	}
+	JobSystem jobs(threadCount);
+	Simulation sim(settings, jobs);
+	if (resumeFile)
+	{
+		auto loadStart = std::chrono::high_resolution_clock::now();
+		if (!sim.LoadSnapshot(resumeFile->getData(), resumeFile->getSize()))
+		{
+			std::cout << "failed to load snapshot " << resumePath << std::endl;
+			return 1;
+		}
+		double loadTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - loadStart).count();
+		std::cout << "resumed:     tick " << sim.ticks << " from " << resumePath << " (" << resumeFile->getSize() << " bytes) in " << loadTime
+			<< "ms, state " << std::hex << sim.StateHash() << std::dec << std::endl;
+		resumeFile.reset();
+		//the script starts over, so its cursor is wherever it starts
+		sim.camera.ResetMouse();
+	}
+	ScriptedInput script(scriptPath);
+	InputSource* input = replay ? (InputSource*)replay.get() : &script;
+
+	std::unique_ptr<InputRecorder> recorder;
+	if (recordPath != "")
+	{
+		ReplayHeader header;
+		header.seed = settings.seed;
+		header.tickTime = tickTime;
+		header.flocking = settings.flocking ? 1 : 0;
+		header.stressEnemies = settings.stressEnemies;
+		header.chunkRadius = settings.chunkRadius;
+		recorder.reset(new InputRecorder(*input, recordPath, header));
+		if (!recorder->IsOpen())
+			return 1;
+		input = recorder.get();
+	}
+
+	unsigned int peakEnemies = 0, peakProjectiles = 0;
+	unsigned long long enemyTotal = 0, projectileTotal = 0;
+	//heap allocations once warmed up, and the first frame that made any
+	AllocationStats steadyAllocations;
+	unsigned long long allocatingFrames = 0, firstAllocatingTick = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	unsigned long long t = 0;
+	//a replay runs for as long as it was recorded, a script for --ticks
+	while (replay ? replay->NextFrame() : t < tickCount)
+	{
+		unsigned int frameTicks = replay ? replay->getFrameTicks() : 1;
+		AllocationStats frameStart = GetAllocationStats();
+		if (recorder)
+			recorder->NextFrame();
+		sim.Look(*input, tickTime);
+		for (unsigned int i = 0; i < frameTicks; i++, t++)
+		{
+			if (replay)
+				replay->NextTick();
+			if (recorder)
+				recorder->NextTick();
+			sim.Tick(*input, tickTime);
+			if (!replay)
+				script.Advance();
+
+			enemyTotal += sim.enemies.Size();
+			projectileTotal += sim.projectiles.Size();
+			if (sim.enemies.Size() > peakEnemies)
+				peakEnemies = sim.enemies.Size();
+			if (sim.projectiles.Size() > peakProjectiles)
+				peakProjectiles = sim.projectiles.Size();
+		}
+		if (recorder)
+			recorder->EndFrame(replay ? replay->getFrameAlpha() : 1.0f);
+
+		AllocationStats frameAllocations = AllocationsSince(frameStart);
+		if (t > warmupTicks && frameAllocations.count > 0)
+		{
+			if (allocatingFrames++ == 0)
+				firstAllocatingTick = t;
+			steadyAllocations.count += frameAllocations.count;
+			steadyAllocations.bytes += frameAllocations.bytes;
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	tickCount = t;
+
+	bool matches = true;
+	if (recorder)
+		recorder->Finish(sim.ticks, sim.StateHash());
+	if (replay)
+		matches = replay->Verify(sim.ticks, sim.StateHash());
+
+	if (snapshotPath != "")
+	{
+		//headless only saves once at the end, but it goes through the same writer as the game
+		SnapshotWriter writer;
+		auto saveStart = std::chrono::high_resolution_clock::now();
+		std::vector<unsigned char>& snapshot = writer.Begin();
+		sim.SaveSnapshot(snapshot);
+		size_t snapshotSize = snapshot.size();
+		writer.Write(snapshotPath);
+		double saveTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - saveStart).count();
+		if (!writer.Wait())
+			return 1;
+		std::cout << "snapshot:    tick " << sim.ticks << " to " << snapshotPath << " (" << snapshotSize << " bytes), " << saveTime
+			<< "ms before writing, state " << std::hex << sim.StateHash() << std::dec << std::endl;
+	}
+
+	unsigned int trees = 0;
+	for (unsigned int i = 0; i < sim.chunks.size(); i++)
+		trees += (unsigned int)sim.chunks[i].getTreePositions().size();
+	double ticks = (double)(tickCount > 0 ? tickCount : 1);
+	std::cout << tickCount << " ticks in " << seconds << "s, " << tickCount / seconds << " ticks per second ("
+		<< tickCount / seconds * tickTime << "x real time)" << std::endl;
+	std::cout << "enemies:     " << enemyTotal / ticks << " average, " << peakEnemies << " peak" << std::endl;
+	std::cout << "projectiles: " << projectileTotal / ticks << " average, " << peakProjectiles << " peak" << std::endl;
+	std::cout << "chunks:      " << sim.chunks.size() << " loaded, " << trees << " trees" << std::endl;
+	std::cout << "score:       " << sim.score << ", highscore " << sim.highscore << ", deaths " << sim.deaths << std::endl;
+	if (steadyAllocations.count > 0)
+	{
+		std::cout << "allocations: FAILED, " << steadyAllocations.count << " (" << steadyAllocations.bytes << " bytes) in "
+			<< allocatingFrames << " frames after warming up, the first at tick " << firstAllocatingTick << std::endl;
+		return 1;
+	}
+	std::cout << "allocations: none after " << warmupTicks << " ticks of warming up" << std::endl;
+	return matches ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+#include "impostor.h"
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+#include <iostream>
+
+#include "shader.h"
+#include "model.h"
+#include "camera.h"
+
+Impostor::Impostor(Model* model, int angles, int tileSize, float distance) : shader("vImpostor.vert", "fImpostor.frag")
+{
+	this->model = model;
+	this->angles = angles;
+	this->tileSize = tileSize;
+	this->distance = distance;
+
+	glm::vec3 boundsMin = model->getBoundsMin();
+	glm::vec3 boundsMax = model->getBoundsMax();
+	//the quad turns to face the camera so it must cover the model from every angle
+	halfWidth = glm::max(glm::length(glm::vec2(boundsMin.x, boundsMin.z)), glm::length(glm::vec2(boundsMax.x, boundsMax.z)));
+	bottom = boundsMin.y;
+	height = boundsMax.y - boundsMin.y;
+
+	glGenTextures(1, &atlasTexture);
+	glBindTexture(GL_TEXTURE_2D, atlasTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tileSize * angles, tileSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenRenderbuffers(1, &depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, tileSize * angles, tileSize);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &FBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, atlasTexture, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "impostor framebuffer is incomplete" << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	//per vertex: instance position, quad corner
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+	glBindVertexArray(0);
+}
+
+Impostor::~Impostor()
+{
+	glDeleteFramebuffers(1, &FBO);
+	glDeleteRenderbuffers(1, &depthBuffer);
+	glDeleteTextures(1, &atlasTexture);
+	glDeleteBuffers(1, &VBO);
+	glDeleteVertexArrays(1, &VAO);
+	model = nullptr;
+}
+
+void Impostor::Bake(Shader& objectShader)
+{
+	int viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	float clearColour[4];
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColour);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+	glViewport(0, 0, tileSize * angles, tileSize);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	//lit like the forest with no danger, Draw tints the result to follow the live lighting
+	objectShader.Use();
+	glUniform3fv(objectShader.Location("light.direction"), 1, &glm::vec3(-0.2f, -0.5f, -0.3f)[0]);
+	glUniform3fv(objectShader.Location("light.ambient"), 1, &glm::vec3(0.2f)[0]);
+	glUniform3fv(objectShader.Location("light.diffuse"), 1, &glm::vec3(0.5f)[0]);
+	glUniform3fv(objectShader.Location("light.specular"), 1, &glm::vec3(0.0f)[0]);
+	glUniform3fv(objectShader.Location("fogColor"), 1, &glm::vec3(0.0f)[0]);
+	float shininess = 5.0f;
+	glUniform1fv(objectShader.Location("shininess"), 1, &shininess);
+	glm::mat4 modelMatrix = glm::mat4(1.0f);
+	glUniformMatrix4fv(objectShader.Location("model"), 1, GL_FALSE, &modelMatrix[0][0]);
+	float orbit = model->getRadius() + 1.0f;
+	glm::mat4 projection = glm::ortho(-halfWidth, halfWidth, bottom, bottom + height, 0.1f, orbit * 2.0f);
+	glUniformMatrix4fv(objectShader.Location("projection"), 1, GL_FALSE, &projection[0][0]);
+
+	//tile i is the model seen from direction (cos, 0, sin) of angle i, orbiting at mid height
+	for (int i = 0; i < angles; i++)
+	{
+		float angle = glm::radians(360.0f * (float)i / (float)angles);
+		glm::vec3 eye = glm::vec3(cos(angle) * orbit, 0.0f, sin(angle) * orbit);
+		glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		glUniformMatrix4fv(objectShader.Location("view"), 1, GL_FALSE, &view[0][0]);
+		glUniform3fv(objectShader.Location("viewPos"), 1, &eye[0]);
+		glViewport(i * tileSize, 0, tileSize, tileSize);
+		model->Draw(objectShader);
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glBindTexture(GL_TEXTURE_2D, atlasTexture);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	glClearColor(clearColour[0], clearColour[1], clearColour[2], clearColour[3]);
+}
+
+float Impostor::getDistance()
+{
+	return distance;
+}
+
+void Impostor::Add(glm::vec3 position)
+{
+	instances.push_back(position);
+}
+
+void Impostor::Draw(Camera& camera, glm::mat4& view, glm::mat4& projection, glm::vec3 fogColour, glm::vec3 tint)
+{
+	instancesDrawn = (unsigned int)instances.size();
+	if (instances.empty())
+		return;
+
+	//two triangles per instance, the vertex shader turns and places the corners
+	const float corners[6][2] = { { -1.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { -1.0f, 0.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+	vertexData.resize(instances.size() * 6 * 5);
+	float* data = vertexData.data();
+	for (unsigned int i = 0; i < instances.size(); i++)
+	{
+		for (unsigned int j = 0; j < 6; j++)
+		{
+			*data++ = instances[i].x;
+			*data++ = instances[i].y;
+			*data++ = instances[i].z;
+			*data++ = corners[j][0];
+			*data++ = corners[j][1];
+		}
+	}
+
+	shader.Use();
+	glUniformMatrix4fv(shader.Location("view"), 1, GL_FALSE, &view[0][0]);
+	glUniformMatrix4fv(shader.Location("projection"), 1, GL_FALSE, &projection[0][0]);
+	glm::vec3 viewPos = camera.getPos();
+	glUniform3fv(shader.Location("viewPos"), 1, &viewPos[0]);
+	glUniform3fv(shader.Location("fogColor"), 1, &fogColour[0]);
+	glUniform3fv(shader.Location("tint"), 1, &tint[0]);
+	float renderDistance = camera.getDrawDistance();
+	glUniform1fv(shader.Location("renderDistance"), 1, &renderDistance);
+	glUniform1f(shader.Location("halfWidth"), halfWidth);
+	glUniform1f(shader.Location("bottom"), bottom);
+	glUniform1f(shader.Location("height"), height);
+	glUniform1i(shader.Location("angles"), angles);
+	glUniform1i(shader.Location("atlas"), 0);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, atlasTexture);
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	//orphan last frame's buffer rather than waiting on it
+	glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, vertexData.size() * sizeof(float), vertexData.data());
+	glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(instances.size() * 6));
+	glBindVertexArray(0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	instances.clear();
+}
+
+unsigned int Impostor::getInstancesDrawn()
+{
+	return instancesDrawn;
+}
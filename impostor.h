@@ -0,0 +1,49 @@
+#ifndef IMPOSTOR_H
+#define IMPOSTOR_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+
+#include "shader.h"
+#include "model.h"
+#include "camera.h"
+
+//a model pre rendered from a ring of angles into one atlas texture,
+//instances far from the camera are drawn as camera facing quads in a single batched draw
+class Impostor
+{
+public:
+	Impostor(Model* model, int angles, int tileSize, float distance);
+	~Impostor();
+	Impostor(const Impostor&) = delete;
+	Impostor& operator=(const Impostor&) = delete;
+
+	//renders the atlas using the normal object shader, restores the viewport and framebuffer after
+	void Bake(Shader& objectShader);
+	//instances closer than this are drawn as the real model
+	float getDistance();
+	void Add(glm::vec3 position);
+	//draws and clears every instance added since the last draw
+	void Draw(Camera& camera, glm::mat4& view, glm::mat4& projection, glm::vec3 fogColour, glm::vec3 tint);
+	unsigned int getInstancesDrawn();
+
+private:
+	Model* model;
+	Shader shader;
+	int angles;
+	int tileSize;
+	float distance;
+	float halfWidth;
+	float bottom, height;
+	unsigned int atlasTexture = 0, depthBuffer = 0, FBO = 0;
+	unsigned int VAO = 0, VBO = 0;
+	unsigned int instancesDrawn = 0;
+	std::vector<glm::vec3> instances;
+	std::vector<float> vertexData;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+//the controls the game reads, whatever is producing them
+enum class InputKey
+{
+	Forward,
+	Back,
+	Left,
+	Right,
+	Sprint,
+	Fire,
+	RegenerateChunks,
+	ToggleEnemies,
+};
+const unsigned int INPUT_KEY_COUNT = 8;
+
+//where the simulation gets its input from: the window when playing, a script when running headless
+class InputSource
+{
+public:
+	virtual ~InputSource() {}
+	virtual bool IsDown(InputKey key) = 0;
+	//absolute cursor position, the camera turns by how far it moved since last time
+	virtual void GetCursor(double& x, double& y) = 0;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include "inputRecorder.h"
+
+#include <iostream>
+#include <cstring>
+
+namespace
+{
+	//written to disk in blocks rather than a frame at a time
+	const size_t FLUSH_SIZE = 64 * 1024;
+}
+
+InputRecorder::InputRecorder(InputSource& source, const std::string& path, const ReplayHeader& header)
+	: source(&source), file(path, std::ios::binary)
+{
+	if (!file)
+	{
+		std::cout << "failed to open " << path << " for recording" << std::endl;
+		finished = true;
+		return;
+	}
+	buffer.reserve(FLUSH_SIZE * 2);
+	buffer.insert(buffer.end(), REPLAY_MAGIC, REPLAY_MAGIC + 4);
+	put(REPLAY_VERSION);
+	put(header.seed);
+	put(header.tickTime);
+	put(header.flocking);
+	put(header.stressEnemies);
+	put(header.chunkRadius);
+}
+
+InputRecorder::~InputRecorder()
+{
+	//a run that never finished still replays, it just has nothing to check the end state against
+	if (!finished)
+	{
+		buffer.push_back(FRAME_END);
+		put(0ull);
+		put(0ull);
+		flush();
+	}
+}
+
+bool InputRecorder::IsOpen()
+{
+	return file.is_open();
+}
+
+bool InputRecorder::IsDown(InputKey key)
+{
+	return (keys >> (unsigned int)key) & 1;
+}
+
+void InputRecorder::GetCursor(double& x, double& y)
+{
+	x = cursorX;
+	y = cursorY;
+}
+
+void InputRecorder::NextFrame()
+{
+	double x, y;
+	source->GetCursor(x, y);
+	if (x != cursorX || y != cursorY)
+		cursorMoved = true;
+	cursorX = x;
+	cursorY = y;
+	frameKeys.clear();
+}
+
+void InputRecorder::NextTick()
+{
+	keys = 0;
+	for (unsigned int i = 0; i < INPUT_KEY_COUNT; i++)
+		if (source->IsDown((InputKey)i))
+			keys |= 1 << i;
+	frameKeys.push_back(keys);
+}
+
+void InputRecorder::EndFrame(float alpha)
+{
+	if (finished)
+		return;
+	buffer.push_back(cursorMoved ? FRAME_CURSOR : 0);
+	if (cursorMoved)
+	{
+		put(cursorX);
+		put(cursorY);
+		cursorMoved = false;
+	}
+	put(alpha);
+	putVarint(frameKeys.size());
+	buffer.insert(buffer.end(), frameKeys.begin(), frameKeys.end());
+	if (buffer.size() >= FLUSH_SIZE)
+		flush();
+}
+
+void InputRecorder::Finish(unsigned long long ticks, unsigned long long stateHash)
+{
+	if (finished)
+		return;
+	buffer.push_back(FRAME_END);
+	put(ticks);
+	put(stateHash);
+	flush();
+	file.close();
+	finished = true;
+}
+
+template <typename T>
+void InputRecorder::put(const T& value)
+{
+	unsigned char bytes[sizeof(T)];
+	memcpy(bytes, &value, sizeof(T));
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+void InputRecorder::putVarint(unsigned long long value)
+{
+	//7 bits a byte, the top bit says another byte follows. a frame is nearly always a single byte
+	while (value >= 0x80)
+	{
+		buffer.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	buffer.push_back((unsigned char)value);
+}
+
+void InputRecorder::flush()
+{
+	if (!buffer.empty() && file)
+		file.write((const char*)buffer.data(), buffer.size());
+	buffer.clear();
+}
@@ -0,0 +1,47 @@
+#ifndef INPUT_RECORDER_H
+#define INPUT_RECORDER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "input.h"
+#include "replayFile.h"
+
+//passes another input source through to the simulation and writes down what it gave, so the run can be
+//replayed exactly. the keys are read once per tick and the cursor once per frame, so the simulation sees
+//exactly what is recorded even if the source changes in between
+class InputRecorder : public InputSource
+{
+public:
+	InputRecorder(InputSource& source, const std::string& path, const ReplayHeader& header);
+	~InputRecorder();
+	bool IsOpen();
+	bool IsDown(InputKey key) override;
+	void GetCursor(double& x, double& y) override;
+	//call at the start of each frame, before the simulation looks around
+	void NextFrame();
+	//call before each tick
+	void NextTick();
+	//call once the frame's ticks have run, alpha is what the frame was drawn at
+	void EndFrame(float alpha);
+	//writes the end of the file with the state the run finished in, which the replay checks against
+	void Finish(unsigned long long ticks, unsigned long long stateHash);
+private:
+	InputSource* source;
+	std::ofstream file;
+	std::vector<unsigned char> buffer;
+	std::vector<unsigned char> frameKeys;
+
+	unsigned char keys = 0;
+	double cursorX = 0.0, cursorY = 0.0;
+	bool cursorMoved = true;
+	bool finished = false;
+
+	template <typename T>
+	void put(const T& value);
+	void putVarint(unsigned long long value);
+	void flush();
+};
+
+#endif
@@ -0,0 +1,247 @@
+#include "jobSystem.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+	const size_t SCRATCH_SIZE = 256 * 1024;
+	//tasks a queue holds before it has to grow
+	const size_t QUEUE_SIZE = 256;
+	//index of the worker the calling thread is, threads outside the pool count as worker 0
+	thread_local unsigned int workerIndex = 0;
+}
+
+JobSystem::JobSystem(unsigned int workerCount)
+{
+	if (workerCount == 0)
+		workerCount = std::thread::hardware_concurrency();
+	if (workerCount == 0)
+		workerCount = 1;
+	for (unsigned int i = 0; i < workerCount; i++)
+	{
+		queues.emplace_back(new WorkerQueue());
+		queues.back()->tasks.resize(QUEUE_SIZE);
+		scratch.emplace_back(SCRATCH_SIZE);
+	}
+	for (unsigned int i = 1; i < workerCount; i++)
+		threads.emplace_back(&JobSystem::workerLoop, this, i);
+	std::cout << "job system: " << workerCount << " workers" << std::endl;
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> guard(sleepLock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (unsigned int i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+JobHandle JobSystem::Schedule(std::function<void(unsigned int worker)> work, std::vector<JobHandle> dependencies)
+{
+	JobHandle job = std::make_shared<Job>();
+	job->work = std::move(work);
+	//held until every dependency is registered so a dependency finishing part way can't start it early
+	job->waitingOn = 1;
+	for (unsigned int i = 0; i < dependencies.size(); i++)
+	{
+		std::lock_guard<std::mutex> guard(dependencies[i]->lock);
+		if (!dependencies[i]->finished)
+		{
+			job->waitingOn++;
+			dependencies[i]->dependents.push_back(job);
+		}
+	}
+	if (--job->waitingOn == 0)
+	{
+		Task task;
+		task.job = job;
+		push(currentWorker(), std::move(task));
+	}
+	return job;
+}
+
+void JobSystem::Wait(const JobHandle& job)
+{
+	unsigned int worker = currentWorker();
+	while (!job->finished)
+	{
+		if (!runOne(worker))
+			std::this_thread::yield();
+	}
+}
+
+unsigned int JobSystem::RangeCount(unsigned int count, unsigned int grainSize)
+{
+	if (grainSize == 0)
+		grainSize = 1;
+	return (count + grainSize - 1) / grainSize;
+}
+
+void JobSystem::parallelFor(unsigned int count, unsigned int grainSize, const RangeCall& body)
+{
+	if (count == 0)
+		return;
+	if (grainSize == 0)
+		grainSize = 1;
+	unsigned int worker = currentWorker();
+	unsigned int ranges = RangeCount(count, grainSize);
+	if (queues.size() == 1 || ranges == 1)
+	{
+		for (unsigned int begin = 0; begin < count; begin += grainSize)
+			body(begin, begin + grainSize < count ? begin + grainSize : count, worker);
+		return;
+	}
+	std::atomic<unsigned int> remaining{ ranges };
+	//pushed last range first, the owner pops from the back so it works through them in order
+	//while thieves take the far end
+	for (unsigned int r = ranges; r-- > 0;)
+	{
+		Task task;
+		task.body = &body;
+		task.begin = r * grainSize;
+		task.end = task.begin + grainSize < count ? task.begin + grainSize : count;
+		task.remaining = &remaining;
+		push(worker, std::move(task));
+	}
+	while (remaining.load(std::memory_order_acquire) > 0)
+	{
+		if (!runOne(worker))
+			std::this_thread::yield();
+	}
+}
+
+unsigned int JobSystem::getWorkerCount()
+{
+	return (unsigned int)queues.size();
+}
+
+LinearAllocator& JobSystem::Scratch(unsigned int worker)
+{
+	return scratch[worker];
+}
+
+void JobSystem::ResetScratch()
+{
+	for (unsigned int i = 0; i < scratch.size(); i++)
+		scratch[i].Reset();
+}
+
+void JobSystem::push(unsigned int worker, Task&& task)
+{
+	{
+		std::lock_guard<std::mutex> guard(queues[worker]->lock);
+		queues[worker]->PushBack(std::move(task));
+	}
+	queuedTasks++;
+	wake.notify_one();
+}
+
+bool JobSystem::runOne(unsigned int worker)
+{
+	Task task;
+	bool found = false;
+	{
+		std::lock_guard<std::mutex> guard(queues[worker]->lock);
+		if (queues[worker]->count > 0)
+		{
+			task = queues[worker]->PopBack();
+			found = true;
+		}
+	}
+	for (unsigned int i = 1; i < queues.size() && !found; i++)
+	{
+		WorkerQueue& victim = *queues[(worker + i) % queues.size()];
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if (victim.count > 0)
+		{
+			task = victim.PopFront();
+			found = true;
+		}
+	}
+	if (!found)
+		return false;
+	queuedTasks--;
+
+	if (task.job)
+	{
+		task.job->work(worker);
+		finish(task.job);
+	}
+	else
+	{
+		(*task.body)(task.begin, task.end, worker);
+		task.remaining->fetch_sub(1, std::memory_order_release);
+	}
+	return true;
+}
+
+void JobSystem::finish(const JobHandle& job)
+{
+	std::vector<JobHandle> ready;
+	{
+		std::lock_guard<std::mutex> guard(job->lock);
+		job->finished = true;
+		ready.swap(job->dependents);
+	}
+	unsigned int worker = currentWorker();
+	for (unsigned int i = 0; i < ready.size(); i++)
+	{
+		if (--ready[i]->waitingOn == 0)
+		{
+			Task task;
+			task.job = ready[i];
+			push(worker, std::move(task));
+		}
+	}
+}
+
+void JobSystem::workerLoop(unsigned int worker)
+{
+	workerIndex = worker;
+	while (!stopping)
+	{
+		if (runOne(worker))
+			continue;
+		//the timeout covers a push that lands between the check and the wait
+		std::unique_lock<std::mutex> guard(sleepLock);
+		wake.wait_for(guard, std::chrono::milliseconds(1), [this] { return queuedTasks > 0 || stopping; });
+	}
+}
+
+unsigned int JobSystem::currentWorker()
+{
+	return workerIndex;
+}
+
+void JobSystem::WorkerQueue::PushBack(Task&& task)
+{
+	if (count == tasks.size())
+	{
+		//unwrap into a buffer twice the size
+		std::vector<Task> grown(tasks.size() * 2);
+		for (size_t i = 0; i < count; i++)
+			grown[i] = std::move(tasks[(head + i) % tasks.size()]);
+		tasks.swap(grown);
+		head = 0;
+	}
+	tasks[(head + count) % tasks.size()] = std::move(task);
+	count++;
+}
+
+JobSystem::Task JobSystem::WorkerQueue::PopBack()
+{
+	count--;
+	return std::move(tasks[(head + count) % tasks.size()]);
+}
+
+JobSystem::Task JobSystem::WorkerQueue::PopFront()
+{
+	Task task = std::move(tasks[head]);
+	head = (head + 1) % tasks.size();
+	count--;
+	return task;
+}
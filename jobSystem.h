@@ -0,0 +1,109 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "linearAllocator.h"
+
+struct Job;
+typedef std::shared_ptr<Job> JobHandle;
+
+//a ParallelFor body without taking a copy of it, so any lambda can be passed without going to the heap
+struct RangeCall
+{
+	void (*invoke)(const void* body, unsigned int begin, unsigned int end, unsigned int worker);
+	const void* body;
+	void operator()(unsigned int begin, unsigned int end, unsigned int worker) const
+	{
+		invoke(body, begin, end, worker);
+	}
+};
+
+//a job runs once every job it depends on has finished, worker is the index of the thread running it
+struct Job
+{
+	std::function<void(unsigned int worker)> work;
+	std::atomic<int> waitingOn{ 0 };
+	std::atomic<bool> finished{ false };
+	std::mutex lock;
+	std::vector<JobHandle> dependents;
+};
+
+//work stealing thread pool. each worker takes work from the back of its own queue and
+//steals from the front of the others when it runs dry. the thread that creates the pool
+//is worker 0, it has no thread of its own and runs jobs while it waits on them
+class JobSystem
+{
+public:
+	//0 uses one worker per hardware thread
+	JobSystem(unsigned int workerCount = 0);
+	~JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	JobHandle Schedule(std::function<void(unsigned int worker)> work, std::vector<JobHandle> dependencies = {});
+	void Wait(const JobHandle& job);
+	//splits [0, count) into ranges of grainSize and returns once all of them have run.
+	//the split only depends on count and grainSize, so results kept per range and combined
+	//in range order are the same with any number of workers. body is called as body(begin, end, worker)
+	template <typename Body>
+	void ParallelFor(unsigned int count, unsigned int grainSize, const Body& body)
+	{
+		RangeCall call;
+		call.invoke = [](const void* body, unsigned int begin, unsigned int end, unsigned int worker)
+		{
+			(*static_cast<const Body*>(body))(begin, end, worker);
+		};
+		call.body = &body;
+		parallelFor(count, grainSize, call);
+	}
+	static unsigned int RangeCount(unsigned int count, unsigned int grainSize);
+
+	unsigned int getWorkerCount();
+	//scratch memory only touched by one worker, valid until ResetScratch
+	LinearAllocator& Scratch(unsigned int worker);
+	//call when no jobs are running, e.g. once per tick
+	void ResetScratch();
+private:
+	struct Task
+	{
+		JobHandle job;
+		const RangeCall* body = nullptr;
+		unsigned int begin = 0, end = 0;
+		std::atomic<unsigned int>* remaining = nullptr;
+	};
+	//a ring buffer rather than a deque, it only grows when full so pushing and popping never allocate
+	struct WorkerQueue
+	{
+		std::mutex lock;
+		std::vector<Task> tasks;
+		size_t head = 0, count = 0;
+
+		void PushBack(Task&& task);
+		Task PopBack();
+		Task PopFront();
+	};
+
+	void parallelFor(unsigned int count, unsigned int grainSize, const RangeCall& body);
+	void push(unsigned int worker, Task&& task);
+	bool runOne(unsigned int worker);
+	void finish(const JobHandle& job);
+	void workerLoop(unsigned int worker);
+	unsigned int currentWorker();
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::vector<LinearAllocator> scratch;
+	std::vector<std::thread> threads;
+	std::atomic<int> queuedTasks{ 0 };
+	std::atomic<bool> stopping{ false };
+	std::mutex sleepLock;
+	std::condition_variable wake;
+};
+
+#endif
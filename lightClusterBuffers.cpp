@@ -0,0 +1,96 @@
+#include "lightClusterBuffers.h"
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cmath>
+
+namespace
+{
+	enum ClusterBuffer { LIGHTS = 0, RANGES = 1, INDICES = 2 };
+}
+
+LightClusterBuffers::LightClusterBuffers(LightClusters& clusters)
+{
+	unsigned int clusterCount = (unsigned int)(clusters.getTilesX() * clusters.getTilesY() * clusters.getSlices());
+	capacities[LIGHTS] = clusters.getMaxLights() * 2 * sizeof(glm::vec4);
+	capacities[RANGES] = clusterCount * 2 * sizeof(unsigned int);
+	capacities[INDICES] = clusters.getMaxIndices() * sizeof(unsigned short);
+	const GLenum formats[3] = { GL_RGBA32F, GL_RG32UI, GL_R16UI };
+	lightData.reserve(clusters.getMaxLights() * 2);
+
+	glGenBuffers(3, buffers);
+	glGenTextures(3, textures);
+	for (int i = 0; i < 3; i++)
+	{
+		glBindBuffer(GL_TEXTURE_BUFFER, buffers[i]);
+		glBufferData(GL_TEXTURE_BUFFER, capacities[i], NULL, GL_STREAM_DRAW);
+		glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+		glTexBuffer(GL_TEXTURE_BUFFER, formats[i], buffers[i]);
+	}
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+LightClusterBuffers::~LightClusterBuffers()
+{
+	glDeleteTextures(3, textures);
+	glDeleteBuffers(3, buffers);
+}
+
+void LightClusterBuffers::upload(int buffer, const void* data, size_t size)
+{
+	glBindBuffer(GL_TEXTURE_BUFFER, buffers[buffer]);
+	//orphaned first, so the driver can hand over fresh memory instead of waiting on last frame's draws
+	glBufferData(GL_TEXTURE_BUFFER, capacities[buffer], NULL, GL_STREAM_DRAW);
+	if (size > 0)
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+	uploadBytes += size;
+}
+
+void LightClusterBuffers::Upload(LightClusters& clusters)
+{
+	uploadBytes = 0;
+	const std::vector<PointLight>& lights = clusters.getLights();
+	lightData.clear();
+	for (const PointLight& light : lights)
+	{
+		lightData.push_back(glm::vec4(light.position, light.radius));
+		lightData.push_back(glm::vec4(light.colour, 0.0f));
+	}
+	upload(LIGHTS, lightData.data(), lightData.size() * sizeof(glm::vec4));
+	upload(RANGES, clusters.getClusterRanges().data(), clusters.getClusterRanges().size() * sizeof(unsigned int));
+	upload(INDICES, clusters.getIndices().data(), clusters.getIndices().size() * sizeof(unsigned short));
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusterBuffers::Bind(Shader& shader, LightClusters& clusters, int viewportWidth, int viewportHeight, bool enabled)
+{
+	glUniform1i(shader.Location("pointLights"), enabled ? 1 : 0);
+	//the samplers are given their units even when unused, two kinds of sampler can't share unit 0
+	glUniform1i(shader.Location("lightData"), LIGHT_UNIT);
+	glUniform1i(shader.Location("clusterRanges"), RANGE_UNIT);
+	glUniform1i(shader.Location("lightIndices"), INDEX_UNIT);
+	const int units[3] = { LIGHT_UNIT, RANGE_UNIT, INDEX_UNIT };
+	for (int i = 0; i < 3; i++)
+	{
+		glActiveTexture(GL_TEXTURE0 + units[i]);
+		glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+	}
+	glActiveTexture(GL_TEXTURE0);
+
+	glm::vec2 tileScale((float)clusters.getTilesX() / viewportWidth, (float)clusters.getTilesY() / viewportHeight);
+	glUniform2fv(shader.Location("clusterTileScale"), 1, &tileScale[0]);
+	glUniform3i(shader.Location("clusterCounts"), clusters.getTilesX(), clusters.getTilesY(), clusters.getSlices());
+	glm::vec2 depth(clusters.getSlices() / std::log(clusters.getFarPlane() / clusters.getNearPlane()), clusters.getNearPlane());
+	glUniform2fv(shader.Location("clusterDepth"), 1, &depth[0]);
+	glm::vec3 forward = clusters.getViewForward();
+	glUniform3fv(shader.Location("viewForward"), 1, &forward[0]);
+}
+
+size_t LightClusterBuffers::getUploadBytes()
+{
+	return uploadBytes;
+}
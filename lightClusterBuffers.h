@@ -0,0 +1,48 @@
+#ifndef LIGHT_CLUSTER_BUFFERS_H
+#define LIGHT_CLUSTER_BUFFERS_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstddef>
+
+#include "shader.h"
+#include "lightClusters.h"
+
+//the gl side of LightClusters. its lights, each cluster's offset and count, and the packed light lists
+//go in three texture buffers that fShader.frag reads, sized for the most clusters can hold so
+//uploading never reallocates them
+class LightClusterBuffers
+{
+public:
+	LightClusterBuffers(LightClusters& clusters);
+	~LightClusterBuffers();
+	LightClusterBuffers(const LightClusterBuffers&) = delete;
+	LightClusterBuffers& operator=(const LightClusterBuffers&) = delete;
+
+	//copies what the last Build made to the gpu
+	void Upload(LightClusters& clusters);
+	//binds the buffers and sets the uniforms that find a fragment's cluster. with enabled false the
+	//shader skips point lights altogether
+	void Bind(Shader& shader, LightClusters& clusters, int viewportWidth, int viewportHeight, bool enabled);
+	//bytes sent by the last Upload
+	size_t getUploadBytes();
+private:
+	//after the few the models' own textures use
+	static const int LIGHT_UNIT = 8;
+	static const int RANGE_UNIT = 9;
+	static const int INDEX_UNIT = 10;
+
+	unsigned int buffers[3] = { 0, 0, 0 };
+	unsigned int textures[3] = { 0, 0, 0 };
+	size_t capacities[3] = { 0, 0, 0 };
+	//two texels a light: position and radius, then colour
+	std::vector<glm::vec4> lightData;
+	size_t uploadBytes = 0;
+
+	void upload(int buffer, const void* data, size_t size);
+};
+
+#endif
@@ -0,0 +1,233 @@
+#include "lightClusters.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+LightClusters::LightClusters(int tilesX, int tilesY, int slices, unsigned int maxLights, unsigned int maxIndices)
+	: tilesX(tilesX), tilesY(tilesY), slices(slices), maxLights(maxLights), maxIndices(maxIndices)
+{
+	unsigned int clusterCount = (unsigned int)(tilesX * tilesY * slices);
+	//more lights are taken than kept so the nearest can be picked from them
+	candidates.reserve(maxLights * 4);
+	lights.reserve(maxLights);
+	coverMin.reserve(maxLights);
+	coverMax.reserve(maxLights);
+	counts.resize(clusterCount, 0);
+	ranges.resize(clusterCount * 2, 0);
+	indices.reserve(maxIndices);
+}
+
+void LightClusters::Begin(const glm::mat4& view, const glm::mat4& projection, glm::vec3 eye)
+{
+	this->view = view;
+	this->eye = eye;
+	//everything glm::perspective was given can be read back out of its matrix
+	tanHalfX = 1.0f / projection[0][0];
+	tanHalfY = 1.0f / projection[1][1];
+	nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+	farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+	sliceScale = slices / std::log(farPlane / nearPlane);
+	candidates.clear();
+	droppedLights = 0;
+}
+
+void LightClusters::Add(const PointLight& light)
+{
+	if (candidates.size() == candidates.capacity())
+	{
+		droppedLights++;
+		return;
+	}
+	candidates.push_back({ light, glm::distance(light.position, eye) - light.radius });
+}
+
+int LightClusters::sliceAt(float depth) const
+{
+	if (depth <= nearPlane)
+		return 0;
+	int slice = (int)std::floor(std::log(depth / nearPlane) * sliceScale);
+	return std::min(std::max(slice, 0), slices - 1);
+}
+
+bool LightClusters::cover(const PointLight& light, glm::ivec3& minCluster, glm::ivec3& maxCluster) const
+{
+	glm::vec4 viewPos = view * glm::vec4(light.position, 1.0f);
+	float depth = -viewPos.z;
+	if (depth + light.radius < nearPlane || depth - light.radius > farPlane)
+		return false;
+	float nearDepth = std::max(depth - light.radius, nearPlane);
+	float farDepth = std::min(depth + light.radius, farPlane);
+
+	//the sphere's box in view space, cut off at the near plane. x / depth is smallest and largest at
+	//its corners, so projecting them bounds everything the sphere covers on screen
+	float ndcMin[2] = { 2.0f, 2.0f }, ndcMax[2] = { -2.0f, -2.0f };
+	const float centre[2] = { viewPos.x, viewPos.y };
+	const float tanHalf[2] = { tanHalfX, tanHalfY };
+	for (int axis = 0; axis < 2; axis++)
+	{
+		for (float side : { -light.radius, light.radius })
+		{
+			for (float cornerDepth : { nearDepth, farDepth })
+			{
+				float ndc = (centre[axis] + side) / (cornerDepth * tanHalf[axis]);
+				ndcMin[axis] = std::min(ndcMin[axis], ndc);
+				ndcMax[axis] = std::max(ndcMax[axis], ndc);
+			}
+		}
+		if (ndcMax[axis] < -1.0f || ndcMin[axis] > 1.0f)
+			return false;
+	}
+	const int tiles[2] = { tilesX, tilesY };
+	int low[2], high[2];
+	for (int axis = 0; axis < 2; axis++)
+	{
+		low[axis] = (int)std::floor((std::max(ndcMin[axis], -1.0f) * 0.5f + 0.5f) * tiles[axis]);
+		high[axis] = (int)std::floor((std::min(ndcMax[axis], 1.0f) * 0.5f + 0.5f) * tiles[axis]);
+		low[axis] = std::min(std::max(low[axis], 0), tiles[axis] - 1);
+		high[axis] = std::min(std::max(high[axis], 0), tiles[axis] - 1);
+	}
+	minCluster = glm::ivec3(low[0], low[1], sliceAt(nearDepth));
+	maxCluster = glm::ivec3(high[0], high[1], sliceAt(farDepth));
+	return true;
+}
+
+void LightClusters::Build()
+{
+	lights.clear();
+	coverMin.clear();
+	coverMax.clear();
+	std::fill(counts.begin(), counts.end(), 0);
+	droppedIndices = 0;
+	maxClusterLights = 0;
+
+	//nearest first, so the lights kept and the order of every cluster's list favour the ones that show most
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.distance < b.distance; });
+	glm::ivec3 minCluster, maxCluster;
+	for (unsigned int i = 0; i < candidates.size(); i++)
+	{
+		if (!cover(candidates[i].light, minCluster, maxCluster))
+			continue;
+		if (lights.size() == maxLights)
+		{
+			droppedLights++;
+			continue;
+		}
+		lights.push_back(candidates[i].light);
+		coverMin.push_back(minCluster);
+		coverMax.push_back(maxCluster);
+		for (int s = minCluster.z; s <= maxCluster.z; s++)
+			for (int y = minCluster.y; y <= maxCluster.y; y++)
+				for (int x = minCluster.x; x <= maxCluster.x; x++)
+					counts[(s * tilesY + y) * tilesX + x]++;
+	}
+
+	//each cluster's list starts where the last ended, once the index buffer is full the rest get nothing
+	unsigned int offset = 0;
+	for (unsigned int c = 0; c < counts.size(); c++)
+	{
+		unsigned int count = std::min(counts[c], maxIndices - offset);
+		droppedIndices += counts[c] - count;
+		ranges[c * 2] = offset;
+		ranges[c * 2 + 1] = count;
+		offset += count;
+		maxClusterLights = std::max(maxClusterLights, count);
+		counts[c] = 0;
+	}
+	indices.resize(offset);
+	for (unsigned int l = 0; l < lights.size(); l++)
+	{
+		for (int s = coverMin[l].z; s <= coverMax[l].z; s++)
+		{
+			for (int y = coverMin[l].y; y <= coverMax[l].y; y++)
+			{
+				for (int x = coverMin[l].x; x <= coverMax[l].x; x++)
+				{
+					unsigned int c = (s * tilesY + y) * tilesX + x;
+					if (counts[c] < ranges[c * 2 + 1])
+						indices[ranges[c * 2] + counts[c]++] = (unsigned short)l;
+				}
+			}
+		}
+	}
+}
+
+int LightClusters::ClusterAt(float ndcX, float ndcY, float depth) const
+{
+	if (ndcX < -1.0f || ndcX > 1.0f || ndcY < -1.0f || ndcY > 1.0f || depth < nearPlane || depth > farPlane)
+		return -1;
+	int x = std::min((int)std::floor((ndcX * 0.5f + 0.5f) * tilesX), tilesX - 1);
+	int y = std::min((int)std::floor((ndcY * 0.5f + 0.5f) * tilesY), tilesY - 1);
+	return (sliceAt(depth) * tilesY + y) * tilesX + x;
+}
+
+int LightClusters::getTilesX()
+{
+	return tilesX;
+}
+
+int LightClusters::getTilesY()
+{
+	return tilesY;
+}
+
+int LightClusters::getSlices()
+{
+	return slices;
+}
+
+unsigned int LightClusters::getMaxLights()
+{
+	return maxLights;
+}
+
+unsigned int LightClusters::getMaxIndices()
+{
+	return maxIndices;
+}
+
+float LightClusters::getNearPlane()
+{
+	return nearPlane;
+}
+
+float LightClusters::getFarPlane()
+{
+	return farPlane;
+}
+
+glm::vec3 LightClusters::getViewForward()
+{
+	return -glm::vec3(view[0][2], view[1][2], view[2][2]);
+}
+
+const std::vector<PointLight>& LightClusters::getLights()
+{
+	return lights;
+}
+
+const std::vector<unsigned int>& LightClusters::getClusterRanges()
+{
+	return ranges;
+}
+
+const std::vector<unsigned short>& LightClusters::getIndices()
+{
+	return indices;
+}
+
+unsigned int LightClusters::getDroppedLights()
+{
+	return droppedLights;
+}
+
+unsigned int LightClusters::getDroppedIndices()
+{
+	return droppedIndices;
+}
+
+unsigned int LightClusters::getMaxClusterLights()
+{
+	return maxClusterLights;
+}
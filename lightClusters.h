@@ -0,0 +1,84 @@
+#ifndef LIGHT_CLUSTERS_H
+#define LIGHT_CLUSTERS_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+//a point light, it fades out to nothing at radius
+struct PointLight
+{
+	glm::vec3 position;
+	float radius;
+	glm::vec3 colour;
+};
+
+//sorts point lights into clusters for clustered forward shading. the view is split into a grid of
+//screen tiles and depth slices, the slices getting thicker further away, and each cluster gets a list
+//of the lights whose sphere reaches it. a fragment then only lights itself with its own cluster's list
+//instead of every light. the lists are packed one after another in cluster order, with an offset and
+//count per cluster. when there are more lights than fit, the ones nearest the eye are kept.
+//it has no gl, LightClusterBuffers uploads the result
+class LightClusters
+{
+public:
+	//light indices are 16 bit, so maxLights can be at most 65536
+	LightClusters(int tilesX = 16, int tilesY = 9, int slices = 24, unsigned int maxLights = 1024, unsigned int maxIndices = 65536);
+
+	//starts a new frame seen from eye through view and a perspective projection
+	void Begin(const glm::mat4& view, const glm::mat4& projection, glm::vec3 eye);
+	//lights past the first maxLights * 4 in a frame are ignored
+	void Add(const PointLight& light);
+	//picks the lights to keep and fills the cluster lists
+	void Build();
+
+	//cluster a point in view space is in, with depth the distance in front of the eye, -1 if outside
+	int ClusterAt(float ndcX, float ndcY, float depth) const;
+
+	int getTilesX();
+	int getTilesY();
+	int getSlices();
+	unsigned int getMaxLights();
+	unsigned int getMaxIndices();
+	float getNearPlane();
+	float getFarPlane();
+	//the view direction, a point's depth is its distance along it from the eye
+	glm::vec3 getViewForward();
+	const std::vector<PointLight>& getLights();
+	//offset and count into getIndices for each cluster, x fastest then y then slice
+	const std::vector<unsigned int>& getClusterRanges();
+	const std::vector<unsigned short>& getIndices();
+	//lights added but not kept, and cluster entries that didn't fit, in the last Build
+	unsigned int getDroppedLights();
+	unsigned int getDroppedIndices();
+	unsigned int getMaxClusterLights();
+private:
+	struct Candidate
+	{
+		PointLight light;
+		float distance;
+	};
+
+	int tilesX, tilesY, slices;
+	unsigned int maxLights, maxIndices;
+	glm::mat4 view = glm::mat4(1.0f);
+	glm::vec3 eye = glm::vec3(0.0f);
+	float tanHalfX = 1.0f, tanHalfY = 1.0f;
+	float nearPlane = 0.1f, farPlane = 100.0f;
+	//slice = log(depth / near) * sliceScale
+	float sliceScale = 1.0f;
+
+	std::vector<Candidate> candidates;
+	std::vector<PointLight> lights;
+	//the clusters each kept light covers, as a box of tiles and slices
+	std::vector<glm::ivec3> coverMin, coverMax;
+	std::vector<unsigned int> counts;
+	std::vector<unsigned int> ranges;
+	std::vector<unsigned short> indices;
+	unsigned int droppedLights = 0, droppedIndices = 0, maxClusterLights = 0;
+
+	int sliceAt(float depth) const;
+	bool cover(const PointLight& light, glm::ivec3& minCluster, glm::ivec3& maxCluster) const;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#include "linearAllocator.h"
+
+#include <cstdint>
+
+LinearAllocator::LinearAllocator(size_t capacity)
+{
+	this->capacity = capacity;
+	buffer.reset(new unsigned char[capacity]);
+}
+
+void* LinearAllocator::Allocate(size_t size, size_t alignment)
+{
+	uintptr_t base = reinterpret_cast<uintptr_t>(buffer.get());
+	uintptr_t aligned = (base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	size_t end = (size_t)(aligned - base) + size;
+	if (end <= capacity)
+	{
+		offset = end;
+		if (offset + overflowBytes > highWater)
+			highWater = offset + overflowBytes;
+		return reinterpret_cast<void*>(aligned);
+	}
+	//new[] is aligned for any fundamental type, over aligned requests get padded
+	overflow.emplace_back(new unsigned char[size + alignment]);
+	overflowBytes += size + alignment;
+	if (offset + overflowBytes > highWater)
+		highWater = offset + overflowBytes;
+	uintptr_t block = reinterpret_cast<uintptr_t>(overflow.back().get());
+	return reinterpret_cast<void*>((block + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+void LinearAllocator::Reset()
+{
+	if (overflow.size() > 0)
+	{
+		overflow.clear();
+		capacity = highWater;
+		buffer.reset(new unsigned char[capacity]);
+	}
+	offset = 0;
+	overflowBytes = 0;
+}
+
+size_t LinearAllocator::getUsed()
+{
+	return offset + overflowBytes;
+}
+
+size_t LinearAllocator::getCapacity()
+{
+	return capacity;
+}
+
+size_t LinearAllocator::getHighWater()
+{
+	return highWater;
+}
@@ -0,0 +1,42 @@
+#ifndef LINEAR_ALLOCATOR_H
+#define LINEAR_ALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+//bump allocator for short lived scratch memory, everything is freed at once by Reset.
+//nothing allocated from it has its destructor run, so only use it for plain data.
+//if it runs out, the extra memory comes from the heap until the next Reset, which then
+//grows the buffer so the same amount fits next time
+class LinearAllocator
+{
+public:
+	LinearAllocator(size_t capacity);
+	LinearAllocator(const LinearAllocator&) = delete;
+	LinearAllocator& operator=(const LinearAllocator&) = delete;
+	LinearAllocator(LinearAllocator&&) = default;
+	LinearAllocator& operator=(LinearAllocator&&) = default;
+
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+	template <typename T>
+	T* Allocate(size_t count)
+	{
+		return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+	}
+	void Reset();
+
+	size_t getUsed();
+	size_t getCapacity();
+	//most memory used between two resets, overflow included
+	size_t getHighWater();
+private:
+	std::unique_ptr<unsigned char[]> buffer;
+	size_t capacity;
+	size_t offset = 0;
+	size_t overflowBytes = 0;
+	size_t highWater = 0;
+	std::vector<std::unique_ptr<unsigned char[]>> overflow;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#include "lod.h"
+
+#include <vector>
+
+int SelectLod(const LodSettings& settings, float screenSize, int currentLod, int lodCount)
+{
+	int maxLod = lodCount - 1;
+	if (maxLod > (int)settings.screenSizes.size())
+		maxLod = (int)settings.screenSizes.size();
+	if (maxLod <= 0)
+		return 0;
+
+	screenSize *= settings.bias;
+	int lod = currentLod;
+	if (lod < 0)
+		lod = 0;
+	if (lod > maxLod)
+		lod = maxLod;
+	while (lod < maxLod && screenSize < settings.screenSizes[lod] * (1.0f - settings.hysteresis))
+		lod++;
+	while (lod > 0 && screenSize > settings.screenSizes[lod - 1] * (1.0f + settings.hysteresis))
+		lod--;
+	return lod;
+}
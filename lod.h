@@ -0,0 +1,19 @@
+#ifndef LOD_H
+#define LOD_H
+
+#include <vector>
+
+struct LodSettings
+{
+	//screen size (fraction of the screen height) below which each lod switches to the next coarser one
+	std::vector<float> screenSizes = { 0.12f, 0.05f, 0.02f };
+	//fraction a threshold must be passed by before switching, stops lods popping back and forth
+	float hysteresis = 0.15f;
+	//scales screen sizes before selection, lower values pick coarser lods sooner
+	float bias = 1.0f;
+};
+
+//currentLod is the lod used last frame for this instance
+int SelectLod(const LodSettings& settings, float screenSize, int currentLod, int lodCount);
+
+#endif
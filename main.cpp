@@ -11,72 +11,247 @@
 #include <string>
 #include <ctime>
 #include <stdlib.h>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
 #include "shader.h"
 #include "camera.h"
 #include "model.h"
+#include "assetRegistry.h"
 #include "gameObject.h"
-#include "projectile.h"
-#include "enemy.h"
 #include "chunk.h"
+#include "lod.h"
+#include "impostor.h"
+#include "jobSystem.h"
+#include "simulation.h"
+#include "glfwInput.h"
+#include "inputRecorder.h"
+#include "replayInput.h"
+#include "allocationCounter.h"
+#include "occlusionBuffer.h"
+#include "groundGrid.h"
+#include "treeBatcher.h"
+#include "mappedFile.h"
+#include "snapshotWriter.h"
+#include "qualityGovernor.h"
+#include "gpuTimer.h"
+#include "lightClusters.h"
+#include "lightClusterBuffers.h"
+#include "particleSystem.h"
+#include "gpuParticles.h"
+#include "framePacer.h"
+#include "netClient.h"
 
 static void error_callback(int error, const char* description);
 static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
-static void cursor_position_callback(GLFWwindow* window, double xpos, double ypos);
 
 void saveHighscore(int& score, int& highscore);
-void AddChunks(Camera& camera, std::vector<Chunk>& chunks, glm::vec3 currentSquare, int numChunks, float chunkWidth, float chunkHeight, Model& groundMdl, Model& treeMdl, std::mt19937& randomGen, std::uniform_real_distribution<float>& spawnXRange, std::uniform_real_distribution<float>& spawnZRange, std::uniform_int_distribution<int>& treeRange);
-void AddProjectile(std::vector<Projectile>& projectiles, Camera& camera, Model& bulletMdl, float& shotTimer, float SHOT_DELAY);
-void AddEnemies(std::vector<Enemy>& enemies, Model& enemyMdl, Camera& camera, std::mt19937& randomGen, std::uniform_real_distribution<float>& spawnDirection, std::uniform_real_distribution<float>& spawnHeight, std::uniform_int_distribution<int>& spawnQuadrant);
 
-int main()
+//set by the key callback when F5 is pressed, saved at the end of the frame
+static bool snapshotRequested = false;
+//set when F6 is pressed, switches between vsync and frame pacing at the end of the frame
+static bool pacingToggleRequested = false;
+void printFrameTimes(std::vector<float>& frameTimes);
+
+int main(int argc, char** argv)
 {
 	float PreviousFrameTime = 0.0f;
 	float TimeElapsed = 0.0f;
 
-	Camera camera;
+	//the simulation runs at a fixed rate, set with --tick-rate <ticks per second>
+	float tickRate = 60.0f;
+	//worker threads for the job system, 0 is one per hardware thread
+	int threadCount = 0;
+	//--flocking steers enemies as a swarm instead of straight at the player.
+	//--stress <n> keeps n enemies alive from a fixed seed and reports the cost of a tick, for timing the simulation
+	bool flocking = false;
+	int stressEnemies = 0;
+	//--record <file> saves the seed and every tick's input, --replay <file> plays one back exactly and
+	//reports the frame times, so different builds can be timed on the same run
+	std::string recordPath = "";
+	std::string replayPath = "";
+	//--frame-stats prints the frame time and heap allocations per frame every few seconds
+	bool frameStats = false;
+	//--no-occlusion draws everything in view instead of skipping what the nearest trees hide
+	bool occlusionCulling = true;
+	//--batch-trees draws each chunk's trees from one merged copy instead of one draw per tree,
+	//more memory for far fewer draws, for drivers where draws are the expensive part
+	bool batchTrees = false;
+	//--snapshot <file> saves the world there when F5 is pressed and when the game closes, --resume <file>
+	//carries on from one, with the seed and settings it was saved with
+	std::string snapshotPath = "";
+	std::string resumePath = "";
+	//the quality governor draws less while frames take longer than --frame-budget <ms> (a 60hz frame
+	//by default) and more again once there is room, --no-governor always draws everything. replays
+	//draw everything unless they are given a budget, so their frame times can be compared between builds
+	bool governorEnabled = true;
+	float frameBudget = 0.0f;
+	//--no-point-lights turns off the light from projectiles and enemies
+	bool pointLightsEnabled = true;
+	//--cpu-particles moves the hit particles on the cpu and uploads them, instead of with transform feedback
+	bool cpuParticles = false;
+	//--frame-pacing starts with vsync off and frames spaced out to the refresh rate by waiting before the
+	//input is read instead of after the frame, F6 switches between the two. --frame-stats reports the
+	//time from mouse movement to the frame showing it for comparing them
+	bool framePacing = false;
+	//--connect <port> plays against forestServer on this machine instead of running the world here. the
+	//server's snapshots are drawn a couple of ticks late and the camera is predicted, --frame-stats adds
+	//the bandwidth, the server's tick cost and how far the prediction was off
+	int connectPort = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--tick-rate" && i + 1 < argc)
+			tickRate = (float)atof(argv[++i]);
+		else if (std::string(argv[i]) == "--threads" && i + 1 < argc)
+			threadCount = atoi(argv[++i]);
+		else if (std::string(argv[i]) == "--flocking")
+			flocking = true;
+		else if (std::string(argv[i]) == "--stress" && i + 1 < argc)
+			stressEnemies = atoi(argv[++i]);
+		else if (std::string(argv[i]) == "--record" && i + 1 < argc)
+			recordPath = argv[++i];
+		else if (std::string(argv[i]) == "--replay" && i + 1 < argc)
+			replayPath = argv[++i];
+		else if (std::string(argv[i]) == "--frame-stats")
+			frameStats = true;
+		else if (std::string(argv[i]) == "--no-occlusion")
+			occlusionCulling = false;
+		else if (std::string(argv[i]) == "--batch-trees")
+			batchTrees = true;
+		else if (std::string(argv[i]) == "--snapshot" && i + 1 < argc)
+			snapshotPath = argv[++i];
+		else if (std::string(argv[i]) == "--resume" && i + 1 < argc)
+			resumePath = argv[++i];
+		else if (std::string(argv[i]) == "--no-governor")
+			governorEnabled = false;
+		else if (std::string(argv[i]) == "--frame-budget" && i + 1 < argc)
+			frameBudget = (float)atof(argv[++i]);
+		else if (std::string(argv[i]) == "--no-point-lights")
+			pointLightsEnabled = false;
+		else if (std::string(argv[i]) == "--cpu-particles")
+			cpuParticles = true;
+		else if (std::string(argv[i]) == "--frame-pacing")
+			framePacing = true;
+		else if (std::string(argv[i]) == "--connect" && i + 1 < argc)
+			connectPort = atoi(argv[++i]);
+	}
+	//the world is the server's, so there is nothing here to record, replay or save
+	if (connectPort > 0 && (recordPath != "" || replayPath != "" || resumePath != "" || snapshotPath != ""))
+	{
+		std::cout << "--connect can't be used with --record, --replay, --resume or --snapshot" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	//recordings start from the seed, so they can't start from a snapshot
+	if (resumePath != "" && (replayPath != "" || recordPath != ""))
+	{
+		std::cout << "--resume can't be used with --record or --replay" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	std::unique_ptr<MappedFile> resumeFile;
+	SnapshotHeader resumeHeader;
+	if (resumePath != "")
+	{
+		resumeFile.reset(new MappedFile(resumePath));
+		if (!resumeFile->IsOpen() || !Simulation::ReadSnapshotHeader(resumeFile->getData(), resumeFile->getSize(), resumeHeader))
+		{
+			std::cout << "failed to load snapshot " << resumePath << std::endl;
+			exit(EXIT_FAILURE);
+		}
+		flocking = resumeHeader.flocking != 0;
+		stressEnemies = resumeHeader.stressEnemies;
+	}
+	std::unique_ptr<ReplayInput> replay;
+	if (replayPath != "")
+	{
+		replay.reset(new ReplayInput(replayPath));
+		if (!replay->IsLoaded())
+			exit(EXIT_FAILURE);
+		//the recording decides how the simulation is set up
+		const ReplayHeader& header = replay->getHeader();
+		tickRate = 1.0f / header.tickTime;
+		flocking = header.flocking != 0;
+		stressEnemies = header.stressEnemies;
+	}
+	std::unique_ptr<NetClient> netClient;
+	NetWelcome welcome;
+	if (connectPort > 0)
+	{
+		//so is how it is set up
+		netClient.reset(new NetClient((unsigned short)connectPort));
+		if (!netClient->Connect(5.0f, welcome))
+			exit(EXIT_FAILURE);
+		std::cout << "connected to the server on port " << connectPort << std::endl;
+		tickRate = 1.0f / welcome.tickTime;
+		flocking = welcome.flocking != 0;
+		stressEnemies = welcome.stressEnemies;
+	}
+	if (stressEnemies < 0)
+		stressEnemies = 0;
+	if (replay && frameBudget <= 0.0f)
+		governorEnabled = false;
+	if (frameBudget <= 0.0f)
+		frameBudget = 1000.0f / 60.0f;
+	if (threadCount < 0)
+		threadCount = 0;
+	if (tickRate < 1.0f)
+		tickRate = 1.0f;
+	const float tickTime = replay ? replay->getHeader().tickTime : 1.0f / tickRate;
+	const float MAX_FRAME_TIME = 0.25f;
+	float accumulator = 0.0f;
+
+	JobSystem jobs(threadCount);
+
+	//time spent simulating, reported every few seconds in stress mode
+	double stressTickTime = 0.0;
+	unsigned int stressTicks = 0;
+	const unsigned int STRESS_REPORT_TICKS = (unsigned int)(tickRate * 5.0f);
+	//frame times and allocations since the last report. the game should make no heap allocations
+	//once it is running, anything counted here is something to track down
+	const float FRAME_REPORT_TIME = 5.0f;
+	float reportTime = 0.0f, worstFrame = 0.0f;
+	unsigned int reportFrames = 0, allocatingFrames = 0;
+	AllocationStats reportAllocations;
+	AllocationStats replayAllocations;
+	unsigned long long reportOccludedTrees = 0, reportOccludedEnemies = 0;
+	unsigned int reportBatchesBuilt = 0;
+	double reportCpuTime = 0.0, reportGpuTime = 0.0;
+	double reportLightTime = 0.0;
+	unsigned long long reportLights = 0, reportDroppedLights = 0;
+	unsigned int reportMaxClusterLights = 0;
+	double reportParticleTime = 0.0;
+	double reportLatency = 0.0;
+	float worstLatency = 0.0f;
+	unsigned int reportLatencyFrames = 0;
+	unsigned long long reportBursts = 0;
+
 	int ScreenWidth = 1600;
 	int ScreenHeight = 900;
-
-
-	const float CHUNK_WIDTH = 30.0f;
-	const float CHUNK_HEIGHT = 30.0f;
-	const int MAX_TREES = 30;
-	int numChunks;
-	int range;
-	std::vector<Chunk> chunks;
-	std::mt19937 randomGen(time(0));
-	std::uniform_real_distribution<float> spawnXRange = std::uniform_real_distribution<float>(-(CHUNK_WIDTH / 2), (CHUNK_WIDTH / 2));
-	std::uniform_real_distribution<float> spawnZRange = std::uniform_real_distribution<float>(-(CHUNK_HEIGHT / 2), (CHUNK_HEIGHT / 2));
-	std::uniform_int_distribution<int> treeRange = std::uniform_int_distribution<int>(0, MAX_TREES);
-	glm::vec3 currentSquare(0.0f);
-
-	std::vector<Projectile> projectiles;
-	const float SHOT_DELAY = 0.1f;
-	float shotTimer = 0.1f;
-
-	std::vector<Enemy> enemies;
-	bool enemiesEnabled = true;
-	bool holdingButton = false;
-	float enemyDelay = 6.0f;
-	const float INITIAL_ENEMY_DELAY = 6.0f;
-	float enemyTimer = 0.0f;
-	const float DIFFICULTY_DELAY = 5.0f;
-	float difficultyTimer = 0.0f;
-	std::uniform_real_distribution<float> spawnDirection = std::uniform_real_distribution<float>(0.0f, 90.0f);
-	std::uniform_real_distribution<float> spawnHeight = std::uniform_real_distribution<float>(0.1f, 10.0f);
-	std::uniform_int_distribution<int> spawnQuadrant = std::uniform_int_distribution<int>(0, 1);
-
 	int highscore = 0;
-	int score = 0;
 
-	const float DANGER_RANGE = 30.0f;
-	float danger = 0.0f;
-
-	Model groundMdl;
-	Model treeMdl;
-	Model projectileMdl;
-	Model enemyMdl;
-	Model skyModel;
+	AssetRegistry assets;
+	LodSettings lodSettings;
+	const std::vector<float> TREE_LOD_RATIOS = { 0.5f, 0.25f };
+	const std::vector<float> SPHERE_LOD_RATIOS = { 0.4f, 0.15f, 0.06f };
+	const float IMPOSTOR_DISTANCE = 50.0f;
+	const int IMPOSTOR_ANGLES = 16;
+	const int IMPOSTOR_TILE_SIZE = 128;
+	//the closest trees in view are drawn into a small depth buffer on the cpu each frame and
+	//trees and enemies behind them are skipped. far trees hide too little to be worth drawing
+	const unsigned int MAX_OCCLUDERS = 48;
+	const float OCCLUDER_DISTANCE = 40.0f;
+	//every projectile and enemy lights up what is around it
+	const float PROJECTILE_LIGHT_RADIUS = 6.0f;
+	const glm::vec3 PROJECTILE_LIGHT_COLOUR = glm::vec3(1.0f, 0.75f, 0.35f);
+	const float ENEMY_LIGHT_RADIUS = 8.0f;
+	const glm::vec3 ENEMY_LIGHT_COLOUR = glm::vec3(0.9f, 0.15f, 0.1f);
+	ModelHandle groundMdl;
+	ModelHandle treeMdl;
+	ModelHandle projectileMdl;
+	ModelHandle enemyMdl;
+	ModelHandle skyModel;
 	glm::vec3 skyBoxColour = glm::vec3(91.0f / 255.0f, 110.0f / 255.0f, 225.0f / 255.0f);
 
 
@@ -128,229 +303,521 @@ int main()
 		glfwSetInputMode(window, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
 
 	glfwSetKeyCallback(window, key_callback);
-	glfwSetCursorPosCallback(window, cursor_position_callback);
 	int width, height;
 	glfwGetFramebufferSize(window, &width, &height);
 	glViewport(0, 0, width, height);
-	glfwSwapInterval(1);
+	//replays run uncapped so the frame times are the build's, not the monitor's
+	if (replay)
+		framePacing = false;
+	glfwSwapInterval(replay || framePacing ? 0 : 1);
+	GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+	const GLFWvidmode* videoMode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+	FramePacer pacer(videoMode && videoMode->refreshRate > 0 ? (float)videoMode->refreshRate : 60.0f);
 
 	//so that fragments behind other fragments in the world space are not drawn
 	glEnable(GL_DEPTH_TEST);
 
 	Shader objectShader("vShader.vert", "fShader.frag");
-	camera.setScreenSize(ScreenWidth, ScreenHeight);
-
-	std::random_device rd{};
-	std::mt19937 engine{ rd() };
-	randomGen = engine;
-	range = (int)(camera.getRenderDistance() + 100.0f);
-	numChunks = 3;
-
-
-	groundMdl = Model("assets/ground.obj");
-	treeMdl = Model("assets/tree.obj");
-	projectileMdl = Model("assets/bullet.obj");
-	enemyMdl = Model("assets/enemy.obj");
-	skyModel = Model("assets/sky.obj");
+	//point lights are sorted into clusters on the cpu each frame and read by the shader from texture
+	//buffers. bound straight away, the shader can't draw until its buffer samplers have their own units
+	LightClusters lightClusters;
+	LightClusterBuffers lightBuffers(lightClusters);
+	objectShader.Use();
+	lightBuffers.Bind(objectShader, lightClusters, width, height, false);
+	//sparks where projectiles hit trees and a burst where enemies die
+	ParticleSystem particles;
+	GpuParticles gpuParticles(particles);
+
+	SimulationSettings settings;
+	settings.flocking = flocking;
+	settings.stressEnemies = stressEnemies;
+	//stress runs are repeatable, so they always start from the same seed
+	if (replay)
+	{
+		settings.seed = replay->getHeader().seed;
+		settings.chunkRadius = replay->getHeader().chunkRadius;
+	}
+	else if (resumeFile)
+	{
+		settings.seed = resumeHeader.seed;
+		settings.chunkRadius = resumeHeader.chunkRadius;
+	}
+	else if (netClient)
+	{
+		settings.seed = welcome.seed;
+		settings.chunkRadius = welcome.chunkRadius;
+	}
+	else if (stressEnemies > 0)
+		settings.seed = 1;
+	else
+		settings.seed = std::random_device{}();
+	Simulation sim(settings, jobs);
+	sim.highscore = highscore;
+	if (resumeFile)
+	{
+		if (!sim.LoadSnapshot(resumeFile->getData(), resumeFile->getSize()))
+		{
+			std::cout << "failed to load snapshot " << resumePath << std::endl;
+			exit(EXIT_FAILURE);
+		}
+		std::cout << "resumed from " << resumePath << " at tick " << sim.ticks << std::endl;
+		resumeFile.reset();
+		if (highscore > sim.highscore)
+			sim.highscore = highscore;
+		//the mouse is somewhere else now, it shouldn't turn the camera on the first frame
+		sim.camera.ResetMouse();
+	}
+	SnapshotWriter snapshotWriter;
+	sim.camera.setScreenSize(ScreenWidth, ScreenHeight);
+	Camera& camera = sim.camera;
+	GlfwInput windowInput(window);
+	InputSource* input = replay ? (InputSource*)replay.get() : &windowInput;
+	std::unique_ptr<InputRecorder> recorder;
+	if (recordPath != "")
+	{
+		ReplayHeader header;
+		header.seed = settings.seed;
+		header.tickTime = tickTime;
+		header.flocking = settings.flocking ? 1 : 0;
+		header.stressEnemies = settings.stressEnemies;
+		header.chunkRadius = settings.chunkRadius;
+		recorder.reset(new InputRecorder(*input, recordPath, header));
+		if (recorder->IsOpen())
+			input = recorder.get();
+		else
+			recorder.reset();
+	}
+	//frame times while replaying, summarised when it finishes
+	std::vector<float> replayFrameTimes;
+	bool replayFinished = false;
+
+	//the ground tile's geometry is kept to copy into the ground grid
+	groundMdl = assets.LoadModel("assets/ground.obj", true);
+	//batching copies the tree's geometry, so it is kept after upload
+	treeMdl = assets.LoadModel("assets/tree.obj", batchTrees, TREE_LOD_RATIOS);
+	projectileMdl = assets.LoadModel("assets/bullet.obj", false, SPHERE_LOD_RATIOS);
+	enemyMdl = assets.LoadModel("assets/enemy.obj", false, SPHERE_LOD_RATIOS);
+	skyModel = assets.LoadModel("assets/sky.obj");
+	assets.PrintStats();
+
+	GameObject projectileObject(assets.Get(projectileMdl), 20.0f);
+	GameObject enemyObject(assets.Get(enemyMdl), 20.0f);
+
+	Impostor treeImpostor(assets.Get(treeMdl), IMPOSTOR_ANGLES, IMPOSTOR_TILE_SIZE, IMPOSTOR_DISTANCE);
+	treeImpostor.Bake(objectShader);
+
+	GroundGrid ground(assets.Get(groundMdl)->getMeshes()[0], sim.getLoadedAcross(), Simulation::CHUNK_WIDTH, 10.0f);
+	OcclusionBuffer occlusion;
+	//enough batches for every chunk with a tree close enough to be drawn as a model
+	std::unique_ptr<TreeBatcher> treeBatcher;
+	if (batchTrees)
+	{
+		int batchReach = (int)std::ceil(IMPOSTOR_DISTANCE / Simulation::CHUNK_WIDTH) + 1;
+		treeBatcher.reset(new TreeBatcher(*assets.Get(treeMdl), Simulation::MAX_TREES, (batchReach * 2 + 1) * (batchReach * 2 + 1)));
+		std::cout << "tree batches: " << treeBatcher->getGpuBytes() / (1024 * 1024) << "MB" << std::endl;
+	}
+	QualityLevels fullQuality;
+	fullQuality.drawDistance = camera.getRenderDistance();
+	fullQuality.chunkRadius = settings.chunkRadius;
+	fullQuality.lodBias = lodSettings.bias;
+	QualityGovernor governor(fullQuality, frameBudget / 1000.0f);
+	//a frame's cost is the longer of its cpu and gpu work, the gpu's is only known a few frames later
+	GpuTimer gpuTimer;
+	float gpuFrameTime = 0.0f;
+	std::vector<glm::vec3> occluderTrees;
+	occluderTrees.reserve(sim.chunks.capacity() * Simulation::MAX_TREES);
 
 	while (!glfwWindowShouldClose(window))
 	{
 		//main loop
-
+		//paced frames wait here, before the input is read
+		if (framePacing)
+			pacer.Wait();
+		glfwPollEvents();
+		if (netClient && netClient->IsServerGone())
+		{
+			std::cout << "the server has gone" << std::endl;
+			break;
+		}
 
 		float currentFrame = (float)glfwGetTime();
 		TimeElapsed = currentFrame - PreviousFrameTime;
 		PreviousFrameTime = currentFrame;
-
-		difficultyTimer += TimeElapsed;
-		if (difficultyTimer > DIFFICULTY_DELAY)
+		//after a stall, drop the backlog rather than trying to simulate all of it at once
+		if (TimeElapsed > MAX_FRAME_TIME)
+			TimeElapsed = MAX_FRAME_TIME;
+		accumulator += TimeElapsed;
+
+		//a replay runs the ticks each frame ran when it was recorded instead of following the clock
+		unsigned int frameTicks = 0;
+		if (replay)
 		{
-			difficultyTimer = 0.0f;
-			enemyDelay -= 0.2f;
-			if (enemyDelay < 1.0f)
-				enemyDelay = 1.0f;
-		}
-
-		camera.KeyHandler(window, TimeElapsed);
-		double xPos, yPos;
-		glfwGetCursorPos(window, &xPos , &yPos);
-		camera.CursorPosCallback(window, xPos, yPos, TimeElapsed);
-		if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS)
-		{
-			AddProjectile(projectiles, camera, projectileMdl, shotTimer, SHOT_DELAY);
-		}
-		if (glfwGetKey(window, GLFW_KEY_F1) == GLFW_PRESS)
-		{
-			chunks.clear();
-		}
-		if (glfwGetKey(window, GLFW_KEY_F2) == GLFW_PRESS && !holdingButton)
-		{
-			enemiesEnabled = !enemiesEnabled;
-			holdingButton = true;
-			enemies.clear();
+			if (!replay->NextFrame())
+			{
+				replayFinished = true;
+				break;
+			}
+			frameTicks = replay->getFrameTicks();
+			replayFrameTimes.push_back(TimeElapsed);
 		}
-		if (holdingButton)
+		else
 		{
-			if (glfwGetKey(window, GLFW_KEY_F2) == GLFW_RELEASE)
+			while (accumulator >= tickTime)
 			{
-				holdingButton = false;
+				accumulator -= tickTime;
+				frameTicks++;
 			}
 		}
-		if (enemyTimer > enemyDelay && enemiesEnabled)
+		if (recorder)
+			recorder->NextFrame();
+		AllocationStats frameStart = GetAllocationStats();
+
+		//looking around is applied every frame, it does not need to wait for a tick
+		sim.Look(*input, TimeElapsed);
+
+		//-----------------------------------------
+		//simulation, advanced in fixed ticks so it behaves the same at any frame rate
+		for (unsigned int t = 0; t < frameTicks; t++)
 		{
-			enemyTimer = 0;
-			AddEnemies(enemies, enemyMdl, camera, randomGen, spawnDirection, spawnHeight, spawnQuadrant);
+			if (replay)
+				replay->NextTick();
+			if (recorder)
+				recorder->NextTick();
+			auto tickStart = std::chrono::high_resolution_clock::now();
+			//connected, the tick only sends the input and moves on to the next snapshot
+			if (netClient)
+				netClient->Tick(sim, *input);
+			else
+				sim.Tick(*input, tickTime);
+			for (const Impact& impact : sim.impacts)
+				particles.Emit(impact.position, impact.direction, impact.kind == Impact::Enemy ? PARTICLE_DEATH : PARTICLE_SPARKS);
+
+			if (stressEnemies > 0 && !netClient)
+			{
+				stressTickTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tickStart).count();
+				if (++stressTicks == STRESS_REPORT_TICKS)
+				{
+					std::cout << "stress: " << sim.enemies.Size() << " enemies, " << (flocking ? "flocking, " : "")
+						<< stressTickTime / stressTicks << "ms per tick" << std::endl;
+					stressTickTime = 0.0;
+					stressTicks = 0;
+				}
+			}
 		}
+
 		//-----------------------------------------
+		//rendering, everything that moves is drawn between its last two ticks
+		float alpha = replay ? replay->getFrameAlpha() : accumulator / tickTime;
+		if (recorder)
+			recorder->EndFrame(alpha);
+		float danger = sim.danger;
+
+		//culling and lod selection run in parallel, the draws stay on this thread with the gl context.
+		//chunks further out than the governor's chunk radius aren't drawn at all
+		const QualityLevels& quality = governor.getLevels();
+		float chunkReach = (quality.chunkRadius + 0.5f) * Simulation::CHUNK_WIDTH;
+		jobs.ParallelFor(sim.chunks.size(), 1, [&](unsigned int begin, unsigned int end, unsigned int /*worker*/)
+		{
+			for (unsigned int i = begin; i < end; i++)
+			{
+				glm::vec3 offset = sim.chunks[i].getPos() - camera.getPos();
+				if (std::max(std::fabs(offset.x), std::fabs(offset.z)) > chunkReach)
+					sim.chunks[i].Hide();
+				else
+					sim.chunks[i].Cull(camera, lodSettings, *assets.Get(treeMdl), treeImpostor.getDistance(), quality.treeDensity);
+			}
+		});
+		//late latch: the mouse movement since the top of the frame turns the camera just before it is
+		//drawn from. nothing above depends on exactly where it points, chunks keep trees a little outside
+		//the field of view. recordings read the cursor once a frame, so this changes nothing in them
+		glfwPollEvents();
+		sim.Look(*input, TimeElapsed);
+		double motionTime = windowInput.TakeFirstMotionTime();
+
+		gpuTimer.Begin();
 		glClearColor(0.2f, 0.2f, 0.22f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		objectShader.Use();
 
-		glUniform3fv(objectShader.Location("viewPos"), 1, &camera.getPos()[0]);
+		auto currentPos = camera.getInterpolatedPos(alpha);
+		glUniform3fv(objectShader.Location("viewPos"), 1, &currentPos[0]);
 		glUniform3fv(objectShader.Location("light.direction"), 1, &glm::vec3(-0.2f, -0.5f, -0.3f)[0]);
 		//set shader view and projection matricies
-		glm::mat4 view = camera.getViewMatrix();
+		glm::mat4 view = camera.getViewMatrix(alpha);
 		glUniformMatrix4fv(objectShader.Location("view"), 1, GL_FALSE, &view[0][0]);
 		glm::mat4 projection = camera.getProjectionMatrix();
 		glUniformMatrix4fv(objectShader.Location("projection"), 1, GL_FALSE, &projection[0][0]);
-		auto dist = camera.getRenderDistance();
+		auto dist = camera.getDrawDistance();
 		glUniform1fv(objectShader.Location("renderDistance"), 1, &dist);
 
-		auto currentPos = camera.getPos();
-
 		glUniform3fv(objectShader.Location("fogColor"), 1, &glm::vec3(0.0f)[0]);
 		glUniform3fv(objectShader.Location("light.ambient"), 1, &glm::vec3(0.7f - (danger / (10.0f/7.0f)))[0]);
 		glUniform3fv(objectShader.Location("light.diffuse"), 1, &glm::vec3(0.0f)[0]);
 		glUniform3fv(objectShader.Location("light.specular"), 1, &glm::vec3(0.0f)[0]);
+		//no light reaches as far as the sky
+		glUniform1i(objectShader.Location("pointLights"), 0);
 
 		glm::mat4 model = glm::mat4(1.0f);
 		model = glm::translate(model, currentPos);
-		model = glm::scale(model, glm::vec3(camera.getRenderDistance()));
+		model = glm::scale(model, glm::vec3(camera.getDrawDistance()));
 		glUniformMatrix4fv(objectShader.Location("model"), 1, GL_FALSE, &model[0][0]);
 		float shinX = 1.0f;
 		glUniform1fv(objectShader.Location("shininess"), 1, &shinX);
-		skyModel.Draw(objectShader);
+		assets.Get(skyModel)->Draw(objectShader);
 
 		auto fogColour = (0.7f - (danger / (10.0f / 7.0f))) * skyBoxColour;
 		glUniform3fv(objectShader.Location("fogColor"), 1, &fogColour[0]);
-		glUniform3fv(objectShader.Location("light.ambient"), 1, &glm::vec3(0.2f + (danger / 10.0f), 0.2f - (danger / 5.0f), 0.2f - (danger / 5.0f))[0]);
-		glUniform3fv(objectShader.Location("light.diffuse"), 1, &glm::vec3(0.5f - (danger / 4.0f), 0.5f - (danger / 2.0f), 0.5f - (danger / 2.0f))[0]);
+		auto ambient = glm::vec3(0.2f + (danger / 10.0f), 0.2f - (danger / 5.0f), 0.2f - (danger / 5.0f));
+		auto diffuse = glm::vec3(0.5f - (danger / 4.0f), 0.5f - (danger / 2.0f), 0.5f - (danger / 2.0f));
+		glUniform3fv(objectShader.Location("light.ambient"), 1, &ambient[0]);
+		glUniform3fv(objectShader.Location("light.diffuse"), 1, &diffuse[0]);
 		glUniform3fv(objectShader.Location("light.specular"), 1, &glm::vec3(1.0f - danger)[0]);
 
-		std::vector<Chunk*> collidingChunks;
-		for (unsigned int i = 0; i < chunks.size(); i++)
+		//projectiles and enemies light the world from where they are drawn
+		unsigned int frameLights = 0;
+		if (pointLightsEnabled)
 		{
-			auto chunkPos = chunks[i].getPos();
-			chunkPos.x -= CHUNK_WIDTH / 2;
-			chunkPos.z -= CHUNK_HEIGHT / 2;
-			if (currentPos.x > chunkPos.x - 1.0f && currentPos.x < chunkPos.x + CHUNK_WIDTH + 1.0f &&
-				currentPos.z > chunkPos.z - 1.0f && currentPos.z < chunkPos.z + CHUNK_HEIGHT + 1.0f)
-			{
-				collidingChunks.push_back(&chunks[i]);
-			}
-			chunks[i].Draw(objectShader, camera);
+			auto lightStart = std::chrono::high_resolution_clock::now();
+			lightClusters.Begin(view, projection, currentPos);
+			for (unsigned int i = 0; i < sim.projectiles.Size(); i++)
+				lightClusters.Add({ glm::mix(sim.projectiles.previousPositions[i], sim.projectiles.positions[i], alpha), PROJECTILE_LIGHT_RADIUS, PROJECTILE_LIGHT_COLOUR });
+			for (unsigned int i = 0; i < sim.enemies.Size(); i++)
+				lightClusters.Add({ glm::mix(sim.enemies.previousPositions[i], sim.enemies.positions[i], alpha), ENEMY_LIGHT_RADIUS, ENEMY_LIGHT_COLOUR });
+			lightClusters.Build();
+			lightBuffers.Upload(lightClusters);
+			frameLights = (unsigned int)lightClusters.getLights().size();
+			reportLightTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - lightStart).count();
+		}
+		lightBuffers.Bind(objectShader, lightClusters, width, height, pointLightsEnabled);
 
-			if (glm::distance(chunks[i].getPos(), currentPos) > range)
+		std::atomic<unsigned int> occludedTrees(0);
+		if (occlusionCulling)
+		{
+			occlusion.Begin(projection * view, currentPos);
+			occluderTrees.clear();
+			for (unsigned int i = 0; i < sim.chunks.size(); i++)
+				sim.chunks[i].GatherOccluders(currentPos, OCCLUDER_DISTANCE, occluderTrees);
+			occlusion.AddNearestOccluders(occluderTrees, MAX_OCCLUDERS, Chunk::TREE_OCCLUDERS, 3);
+			occlusion.Finish();
+			glm::vec3 treeMin = assets.Get(treeMdl)->getBoundsMin(), treeMax = assets.Get(treeMdl)->getBoundsMax();
+			jobs.ParallelFor(sim.chunks.size(), 1, [&](unsigned int begin, unsigned int end, unsigned int /*worker*/)
 			{
-				chunks.erase(chunks.begin() + i--);
-			}
+				unsigned int culled = 0;
+				for (unsigned int i = begin; i < end; i++)
+					culled += sim.chunks[i].Occlude(occlusion, treeMin, treeMax);
+				occludedTrees += culled;
+			});
 		}
-		if (collidingChunks.size() == 0)
+		ground.Update(sim.chunks, camera.getPos(), chunkReach);
+		ground.Draw(objectShader);
+		for (unsigned int i = 0; i < sim.chunks.size(); i++)
 		{
-			chunks.clear();
-			currentSquare.x = camera.getPos().x;
-			currentSquare.z = camera.getPos().z;
-			AddChunks(camera, chunks, currentSquare, numChunks, CHUNK_WIDTH, CHUNK_HEIGHT, groundMdl, treeMdl, randomGen, spawnXRange, spawnZRange, treeRange);
+			if (treeBatcher)
+				sim.chunks[i].DrawBatched(objectShader, *treeBatcher, &treeImpostor);
+			else
+				sim.chunks[i].Draw(objectShader, *assets.Get(treeMdl), &treeImpostor);
 		}
-		else
+		projectileObject.Draw(objectShader, camera, lodSettings, sim.projectiles, alpha);
+		unsigned int occludedEnemies = enemyObject.Draw(objectShader, camera, lodSettings, sim.enemies, alpha, occlusionCulling ? &occlusion : nullptr);
+
+		//far trees are drawn last, in one batch, with their own shader.
+		//the atlas was baked with no danger so it is tinted by how much the lighting has changed since
+		treeImpostor.Draw(camera, view, projection, fogColour, (ambient + diffuse) / 0.7f);
+
+		//particles go over everything solid, once the last one has died there is nothing to do
+		unsigned int frameBursts = (unsigned int)particles.getBursts().size();
+		if (particles.IsActive())
 		{
-			bool chunkFound = false;
-			for (unsigned int i = 0; i < collidingChunks.size(); i++)
+			auto particleStart = std::chrono::high_resolution_clock::now();
+			if (cpuParticles)
 			{
-				if (currentSquare.x == collidingChunks[i]->getPos().x && currentSquare.z == collidingChunks[i]->getPos().z)
-				{
-					chunkFound = true;
-				}
+				particles.Simulate(TimeElapsed);
+				gpuParticles.Upload(particles);
 			}
-			if (!chunkFound)
+			else
+				gpuParticles.Update(particles, TimeElapsed);
+			gpuParticles.Draw(view, projection, height);
+			reportParticleTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - particleStart).count();
+		}
+		particles.EndFrame(TimeElapsed);
+		gpuTimer.End();
+		//-------------------------------------
+		//everything up to here is the frame's work, swapping can wait for vsync
+		float cpuFrameTime = (float)glfwGetTime() - currentFrame;
+		glfwSwapBuffers(window);
+		//from the first mouse movement this frame shows to the swap, which is as close to it reaching the
+		//screen as can be told from here
+		float inputLatency = motionTime >= 0.0 ? (float)(glfwGetTime() - motionTime) : -1.0f;
+		if (pacingToggleRequested)
+		{
+			pacingToggleRequested = false;
+			if (replay)
+				std::cout << "replays always run uncapped" << std::endl;
+			else
 			{
-				currentSquare.x = collidingChunks[0]->getPos().x;
-				currentSquare.z = collidingChunks[0]->getPos().z;
-				AddChunks(camera, chunks, currentSquare, numChunks, CHUNK_WIDTH, CHUNK_HEIGHT, groundMdl, treeMdl, randomGen, spawnXRange, spawnZRange, treeRange);
+				framePacing = !framePacing;
+				glfwSwapInterval(framePacing ? 0 : 1);
+				pacer.Reset();
+				std::cout << (framePacing ? "frame pacing at " : "vsync at ") << (int)(1.0f / pacer.getPeriod() + 0.5f) << "hz" << std::endl;
 			}
 		}
 
+		gpuTimer.Result(gpuFrameTime);
+		if (governorEnabled && governor.AddFrame(std::max(cpuFrameTime, gpuFrameTime)))
+		{
+			camera.setDrawDistance(quality.drawDistance);
+			lodSettings.bias = quality.lodBias;
+			std::cout << "quality: level " << governor.getLevel() << " of " << governor.getLevelCount() - 1 << ", draw distance " << quality.drawDistance
+				<< ", " << quality.chunkRadius << " chunks, " << (int)(quality.treeDensity * 100.0f) << "% of far trees, lod bias " << quality.lodBias
+				<< " (frames " << governor.getAverageFrameTime() * 1000.0f << "ms, budget " << governor.getBudget() * 1000.0f << "ms)" << std::endl;
+		}
 
-		shotTimer += TimeElapsed;
-		for (unsigned int i = 0; i < projectiles.size(); i++)
+		//taken between ticks, only copying the state holds up the frame, the file is written in the background
+		if (snapshotRequested)
 		{
-			bool collided = false;
-			for (unsigned int j = 0; j < enemies.size(); j++)
-			{
-				if (enemies[j].Colliding(projectiles[i].getPos()))
-				{
-					enemies.erase(enemies.begin() + j--);
-					collided = true;
-					score++;
-					std::cout << "\nHighscore: " << highscore << "\nScore:     " << score << std::endl;
-				}
-			}
-			if (collided)
-			{
-				projectiles.erase(projectiles.begin() + i--);
-			}
+			snapshotRequested = false;
+			if (snapshotPath == "")
+				std::cout << "start with --snapshot <file> to save snapshots" << std::endl;
+			else if (snapshotWriter.IsWriting())
+				std::cout << "still saving the last snapshot" << std::endl;
 			else
 			{
-				projectiles[i].Update(TimeElapsed);
-				projectiles[i].Draw(objectShader, camera);
-
-				if (glm::distance(projectiles[i].getPos(), camera.getPos()) > range * 2)
-				{
-					projectiles.erase(projectiles.begin() + i--);
-				}
+				sim.SaveSnapshot(snapshotWriter.Begin());
+				snapshotWriter.Write(snapshotPath);
+				std::cout << "saved snapshot at tick " << sim.ticks << std::endl;
 			}
 		}
-		danger = 0.0f;
-		enemyTimer += TimeElapsed;
-		for (unsigned int i = 0; i < enemies.size(); i++)
+
+		AllocationStats frameAllocations = AllocationsSince(frameStart);
+		if (replay && replayFrameTimes.size() > 1)
+		{
+			replayAllocations.count += frameAllocations.count;
+			replayAllocations.bytes += frameAllocations.bytes;
+		}
+		if (frameStats)
 		{
-			if (glm::distance(enemies[i].getPos(), camera.getPos()) < DANGER_RANGE)
+			reportTime += TimeElapsed;
+			reportFrames++;
+			if (TimeElapsed > worstFrame)
+				worstFrame = TimeElapsed;
+			if (frameAllocations.count > 0)
+				allocatingFrames++;
+			reportAllocations.count += frameAllocations.count;
+			reportAllocations.bytes += frameAllocations.bytes;
+			reportOccludedTrees += occludedTrees;
+			reportOccludedEnemies += occludedEnemies;
+			reportCpuTime += cpuFrameTime;
+			reportLights += frameLights;
+			reportBursts += frameBursts;
+			if (inputLatency >= 0.0f)
 			{
-				auto tempDanger = 1.0f - ((glm::distance(enemies[i].getPos(), camera.getPos()) + 1.0f) / DANGER_RANGE);
-				if (tempDanger > danger)
-					danger = tempDanger;
+				reportLatency += inputLatency;
+				worstLatency = std::max(worstLatency, inputLatency);
+				reportLatencyFrames++;
 			}
-			if (enemies[i].Colliding(camera.getPos()))
+			if (pointLightsEnabled)
 			{
-				enemies.clear();
-				projectiles.clear();
-				chunks.clear();
-				std::cout << "\nYOU DIED\nHighscore: " << highscore << "\nFinal Score: " << score << std::endl;
-				if (score > highscore)
-					highscore = score;
-				score = 0;
-				enemyDelay = INITIAL_ENEMY_DELAY;
+				reportDroppedLights += lightClusters.getDroppedLights();
+				reportMaxClusterLights = std::max(reportMaxClusterLights, lightClusters.getMaxClusterLights());
 			}
-			else
+			reportGpuTime += gpuFrameTime;
+			if (treeBatcher)
+				reportBatchesBuilt += treeBatcher->takeBatchesBuilt();
+			if (reportTime >= FRAME_REPORT_TIME)
 			{
-				enemies[i].Update(TimeElapsed);
-				enemies[i].Draw(objectShader, camera);
-				auto pos = camera.getPos();
-				pos.y -= 0.3f;
-				enemies[i].UpdateVelocity(glm::normalize(pos - enemies[i].getPos()));
+				std::cout << "frames: " << reportTime * 1000.0f / reportFrames << "ms average, " << worstFrame * 1000.0f << "ms worst, "
+					<< (double)reportAllocations.count / reportFrames << " allocations per frame (" << reportAllocations.bytes << " bytes in "
+					<< allocatingFrames << " of " << reportFrames << " frames)" << std::endl;
+				if (occlusionCulling)
+					std::cout << "occlusion: " << (double)reportOccludedTrees / reportFrames << " trees and " << (double)reportOccludedEnemies / reportFrames
+						<< " enemies hidden per frame, " << occlusion.getOccluderCount() << " occluder shapes" << std::endl;
+				if (treeBatcher)
+					std::cout << "tree batches: " << reportBatchesBuilt << " built" << std::endl;
+				if (pointLightsEnabled)
+					std::cout << "point lights: " << (double)reportLights / reportFrames << " per frame, " << (double)reportDroppedLights / reportFrames << " dropped, at most "
+						<< reportMaxClusterLights << " in a cluster, " << reportLightTime / reportFrames << "ms sorting and uploading" << std::endl;
+				std::cout << "particles: " << (double)reportBursts / reportFrames << " bursts per frame, " << particles.getDroppedBursts() << " dropped in all, "
+					<< reportParticleTime / reportFrames << "ms " << (cpuParticles ? "simulating and uploading" : "sending") << std::endl;
+				if (reportLatencyFrames > 0)
+					std::cout << "input latency: " << reportLatency * 1000.0 / reportLatencyFrames << "ms average, " << worstLatency * 1000.0f << "ms worst over "
+						<< reportLatencyFrames << " frames with mouse movement, " << (framePacing ? "frame pacing" : "vsync") << std::endl;
+				if (netClient)
+				{
+					const NetClientStats& net = netClient->getStats();
+					double netTicks = (double)(net.ticks > 0 ? net.ticks : 1);
+					double snapshots = (double)(net.snapshots > 0 ? net.snapshots : 1);
+					std::cout << "network: " << net.bytes / snapshots << " bytes per snapshot (" << net.bytes / reportTime / 1024.0 << "KB/s), server "
+						<< net.serverTickMilliseconds / snapshots << "ms per tick, prediction " << (net.predictions > 0 ? net.predictionError / net.predictions : 0.0)
+						<< " units off (" << net.worstPredictionError << " worst), " << (net.roundTrips > 0 ? net.roundTripSeconds * 1000.0 / net.roundTrips : 0.0)
+						<< "ms round trip, drawn " << net.interpolationTicks / netTicks << " ticks behind, " << net.missingTicks << " snapshots missing" << std::endl;
+					netClient->ResetStats();
+				}
+				std::cout << "work: " << reportCpuTime * 1000.0 / reportFrames << "ms cpu, " << reportGpuTime * 1000.0 / reportFrames << "ms gpu per frame, quality level "
+					<< governor.getLevel() << (governorEnabled ? "" : " (governor off)") << ", " << governor.getChanges() << " changes" << std::endl;
+				reportTime = worstFrame = 0.0f;
+				reportFrames = allocatingFrames = 0;
+				reportAllocations = AllocationStats();
+				reportOccludedTrees = reportOccludedEnemies = 0;
+				reportBatchesBuilt = 0;
+				reportCpuTime = reportGpuTime = 0.0;
+				reportLightTime = 0.0;
+				reportLights = reportDroppedLights = 0;
+				reportParticleTime = 0.0;
+				reportBursts = 0;
+				reportLatency = 0.0;
+				worstLatency = 0.0f;
+				reportLatencyFrames = 0;
+				reportMaxClusterLights = 0;
 			}
 		}
-		//-------------------------------------
-		glfwPollEvents();
-		glfwSwapBuffers(window);
 	}
 
+	if (snapshotPath != "")
+	{
+		sim.SaveSnapshot(snapshotWriter.Begin());
+		snapshotWriter.Write(snapshotPath);
+	}
+
+	//free gl objects while the context still exists
+	treeBatcher.reset();
+	assets.Clear();
 	glfwDestroyWindow(window);
 	window = nullptr;
 	glfwTerminate();
 
-	saveHighscore(score, highscore);
+	if (recorder)
+		recorder->Finish(sim.ticks, sim.StateHash());
+	if (replay)
+	{
+		if (replayFinished)
+			replay->Verify(sim.ticks, sim.StateHash());
+		else
+			std::cout << "replay stopped after " << sim.ticks << " ticks" << std::endl;
+		printFrameTimes(replayFrameTimes);
+		std::cout << "replay: " << replayAllocations.count << " heap allocations (" << replayAllocations.bytes << " bytes) after the first frame" << std::endl;
+	}
+	else if (netClient)
+		netClient->Disconnect();
+	else
+		saveHighscore(sim.score, sim.highscore);
+	if (snapshotPath != "" && snapshotWriter.Wait())
+		std::cout << "saved snapshot to " << snapshotPath << std::endl;
+}
+
+void printFrameTimes(std::vector<float>& frameTimes)
+{
+	//the first frame's time is the loading
+	if (frameTimes.size() < 2)
+		return;
+	frameTimes.erase(frameTimes.begin());
+	std::sort(frameTimes.begin(), frameTimes.end());
+	double total = 0.0;
+	for (unsigned int i = 0; i < frameTimes.size(); i++)
+		total += frameTimes[i];
+	std::cout << "replay: " << frameTimes.size() << " frames, " << total * 1000.0 / frameTimes.size() << "ms average, "
+		<< frameTimes[frameTimes.size() / 2] * 1000.0f << "ms median, " << frameTimes[frameTimes.size() * 99 / 100] * 1000.0f
+		<< "ms 99th percentile, " << frameTimes.back() * 1000.0f << "ms worst" << std::endl;
 }
 
 void saveHighscore(int& score, int& highscore)
@@ -363,64 +830,6 @@ void saveHighscore(int& score, int& highscore)
 	hscoreFile.close();
 }
 
-void AddChunks(Camera& camera, std::vector<Chunk>& chunks, glm::vec3 currentSquare, int numChunks, float chunkWidth, float chunkHeight, Model& groundMdl, Model& treeMdl, std::mt19937& randomGen, std::uniform_real_distribution<float>& spawnXRange, std::uniform_real_distribution<float>& spawnZRange, std::uniform_int_distribution<int>& treeRange)
-{
-	//std::cout << "adding chunks" << std::endl;
-	glm::vec3 currentPos = glm::vec3(camera.getPos());
-	bool inSquare = false;
-	for (int i = -numChunks; i <= numChunks; i++)
-	{
-		for (int j = -numChunks; j <= numChunks; j++)
-		{
-			auto x = currentSquare.x + (float)i * chunkWidth;
-			auto z = currentSquare.z + (float)j * chunkHeight;
-
-			//std::cout << "x: " << x << std::endl;
-			//std::cout << "z: " << z << std::endl << std::endl;
-			//std::cout << "dist: " << glm::distance(camera.getPos(), glm::vec3(x, 0.0f, z)) << std::endl << std::endl;
-			bool chunkFound = false;
-			for (unsigned int k = 0; k < chunks.size(); k++)
-			{
-				if (chunks[k].getPos().x == x && chunks[k].getPos().z == z)
-					chunkFound = true;
-			}
-			if (!chunkFound)
-			{
-				//std::cout << "chunk added" << std::endl;
-				chunks.push_back(Chunk(glm::vec3(x, 0.0f, z), chunkWidth, chunkHeight, &groundMdl, &treeMdl, randomGen, spawnXRange, spawnZRange, treeRange));
-			}
-		}
-	}
-}
-
-void AddProjectile(std::vector<Projectile>& projectiles, Camera& camera, Model& projectileMdl, float& shotTimer, float SHOT_DELAY)
-{
-	if (shotTimer > SHOT_DELAY)
-	{
-		projectiles.push_back(Projectile(camera.getPos(), glm::normalize(camera.getFront()), &projectileMdl));
-		shotTimer = 0.0f;
-	}
-}
-
-void AddEnemies(std::vector<Enemy>& enemies, Model& enemyMdl ,Camera& camera, std::mt19937& randomGen, std::uniform_real_distribution<float>& spawnDirection, std::uniform_real_distribution<float>& spawnHeight, std::uniform_int_distribution<int>& spawnQuadrant)
-{
-		auto playerPos = camera.getPos();
-		auto direction = glm::vec3(spawnDirection(randomGen), spawnHeight(randomGen), spawnDirection(randomGen));
-		direction.x = cos(glm::radians(direction.x));
-		direction.z = sin(glm::radians(direction.z));
-		if (spawnQuadrant(randomGen) == 0)
-			direction.x *= -1;
-		if (spawnQuadrant(randomGen) == 0)
-			direction.z *= -1;
-		direction.x *= (camera.getRenderDistance() + 10.0f);
-		direction.z *= (camera.getRenderDistance() + 10.0f);
-		direction.x += playerPos.x;
-		direction.z += playerPos.z;
-		//std::cout << "x: " << direction.x << std::endl;
-		//std::cout << "z: " << direction.z << std::endl;
-		enemies.push_back(Enemy(direction, &enemyMdl));
-}
-
 static void error_callback(int error, const char* description)
 {
 	std::cout << stderr << "Error: %s\n" << description << std::endl;
@@ -431,9 +840,8 @@ static void key_callback(GLFWwindow* window, int key, int scancode, int action,
 {
 	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
 		glfwSetWindowShouldClose(window, GLFW_TRUE);
-}
-
-static void cursor_position_callback(GLFWwindow* window, double xpos, double ypos)
-{
-	
+	if (key == GLFW_KEY_F5 && action == GLFW_PRESS)
+		snapshotRequested = true;
+	if (key == GLFW_KEY_F6 && action == GLFW_PRESS)
+		pacingToggleRequested = true;
 }
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "mappedFile.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path)
+{
+#ifdef _WIN32
+	HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		std::cout << "failed to open " << path << std::endl;
+		return;
+	}
+	file = handle;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		std::cout << path << " is empty" << std::endl;
+		return;
+	}
+	mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		std::cout << "failed to map " << path << std::endl;
+		return;
+	}
+	data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		std::cout << "failed to map " << path << std::endl;
+		return;
+	}
+	size = (size_t)fileSize.QuadPart;
+#else
+	int descriptor = open(path.c_str(), O_RDONLY);
+	if (descriptor < 0)
+	{
+		std::cout << "failed to open " << path << std::endl;
+		return;
+	}
+	struct stat status;
+	if (fstat(descriptor, &status) != 0 || status.st_size == 0)
+	{
+		std::cout << path << " is empty" << std::endl;
+		close(descriptor);
+		return;
+	}
+	void* mapped = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	//the mapping keeps the file open on its own
+	close(descriptor);
+	if (mapped == MAP_FAILED)
+	{
+		std::cout << "failed to map " << path << std::endl;
+		return;
+	}
+	//it is read front to back straight away, so have the os read the lot now rather than a page at a time
+	madvise(mapped, (size_t)status.st_size, MADV_WILLNEED);
+	data = (const unsigned char*)mapped;
+	size = (size_t)status.st_size;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (data != nullptr)
+		UnmapViewOfFile(data);
+	if (mapping != nullptr)
+		CloseHandle(mapping);
+	if (file != nullptr)
+		CloseHandle(file);
+#else
+	if (data != nullptr)
+		munmap((void*)data, size);
+#endif
+}
+
+bool MappedFile::IsOpen()
+{
+	return data != nullptr;
+}
+
+const unsigned char* MappedFile::getData()
+{
+	return data;
+}
+
+size_t MappedFile::getSize()
+{
+	return size;
+}
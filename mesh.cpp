@@ -7,48 +7,155 @@
 
 #include <string>
 #include <vector>
+#include <cstddef>
+#include <utility>
 
 #include "shader.h"
 
-Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures)
-{
-	_vertices = vertices;
-	_indices = indices;
-	_textures = textures;
-	setupMesh();
-}
-
-void Mesh::Draw(Shader& shader)
+Mesh::Mesh(std::vector<Vertex>&& vertices, std::vector<unsigned int>&& indices, std::vector<Texture>&& textures, std::vector<MeshLod> lods, bool retainGeometry)
 {
+	_textures = std::move(textures);
+	//sampler names are worked out once here so drawing doesn't build strings
 	unsigned int numDiffuse = 1;
 	unsigned int numSpecular = 1;
-
 	for (unsigned int i = 0; i < _textures.size(); i++)
 	{
-		glActiveTexture(GL_TEXTURE0 + i);
-
 		std::string texNum;
 		std::string texName = _textures[i].type;
 		if (texName == "texture_diffuse")
 			texNum = std::to_string(numDiffuse++);
 		if (texName == "texture_specular")
 			texNum = std::to_string(numSpecular++);
+		textureUniforms.push_back(texName + texNum);
+	}
+	if (lods.empty())
+		lods.push_back({ 0, (unsigned int)indices.size(), 0.0f });
+	this->lods = std::move(lods);
+	setupMesh(vertices, indices);
+	if (retainGeometry)
+	{
+		_vertices = std::move(vertices);
+		_indices = std::move(indices);
+	}
+}
 
-		glUniform1i(shader.Location(texName + texNum), i);
-		glBindTexture(GL_TEXTURE_2D, _textures[0].id);
+Mesh::~Mesh()
+{
+	release();
+}
+
+Mesh::Mesh(Mesh&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+Mesh& Mesh::operator=(Mesh&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		_vertices = std::move(other._vertices);
+		_indices = std::move(other._indices);
+		_textures = std::move(other._textures);
+		textureUniforms = std::move(other.textureUniforms);
+		lods = std::move(other.lods);
+		indexType = other.indexType;
+		gpuBytes = other.gpuBytes;
+		VAO = other.VAO;
+		VBO = other.VBO;
+		EBO = other.EBO;
+		//the moved from mesh no longer owns any gl objects
+		other.lods.clear();
+		other.gpuBytes = 0;
+		other.VAO = 0;
+		other.VBO = 0;
+		other.EBO = 0;
 	}
-	
+	return *this;
+}
+
+void Mesh::release()
+{
+	if (VAO != 0)
+		glDeleteVertexArrays(1, &VAO);
+	if (VBO != 0)
+		glDeleteBuffers(1, &VBO);
+	if (EBO != 0)
+		glDeleteBuffers(1, &EBO);
+	VAO = VBO = EBO = 0;
+}
+
+void Mesh::Draw(Shader& shader, int lod)
+{
+	if (lods.empty())
+		return;
+	if (lod >= (int)lods.size())
+		lod = (int)lods.size() - 1;
+
+	BindTextures(shader);
 	glBindVertexArray(VAO);
-	glDrawElements(GL_TRIANGLES, _indices.size(), GL_UNSIGNED_INT, 0);
+	size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+	glDrawElements(GL_TRIANGLES, lods[lod].indexCount, indexType, (void*)(lods[lod].indexOffset * indexSize));
 	glBindVertexArray(0);
 
 	glActiveTexture(GL_TEXTURE0);
 }
 
+void Mesh::BindTextures(Shader& shader) const
+{
+	for (unsigned int i = 0; i < _textures.size(); i++)
+	{
+		glActiveTexture(GL_TEXTURE0 + i);
+		glUniform1i(shader.Location(textureUniforms[i].c_str()), i);
+		glBindTexture(GL_TEXTURE_2D, _textures[0].id);
+	}
+}
+
+
+
+int Mesh::getLodCount() const
+{
+	return (int)lods.size();
+}
+
+const MeshLod& Mesh::getLod(int lod) const
+{
+	return lods[lod];
+}
+
+const std::vector<Vertex>& Mesh::getVertices() const
+{
+	return _vertices;
+}
+
+const std::vector<unsigned int>& Mesh::getIndices() const
+{
+	return _indices;
+}
+
+const std::vector<Texture>& Mesh::getTextures() const
+{
+	return _textures;
+}
 
+size_t Mesh::getGpuBytes() const
+{
+	return gpuBytes;
+}
 
-void Mesh::setupMesh()
+size_t Mesh::getRetainedBytes() const
 {
+	return _vertices.capacity() * sizeof(Vertex) + _indices.capacity() * sizeof(unsigned int);
+}
+
+void Mesh::setupMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
+{
+	//16 bit indices halve the index buffer whenever every vertex can be addressed with them
+	if (vertices.size() <= 0xFFFF)
+		indexType = GL_UNSIGNED_SHORT;
+	else
+		indexType = GL_UNSIGNED_INT;
+
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
 	glGenBuffers(1, &EBO);
@@ -56,10 +163,22 @@ void Mesh::setupMesh()
 	glBindVertexArray(VAO);
 
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, _vertices.size() * sizeof(Vertex), &_vertices[0], GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indices.size() * sizeof(unsigned int), &_indices[0], GL_STATIC_DRAW);
+	size_t indexBytes;
+	if (indexType == GL_UNSIGNED_SHORT)
+	{
+		std::vector<unsigned short> shortIndices(indices.begin(), indices.end());
+		indexBytes = shortIndices.size() * sizeof(unsigned short);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, shortIndices.data(), GL_STATIC_DRAW);
+	}
+	else
+	{
+		indexBytes = indices.size() * sizeof(unsigned int);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, indices.data(), GL_STATIC_DRAW);
+	}
+	gpuBytes = vertices.size() * sizeof(Vertex) + indexBytes;
 
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
@@ -8,6 +8,7 @@
 
 #include <string>
 #include <vector>
+#include <cstddef>
 
 #include "shader.h"
 
@@ -31,18 +32,50 @@ struct Texture {
     std::string path;
 };
 
+// a range of the index buffer, lod 0 is the full detail mesh
+struct MeshLod {
+    unsigned int indexOffset;
+    unsigned int indexCount;
+    float error;
+};
+
+// owns its vertex array and buffers, so it can be moved but not copied.
+// texture ids are shared and owned by the AssetRegistry
 class Mesh
 {
 public:
-    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures);
-    void Draw(Shader& shader);
+    // geometry is uploaded then dropped, unless retainGeometry is set.
+    // indices holds every lod back to back, an empty lods list means a single lod covering all of them
+    Mesh(std::vector<Vertex>&& vertices, std::vector<unsigned int>&& indices, std::vector<Texture>&& textures, std::vector<MeshLod> lods, bool retainGeometry = false);
+    ~Mesh();
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    Mesh(Mesh&& other) noexcept;
+    Mesh& operator=(Mesh&& other) noexcept;
+
+    void Draw(Shader& shader, int lod = 0);
+    // binds the textures to the shader's samplers, for drawing this mesh's geometry from another buffer
+    void BindTextures(Shader& shader) const;
+    int getLodCount() const;
+    const MeshLod& getLod(int lod) const;
+    const std::vector<Vertex>& getVertices() const;
+    const std::vector<unsigned int>& getIndices() const;
+    const std::vector<Texture>& getTextures() const;
+    size_t getGpuBytes() const;
+    size_t getRetainedBytes() const;
 private:
     std::vector<Vertex> _vertices;
     std::vector<unsigned int> _indices;
     std::vector<Texture> _textures;
+    // "texture_diffuse1" and so on, one per texture
+    std::vector<std::string> textureUniforms;
 
-    unsigned int VAO, VBO, EBO;
-    void setupMesh();
+    std::vector<MeshLod> lods;
+    GLenum indexType = GL_UNSIGNED_INT;
+    size_t gpuBytes = 0;
+    unsigned int VAO = 0, VBO = 0, EBO = 0;
+    void setupMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+    void release();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "meshOptimizer.h"
+
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+#include <cstddef>
+
+#include "mesh.h"
+
+namespace
+{
+	//only the attributes uploaded by Mesh::setupMesh take part in welding
+	struct VertexKey
+	{
+		float data[8];
+		bool operator==(const VertexKey& other) const
+		{
+			return std::memcmp(data, other.data, sizeof(data)) == 0;
+		}
+	};
+
+	struct VertexKeyHash
+	{
+		size_t operator()(const VertexKey& key) const
+		{
+			unsigned int bits[8];
+			std::memcpy(bits, key.data, sizeof(bits));
+			size_t hash = 2166136261u;
+			for (unsigned int i = 0; i < 8; i++)
+				hash = (hash ^ bits[i]) * 16777619u;
+			return hash;
+		}
+	};
+
+	VertexKey makeKey(const Vertex& vertex)
+	{
+		VertexKey key;
+		key.data[0] = vertex.Position.x;
+		key.data[1] = vertex.Position.y;
+		key.data[2] = vertex.Position.z;
+		key.data[3] = vertex.Normal.x;
+		key.data[4] = vertex.Normal.y;
+		key.data[5] = vertex.Normal.z;
+		key.data[6] = vertex.TexCoords.x;
+		key.data[7] = vertex.TexCoords.y;
+		//-0.0 and 0.0 should weld together
+		for (unsigned int i = 0; i < 8; i++)
+			if (key.data[i] == 0.0f)
+				key.data[i] = 0.0f;
+		return key;
+	}
+}
+
+MeshOptimizeStats OptimizeMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	MeshOptimizeStats stats;
+	stats.verticesBefore = (unsigned int)vertices.size();
+	stats.acmrBefore = CalculateACMR(indices, (unsigned int)vertices.size(), VERTEX_CACHE_SIZE);
+
+	WeldVertices(vertices, indices);
+	OptimizeVertexCache(indices, (unsigned int)vertices.size(), VERTEX_CACHE_SIZE);
+	OptimizeVertexFetch(vertices, indices);
+
+	stats.verticesAfter = (unsigned int)vertices.size();
+	stats.acmrAfter = CalculateACMR(indices, (unsigned int)vertices.size(), VERTEX_CACHE_SIZE);
+	return stats;
+}
+
+void WeldVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	std::unordered_map<VertexKey, unsigned int, VertexKeyHash> unique;
+	unique.reserve(vertices.size());
+	std::vector<unsigned int> remap(vertices.size());
+	unsigned int uniqueCount = 0;
+	for (unsigned int i = 0; i < vertices.size(); i++)
+	{
+		auto inserted = unique.emplace(makeKey(vertices[i]), uniqueCount);
+		if (inserted.second)
+			vertices[uniqueCount++] = vertices[i];
+		remap[i] = inserted.first->second;
+	}
+	vertices.resize(uniqueCount);
+	for (unsigned int i = 0; i < indices.size(); i++)
+		indices[i] = remap[indices[i]];
+}
+
+void OptimizeVertexCache(std::vector<unsigned int>& indices, unsigned int vertexCount, unsigned int cacheSize)
+{
+	unsigned int triangleCount = (unsigned int)indices.size() / 3;
+	if (triangleCount == 0 || vertexCount == 0)
+		return;
+
+	//vertex to triangle adjacency, packed
+	std::vector<unsigned int> liveTriangles(vertexCount, 0);
+	for (unsigned int i = 0; i < triangleCount * 3; i++)
+		liveTriangles[indices[i]]++;
+	std::vector<unsigned int> offsets(vertexCount + 1, 0);
+	for (unsigned int i = 0; i < vertexCount; i++)
+		offsets[i + 1] = offsets[i] + liveTriangles[i];
+	std::vector<unsigned int> adjacency(offsets[vertexCount]);
+	std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+	for (unsigned int i = 0; i < triangleCount * 3; i++)
+		adjacency[fill[indices[i]]++] = i / 3;
+
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<unsigned int> deadEnd;
+	std::vector<unsigned int> candidates;
+	std::vector<unsigned int> output;
+	output.reserve(triangleCount * 3);
+
+	unsigned int timeStamp = cacheSize + 1;
+	unsigned int cursor = 1;
+	int fanning = 0;
+	while (fanning >= 0)
+	{
+		candidates.clear();
+		for (unsigned int i = offsets[fanning]; i < offsets[fanning + 1]; i++)
+		{
+			unsigned int triangle = adjacency[i];
+			if (emitted[triangle])
+				continue;
+			for (unsigned int j = 0; j < 3; j++)
+			{
+				unsigned int vertex = indices[triangle * 3 + j];
+				output.push_back(vertex);
+				deadEnd.push_back(vertex);
+				candidates.push_back(vertex);
+				liveTriangles[vertex]--;
+				if (timeStamp - cacheTime[vertex] > cacheSize)
+					cacheTime[vertex] = timeStamp++;
+			}
+			emitted[triangle] = true;
+		}
+
+		//prefer the candidate that will still be in the cache after its remaining triangles are emitted
+		fanning = -1;
+		int bestPriority = -1;
+		for (unsigned int i = 0; i < candidates.size(); i++)
+		{
+			unsigned int vertex = candidates[i];
+			if (liveTriangles[vertex] == 0)
+				continue;
+			int priority = 0;
+			if (timeStamp - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+				priority = (int)(timeStamp - cacheTime[vertex]);
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				fanning = (int)vertex;
+			}
+		}
+
+		//dead end, restart from a recently used vertex or else the next one in input order
+		while (fanning < 0 && !deadEnd.empty())
+		{
+			unsigned int vertex = deadEnd.back();
+			deadEnd.pop_back();
+			if (liveTriangles[vertex] > 0)
+				fanning = (int)vertex;
+		}
+		while (fanning < 0 && cursor < vertexCount)
+		{
+			if (liveTriangles[cursor] > 0)
+				fanning = (int)cursor;
+			cursor++;
+		}
+	}
+	indices.swap(output);
+}
+
+void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	const unsigned int UNUSED = 0xFFFFFFFF;
+	std::vector<unsigned int> remap(vertices.size(), UNUSED);
+	std::vector<Vertex> ordered;
+	ordered.reserve(vertices.size());
+	for (unsigned int i = 0; i < indices.size(); i++)
+	{
+		unsigned int& newIndex = remap[indices[i]];
+		if (newIndex == UNUSED)
+		{
+			newIndex = (unsigned int)ordered.size();
+			ordered.push_back(vertices[indices[i]]);
+		}
+		indices[i] = newIndex;
+	}
+	vertices.swap(ordered);
+}
+
+float CalculateACMR(const std::vector<unsigned int>& indices, unsigned int vertexCount, unsigned int cacheSize)
+{
+	unsigned int triangleCount = (unsigned int)indices.size() / 3;
+	if (triangleCount == 0)
+		return 0.0f;
+
+	//fifo cache, a vertex is in the cache if it was pushed within the last cacheSize misses
+	std::vector<unsigned int> pushedAt(vertexCount, 0);
+	unsigned int misses = 0;
+	for (unsigned int i = 0; i < triangleCount * 3; i++)
+	{
+		unsigned int vertex = indices[i];
+		if (pushedAt[vertex] == 0 || misses - pushedAt[vertex] >= cacheSize)
+		{
+			misses++;
+			pushedAt[vertex] = misses;
+		}
+	}
+	return (float)misses / (float)triangleCount;
+}
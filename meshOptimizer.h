@@ -0,0 +1,31 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <vector>
+
+#include "mesh.h"
+
+struct MeshOptimizeStats
+{
+	unsigned int verticesBefore = 0;
+	unsigned int verticesAfter = 0;
+	float acmrBefore = 0.0f;
+	float acmrAfter = 0.0f;
+};
+
+//size of the fifo post transform cache the reordering targets and acmr is measured against
+const unsigned int VERTEX_CACHE_SIZE = 16;
+
+//runs every pass below in order, indices must be a triangle list
+MeshOptimizeStats OptimizeMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+//merges vertices with identical attributes and remaps the indices to them
+void WeldVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+//tipsify (Sander, Nehab, Barczak 2007), reorders triangles to reuse recently transformed vertices
+void OptimizeVertexCache(std::vector<unsigned int>& indices, unsigned int vertexCount, unsigned int cacheSize);
+//reorders vertices into the order the indices first use them, dropping unreferenced ones
+void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+//average cache miss ratio, vertex shader invocations per triangle for a fifo cache
+float CalculateACMR(const std::vector<unsigned int>& indices, unsigned int vertexCount, unsigned int cacheSize);
+
+#endif
@@ -0,0 +1,220 @@
+#include "meshSimplifier.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <queue>
+#include <map>
+#include <utility>
+#include <cmath>
+
+#include "mesh.h"
+
+namespace
+{
+	//symmetric 4x4 matrix, the upper triangle is stored
+	struct Quadric
+	{
+		double a[10] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+		void addPlane(double x, double y, double z, double d, double weight)
+		{
+			a[0] += weight * x * x; a[1] += weight * x * y; a[2] += weight * x * z; a[3] += weight * x * d;
+			a[4] += weight * y * y; a[5] += weight * y * z; a[6] += weight * y * d;
+			a[7] += weight * z * z; a[8] += weight * z * d;
+			a[9] += weight * d * d;
+		}
+		void add(const Quadric& other)
+		{
+			for (unsigned int i = 0; i < 10; i++)
+				a[i] += other.a[i];
+		}
+		double evaluate(const glm::vec3& p) const
+		{
+			double x = p.x, y = p.y, z = p.z;
+			double result = a[0] * x * x + 2 * a[1] * x * y + 2 * a[2] * x * z + 2 * a[3] * x
+				+ a[4] * y * y + 2 * a[5] * y * z + 2 * a[6] * y
+				+ a[7] * z * z + 2 * a[8] * z
+				+ a[9];
+			return result > 0.0 ? result : 0.0;
+		}
+	};
+
+	struct Collapse
+	{
+		double cost;
+		unsigned int from, to;
+		unsigned int fromVersion, toVersion;
+		bool operator>(const Collapse& other) const
+		{
+			return cost > other.cost;
+		}
+	};
+}
+
+std::vector<unsigned int> SimplifyMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, unsigned int targetIndexCount, float* error)
+{
+	std::vector<unsigned int> triangles(indices);
+	unsigned int vertexCount = (unsigned int)vertices.size();
+	unsigned int triangleCount = (unsigned int)triangles.size() / 3;
+	unsigned int liveCount = triangleCount;
+	if (error)
+		*error = 0.0f;
+	if (triangleCount * 3 <= targetIndexCount)
+		return triangles;
+
+	std::vector<Quadric> quadrics(vertexCount);
+	std::vector<std::vector<unsigned int>> vertexTriangles(vertexCount);
+	std::vector<bool> triangleAlive(triangleCount, true);
+	for (unsigned int t = 0; t < triangleCount; t++)
+	{
+		glm::vec3 p0 = vertices[triangles[t * 3]].Position;
+		glm::vec3 p1 = vertices[triangles[t * 3 + 1]].Position;
+		glm::vec3 p2 = vertices[triangles[t * 3 + 2]].Position;
+		glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+		float area = glm::length(normal);
+		if (area > 0.0f)
+		{
+			normal /= area;
+			for (unsigned int j = 0; j < 3; j++)
+				quadrics[triangles[t * 3 + j]].addPlane(normal.x, normal.y, normal.z, -glm::dot(normal, p0), area * 0.5);
+		}
+		for (unsigned int j = 0; j < 3; j++)
+			vertexTriangles[triangles[t * 3 + j]].push_back(t);
+	}
+
+	//lock seam vertices (same position, different attributes) and open border vertices
+	std::vector<bool> locked(vertexCount, false);
+	std::map<std::pair<float, std::pair<float, float>>, unsigned int> positions;
+	for (unsigned int i = 0; i < vertexCount; i++)
+	{
+		auto key = std::make_pair(vertices[i].Position.x, std::make_pair(vertices[i].Position.y, vertices[i].Position.z));
+		auto inserted = positions.emplace(key, i);
+		if (!inserted.second)
+		{
+			locked[i] = true;
+			locked[inserted.first->second] = true;
+		}
+	}
+	std::map<std::pair<unsigned int, unsigned int>, unsigned int> edgeUses;
+	for (unsigned int t = 0; t < triangleCount; t++)
+	{
+		for (unsigned int j = 0; j < 3; j++)
+		{
+			unsigned int a = triangles[t * 3 + j];
+			unsigned int b = triangles[t * 3 + (j + 1) % 3];
+			edgeUses[std::make_pair(a < b ? a : b, a < b ? b : a)]++;
+		}
+	}
+	for (auto& edge : edgeUses)
+	{
+		if (edge.second == 1)
+		{
+			locked[edge.first.first] = true;
+			locked[edge.first.second] = true;
+		}
+	}
+
+	std::vector<unsigned int> version(vertexCount, 0);
+	std::vector<bool> removed(vertexCount, false);
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+	auto pushCollapse = [&](unsigned int from, unsigned int to)
+	{
+		if (locked[from])
+			return;
+		Quadric merged = quadrics[from];
+		merged.add(quadrics[to]);
+		queue.push({ merged.evaluate(vertices[to].Position), from, to, version[from], version[to] });
+	};
+	for (auto& edge : edgeUses)
+	{
+		pushCollapse(edge.first.first, edge.first.second);
+		pushCollapse(edge.first.second, edge.first.first);
+	}
+
+	double maxCost = 0.0;
+	while (liveCount * 3 > targetIndexCount && !queue.empty())
+	{
+		Collapse collapse = queue.top();
+		queue.pop();
+		unsigned int from = collapse.from;
+		unsigned int to = collapse.to;
+		if (removed[from] || removed[to] || collapse.fromVersion != version[from] || collapse.toVersion != version[to])
+			continue;
+
+		//reject collapses that would flip or squash any triangle that survives them
+		bool valid = true;
+		for (unsigned int i = 0; i < vertexTriangles[from].size() && valid; i++)
+		{
+			unsigned int t = vertexTriangles[from][i];
+			if (!triangleAlive[t])
+				continue;
+			unsigned int* tri = &triangles[t * 3];
+			if (tri[0] == to || tri[1] == to || tri[2] == to)
+				continue;
+			glm::vec3 before[3], after[3];
+			for (unsigned int j = 0; j < 3; j++)
+			{
+				before[j] = vertices[tri[j]].Position;
+				after[j] = tri[j] == from ? vertices[to].Position : before[j];
+			}
+			glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+			glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+			float lengthAfter = glm::length(normalAfter);
+			if (lengthAfter < 1e-12f || glm::dot(normalBefore, normalAfter) < 0.25f * glm::length(normalBefore) * lengthAfter)
+				valid = false;
+		}
+		if (!valid)
+			continue;
+
+		for (unsigned int i = 0; i < vertexTriangles[from].size(); i++)
+		{
+			unsigned int t = vertexTriangles[from][i];
+			if (!triangleAlive[t])
+				continue;
+			unsigned int* tri = &triangles[t * 3];
+			if (tri[0] == to || tri[1] == to || tri[2] == to)
+			{
+				triangleAlive[t] = false;
+				liveCount--;
+				continue;
+			}
+			for (unsigned int j = 0; j < 3; j++)
+				if (tri[j] == from)
+					tri[j] = to;
+			vertexTriangles[to].push_back(t);
+		}
+		removed[from] = true;
+		quadrics[to].add(quadrics[from]);
+		version[to]++;
+		if (collapse.cost > maxCost)
+			maxCost = collapse.cost;
+
+		//edges touching the kept vertex have new costs, older entries for them are now stale
+		for (unsigned int i = 0; i < vertexTriangles[to].size(); i++)
+		{
+			unsigned int t = vertexTriangles[to][i];
+			if (!triangleAlive[t])
+				continue;
+			for (unsigned int j = 0; j < 3; j++)
+			{
+				unsigned int other = triangles[t * 3 + j];
+				if (other == to)
+					continue;
+				pushCollapse(other, to);
+				pushCollapse(to, other);
+			}
+		}
+	}
+
+	std::vector<unsigned int> result;
+	result.reserve(liveCount * 3);
+	for (unsigned int t = 0; t < triangleCount; t++)
+	{
+		if (triangleAlive[t])
+			result.insert(result.end(), triangles.begin() + t * 3, triangles.begin() + t * 3 + 3);
+	}
+	if (error)
+		*error = (float)std::sqrt(maxCost);
+	return result;
+}
@@ -0,0 +1,14 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <vector>
+
+#include "mesh.h"
+
+//quadric error edge collapse (Garland, Heckbert 1997) restricted to half edge collapses,
+//so the result only indexes the original vertices and every lod can share one vertex buffer.
+//vertices on uv seams and open borders are never moved so the outline and texturing stay intact.
+//returns the simplified triangle list, error is set to the square root of the largest collapse cost
+std::vector<unsigned int> SimplifyMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, unsigned int targetIndexCount, float* error = nullptr);
+
+#endif
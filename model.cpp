@@ -16,31 +16,69 @@
 #include <iostream>
 #include <map>
 #include <vector>
+#include <cstring>
+#include <utility>
 
 #include "mesh.h"
 #include "shader.h"
+#include "assetRegistry.h"
+#include "meshOptimizer.h"
+#include "meshSimplifier.h"
 
-Model::Model(std::string const& path)
+Model::Model(std::string const& path, AssetRegistry& registry, bool retainGeometry, std::vector<float> lodRatios)
 {
+	this->registry = &registry;
+	this->retainGeometry = retainGeometry;
+	this->lodRatios = std::move(lodRatios);
 	loadModel(path);
 }
 
-void Model::Draw(Shader& shader)
+void Model::Draw(Shader& shader, int lod)
 {
 	for (unsigned int i = 0; i < meshes.size(); i++)
-		meshes[i].Draw(shader);
+		meshes[i].Draw(shader, lod);
+}
+
+const std::vector<Mesh>& Model::getMeshes() const
+{
+	return meshes;
+}
+
+int Model::getLodCount() const
+{
+	int lodCount = 1;
+	for (unsigned int i = 0; i < meshes.size(); i++)
+		if (meshes[i].getLodCount() > lodCount)
+			lodCount = meshes[i].getLodCount();
+	return lodCount;
+}
+
+float Model::getRadius() const
+{
+	return radius;
+}
+
+glm::vec3 Model::getBoundsMin() const
+{
+	return boundsMin;
+}
+
+glm::vec3 Model::getBoundsMax() const
+{
+	return boundsMax;
 }
 
 void Model::loadModel(std::string const& path)
 {
 	Assimp::Importer importer;
-	const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs);
+	const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals | aiProcess_FlipUVs);
 	if (!scene)
 	{
 		std::cout << "ERROR::ASSIMP" << importer.GetErrorString() << std::endl;
 		return;
 	}
 	directory = path.substr(0, path.find_last_of('/'));
+	this->path = path;
 	processNode(scene->mRootNode, scene);
 }
 
@@ -65,6 +103,8 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
 	std::vector<Vertex> vertices;
 	std::vector<unsigned int> indices;
 	std::vector<Texture> textures;
+	vertices.reserve(mesh->mNumVertices);
+	indices.reserve(mesh->mNumFaces * 3);
 
 	for (unsigned int i = 0; i < mesh->mNumVertices; i++)
 	{
@@ -100,6 +140,16 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
 		
 
 		vertices.push_back(vertex);
+		float vertexDistance = glm::length(vertex.Position);
+		if (vertexDistance > radius)
+			radius = vertexDistance;
+		if (meshes.empty() && vertices.size() == 1)
+		{
+			boundsMin = vertex.Position;
+			boundsMax = vertex.Position;
+		}
+		boundsMin = glm::min(boundsMin, vertex.Position);
+		boundsMax = glm::max(boundsMax, vertex.Position);
 	}
 
 	for (unsigned int i = 0; i < mesh->mNumFaces; i++)
@@ -109,6 +159,28 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
 			indices.push_back(face.mIndices[j]);
 	}
 
+	auto stats = OptimizeMesh(vertices, indices);
+	std::cout << path << " mesh " << meshes.size() << ": vertices " << stats.verticesBefore << " -> " << stats.verticesAfter
+		<< ", ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter << std::endl;
+
+	//simplified lods are appended to the same index buffer and reuse the full detail vertices
+	std::vector<MeshLod> lods;
+	lods.push_back({ 0, (unsigned int)indices.size(), 0.0f });
+	unsigned int fullIndexCount = (unsigned int)indices.size();
+	for (unsigned int i = 0; i < lodRatios.size(); i++)
+	{
+		std::vector<unsigned int> fullDetail(indices.begin(), indices.begin() + fullIndexCount);
+		unsigned int target = (unsigned int)(fullIndexCount * lodRatios[i]) / 3 * 3;
+		float error;
+		std::vector<unsigned int> lodIndices = SimplifyMesh(vertices, fullDetail, target, &error);
+		if (lodIndices.size() >= lods.back().indexCount)
+			break;
+		OptimizeVertexCache(lodIndices, (unsigned int)vertices.size(), VERTEX_CACHE_SIZE);
+		lods.push_back({ (unsigned int)indices.size(), (unsigned int)lodIndices.size(), error });
+		indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+		std::cout << "    lod " << lods.size() - 1 << ": " << lodIndices.size() / 3 << " triangles, error " << error << std::endl;
+	}
+
 	aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
 
 	std::vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
@@ -117,7 +189,7 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
 	std::vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
 	textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
 
-	return Mesh(vertices, indices, textures);
+	return Mesh(std::move(vertices), std::move(indices), std::move(textures), std::move(lods), retainGeometry);
 }
 
 std::vector<Texture> Model::loadMaterialTextures(aiMaterial* material, aiTextureType type, std::string typeName)
@@ -129,63 +201,12 @@ std::vector<Texture> Model::loadMaterialTextures(aiMaterial* material, aiTexture
 		aiString str;
 		material->GetTexture(type, i, &str);
 
-		bool skip = false;
-		for (unsigned int j = 0; j < loadedTextures.size(); j++)
-		{
-			if (std::strcmp(loadedTextures[j].path.data(), str.C_Str()) == 0)
-			{
-				textures.push_back(loadedTextures[j]);
-				skip = true;
-				break;
-			}
-		}
-		if (!skip)
-		{
-			Texture texture;
-			texture.id = TextureFromFile(str.C_Str(), this->directory);
-			texture.type = typeName;
-			texture.path = str.C_Str();
-			textures.push_back(texture);
-			loadedTextures.push_back(texture);
-		}
+		//the registry only loads each file once, however many meshes and models use it
+		Texture texture;
+		texture.id = registry->LoadTexture(directory + '/' + str.C_Str());
+		texture.type = typeName;
+		texture.path = str.C_Str();
+		textures.push_back(texture);
 	}
 	return textures;
 }
-
-unsigned int Model::TextureFromFile(const char* path, const std::string& directory)
-{
-	std::string filename = std::string(path);
-	filename = directory + '/' + filename;
-	unsigned int textureID;
-	glGenTextures(1, &textureID);
-
-	int width, height, numChannels;
-	stbi_set_flip_vertically_on_load(true);
-	unsigned char* data = stbi_load(filename.c_str(), &width, &height, &numChannels, 0);
-	if (data)
-	{
-		GLenum format = GL_RGBA;
-		if (numChannels == 1)
-			format = GL_RED;
-		if (numChannels == 3)
-			format = GL_RGB;
-		if (numChannels == 4)
-			format = GL_RGBA;
-
-		glBindTexture(GL_TEXTURE_2D, textureID);
-		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	}
-	else
-	{
-		std::cout << "failed to load texture" << path << std::endl;
-	}
-
-	stbi_image_free(data);
-	return textureID;
-}
@@ -20,23 +20,42 @@
 #include "shader.h"
 #include "mesh.h"
 
+class AssetRegistry;
+
+//move only, models are loaded once through the AssetRegistry and shared by pointer
 class Model
 {
 public:
 	Model() {}
-	Model(std::string const& path);
-	void Draw(Shader& shader);
+	//each lod ratio adds a simplified lod with that fraction of the full detail triangles
+	Model(std::string const& path, AssetRegistry& registry, bool retainGeometry = false, std::vector<float> lodRatios = std::vector<float>());
+	Model(const Model&) = delete;
+	Model& operator=(const Model&) = delete;
+	Model(Model&&) = default;
+	Model& operator=(Model&&) = default;
+	void Draw(Shader& shader, int lod = 0);
+	const std::vector<Mesh>& getMeshes() const;
+	int getLodCount() const;
+	//furthest any vertex is from the model origin
+	float getRadius() const;
+	glm::vec3 getBoundsMin() const;
+	glm::vec3 getBoundsMax() const;
 
 private:
-	std::vector<Texture> loadedTextures;
 	std::vector<Mesh> meshes;
 	std::string directory;
+	std::string path;
+	AssetRegistry* registry = nullptr;
+	bool retainGeometry = false;
+	std::vector<float> lodRatios;
+	float radius = 0.0f;
+	glm::vec3 boundsMin = glm::vec3(0.0f);
+	glm::vec3 boundsMax = glm::vec3(0.0f);
 
 	void loadModel(std::string const& path);
 	void processNode(aiNode* node, const aiScene* scene);
 	Mesh processMesh(aiMesh* mesh, const aiScene* scene);
 	std::vector<Texture> loadMaterialTextures(aiMaterial* material, aiTextureType type, std::string typeName);
-	unsigned int TextureFromFile(const char* path, const std::string& directory);
 };
 
 
@@ -0,0 +1,323 @@
+#include "netClient.h"
+
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <thread>
+#include <algorithm>
+
+#include "netPacket.h"
+
+namespace
+{
+	const std::chrono::milliseconds HELLO_INTERVAL(100);
+	const unsigned int BYE_REPEATS = 3;
+}
+
+NetClient::NetClient(unsigned short serverPort)
+	: serverPort(serverPort),
+	history(new NetSnapshot[SNAPSHOT_HISTORY]),
+	sent(new SentCommand[COMMAND_HISTORY])
+{
+	packet.reserve(NET_MAX_PACKET);
+	received.resize(NET_MAX_PACKET);
+	chunkPositions.reserve(NetSnapshot::MAX_CHUNKS);
+	chunkSeeds.reserve(NetSnapshot::MAX_CHUNKS);
+	previousLods.reserve(NetSnapshot::MAX_ENEMIES);
+}
+
+bool NetClient::Connect(float timeout, NetWelcome& welcome)
+{
+	if (!socket.IsOpen())
+		return false;
+	auto start = std::chrono::steady_clock::now();
+	auto nextHello = start;
+	NetPacketWriter writer(packet);
+	while (std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() < timeout)
+	{
+		if (std::chrono::steady_clock::now() >= nextHello)
+		{
+			writer.Begin(NET_HELLO);
+			socket.Send(serverPort, packet.data(), packet.size());
+			nextHello += HELLO_INTERVAL;
+		}
+		unsigned short fromPort;
+		int size;
+		while ((size = socket.Receive(received.data(), received.size(), fromPort)) >= 0)
+		{
+			NetPacketReader reader(received.data(), (size_t)size);
+			NetMessage type;
+			if (fromPort != serverPort || !reader.Begin(type) || type != NET_WELCOME)
+				continue;
+			if (reader.Get(welcome.seed) && reader.Get(welcome.tickTime) && reader.Get(welcome.flocking) &&
+				reader.Get(welcome.stressEnemies) && reader.Get(welcome.chunkRadius) && welcome.tickTime > 0.0f)
+			{
+				tickTime = welcome.tickTime;
+				connected = true;
+				lastHeard = std::chrono::steady_clock::now();
+				return true;
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	std::cout << "no server answered on port " << serverPort << std::endl;
+	return false;
+}
+
+void NetClient::Tick(Simulation& mirror, InputSource& input)
+{
+	if (!connected)
+		return;
+	stats.ticks++;
+	receive();
+	reconcile(mirror);
+
+	//this tick's input moves the camera straight away, the server runs it when it arrives
+	commandTick++;
+	SentCommand& command = sent[commandTick % COMMAND_HISTORY];
+	command.command = CommandInput::Sample(input, commandTick);
+	command.sentAt = std::chrono::steady_clock::now();
+	sendInput();
+	mirror.camera.SaveState();
+	commandInput.command = command.command;
+	mirror.Look(commandInput, tickTime);
+	mirror.camera.KeyHandler(commandInput, tickTime);
+	command.predicted = mirror.camera.getPos();
+
+	//the drawn snapshot moves on a tick at a time, a few behind the newest
+	if (renderTick == 0)
+	{
+		if (newestTick > INTERPOLATION_TICKS)
+			renderTick = newestTick - INTERPOLATION_TICKS;
+	}
+	else
+		renderTick++;
+	if (renderTick > newestTick)
+	{
+		renderTick = newestTick;
+		stats.starvedTicks++;
+	}
+	else if (newestTick - renderTick > MAX_INTERPOLATION_TICKS)
+		renderTick = newestTick - INTERPOLATION_TICKS;
+	if (renderTick == 0)
+		return;
+	stats.interpolationTicks += newestTick - renderTick;
+
+	const NetSnapshot& current = history[renderTick % SNAPSHOT_HISTORY];
+	const NetSnapshot& previous = history[(renderTick - 1) % SNAPSHOT_HISTORY];
+	if (renderTick == mirroredTick)
+	{
+		//waiting on the server, everything holds where it is rather than going back a tick
+		mirror.enemies.SaveState();
+		mirror.projectiles.SaveState();
+		mirror.impacts.clear();
+	}
+	else if (current.tick == renderTick)
+		mirrorSnapshot(mirror, current, previous.tick == renderTick - 1 ? &previous : nullptr);
+	else
+	{
+		stats.missingTicks++;
+		mirror.enemies.SaveState();
+		mirror.projectiles.SaveState();
+		mirror.impacts.clear();
+	}
+}
+
+void NetClient::receive()
+{
+	unsigned short fromPort;
+	int size;
+	while ((size = socket.Receive(received.data(), received.size(), fromPort)) >= 0)
+	{
+		NetPacketReader reader(received.data(), (size_t)size);
+		NetMessage type;
+		if (fromPort != serverPort || !reader.Begin(type))
+			continue;
+		lastHeard = std::chrono::steady_clock::now();
+		if (type == NET_BYE)
+		{
+			serverLeft = true;
+			continue;
+		}
+		if (type != NET_SNAPSHOT)
+			continue;
+
+		unsigned long long tick, baselineTick;
+		if (!NetSnapshot::ReadTicks(reader, tick, baselineTick))
+		{
+			stats.damagedSnapshots++;
+			continue;
+		}
+		//late ones that have already been passed are no use
+		NetSnapshot& slot = history[tick % SNAPSHOT_HISTORY];
+		if (tick <= renderTick || slot.tick == tick || tick + SNAPSHOT_HISTORY <= newestTick)
+			continue;
+		const NetSnapshot* baseline = nullptr;
+		if (baselineTick != 0)
+		{
+			baseline = &history[baselineTick % SNAPSHOT_HISTORY];
+			if (baseline->tick != baselineTick)
+			{
+				stats.damagedSnapshots++;
+				continue;
+			}
+		}
+		else
+			stats.fullSnapshots++;
+		if (!slot.Decode(reader, baseline))
+		{
+			slot.tick = 0;
+			stats.damagedSnapshots++;
+			continue;
+		}
+		stats.snapshots++;
+		stats.bytes += (unsigned long long)size;
+		stats.serverTickMilliseconds += slot.tickMicros / 1000.0;
+		if (tick > newestTick)
+			newestTick = tick;
+	}
+}
+
+void NetClient::reconcile(Simulation& mirror)
+{
+	if (newestTick == reconciledTick)
+		return;
+	reconciledTick = newestTick;
+	const NetSnapshot& snapshot = history[newestTick % SNAPSHOT_HISTORY];
+	unsigned int inputTick = snapshot.inputTick;
+	//commands this old have gone from the history, the server has fallen too far behind to replay them
+	if (inputTick == 0 || commandTick - inputTick >= COMMAND_HISTORY)
+		return;
+	const SentCommand& ran = sent[inputTick % COMMAND_HISTORY];
+	float error = glm::distance(ran.predicted, snapshot.camera.position);
+	stats.predictionError += error;
+	stats.worstPredictionError = std::max(stats.worstPredictionError, error);
+	stats.predictions++;
+	if (inputTick > lastRoundTripTick)
+	{
+		lastRoundTripTick = inputTick;
+		float roundTrip = std::chrono::duration<float>(std::chrono::steady_clock::now() - ran.sentAt).count();
+		stats.roundTripSeconds += roundTrip;
+		stats.worstRoundTrip = std::max(stats.worstRoundTrip, roundTrip);
+		stats.roundTrips++;
+	}
+
+	//back to where the server has the camera, then every command it hasn't run yet again
+	mirror.camera.setState(snapshot.camera);
+	for (unsigned int t = inputTick + 1; t <= commandTick; t++)
+	{
+		SentCommand& pending = sent[t % COMMAND_HISTORY];
+		commandInput.command = pending.command;
+		mirror.Look(commandInput, tickTime);
+		mirror.camera.KeyHandler(commandInput, tickTime);
+		pending.predicted = mirror.camera.getPos();
+	}
+}
+
+void NetClient::sendInput()
+{
+	NetPacketWriter writer(packet);
+	writer.Begin(NET_INPUT);
+	writer.Put(newestTick);
+	unsigned char count = (unsigned char)std::min(commandTick, NET_COMMAND_REDUNDANCY);
+	writer.Put(count);
+	for (unsigned int t = commandTick + 1 - count; t <= commandTick; t++)
+	{
+		const NetCommand& command = sent[t % COMMAND_HISTORY].command;
+		writer.Put(command.tick);
+		writer.Put(command.keys);
+		writer.Put(command.cursorX);
+		writer.Put(command.cursorY);
+	}
+	socket.Send(serverPort, packet.data(), packet.size());
+}
+
+void NetClient::mirrorSnapshot(Simulation& mirror, const NetSnapshot& current, const NetSnapshot* previous)
+{
+	mirror.ticks = current.tick;
+	mirror.score = current.score;
+	mirror.highscore = current.highscore;
+	mirror.deaths = current.deaths;
+	mirror.danger = current.danger / 255.0f;
+
+	chunkPositions.clear();
+	chunkSeeds.clear();
+	for (const NetChunk& chunk : current.chunks)
+	{
+		chunkPositions.push_back(chunk.position);
+		chunkSeeds.push_back(chunk.seed);
+	}
+	mirror.MirrorChunks(chunkPositions.data(), chunkSeeds.data(), (unsigned int)chunkPositions.size());
+
+	//the pools were filled from the snapshot before last time, so they are in its order
+	bool keepLods = previous && mirroredTick == renderTick - 1;
+	mirrorEntities(mirror.enemies, mirror.enemies.radius, current.enemies, previous ? &previous->enemies : nullptr, keepLods);
+	mirrorEntities(mirror.projectiles, mirror.projectiles.radius, current.projectiles, previous ? &previous->projectiles : nullptr, keepLods);
+
+	mirror.impacts.clear();
+	for (const NetImpact& impact : current.impacts)
+	{
+		glm::vec3 direction(impact.direction[0], impact.direction[1], impact.direction[2]);
+		float length = glm::length(direction);
+		mirror.impacts.push_back({ NetSnapshot::Dequantize(impact.position), length > 0.0f ? direction / length : glm::vec3(0.0f, 1.0f, 0.0f), (Impact::Kind)impact.kind });
+	}
+	mirroredTick = renderTick;
+}
+
+void NetClient::mirrorEntities(EntityPool& pool, float radius, const std::vector<NetEntity>& current, const std::vector<NetEntity>* previous, bool keepLods)
+{
+	previousLods.clear();
+	if (keepLods)
+		previousLods.insert(previousLods.end(), pool.lods.begin(), pool.lods.end());
+	pool.Clear();
+	//both lists are in id order, an entity that wasn't in the last one starts where it is
+	size_t b = 0;
+	for (const NetEntity& entity : current)
+	{
+		glm::vec3 position = NetSnapshot::Dequantize(entity.position);
+		glm::vec3 previousPosition = position;
+		int lod = 0;
+		if (previous)
+		{
+			while (b < previous->size() && (*previous)[b].id < entity.id)
+				b++;
+			if (b < previous->size() && (*previous)[b].id == entity.id && (*previous)[b].generation == entity.generation)
+			{
+				previousPosition = NetSnapshot::Dequantize((*previous)[b].position);
+				if (b < previousLods.size())
+					lod = previousLods[b];
+			}
+		}
+		unsigned int index = pool.Size();
+		pool.Add(position, (position - previousPosition) / tickTime, radius);
+		pool.previousPositions[index] = previousPosition;
+		pool.lods[index] = lod;
+	}
+}
+
+void NetClient::Disconnect()
+{
+	if (!connected)
+		return;
+	NetPacketWriter writer(packet);
+	writer.Begin(NET_BYE);
+	//nothing answers a bye, so it is sent a few times in case one is lost
+	for (unsigned int i = 0; i < BYE_REPEATS; i++)
+		socket.Send(serverPort, packet.data(), packet.size());
+	connected = false;
+}
+
+bool NetClient::IsServerGone()
+{
+	return serverLeft || std::chrono::duration<float>(std::chrono::steady_clock::now() - lastHeard).count() > SERVER_TIMEOUT;
+}
+
+const NetClientStats& NetClient::getStats()
+{
+	return stats;
+}
+
+void NetClient::ResetStats()
+{
+	stats = NetClientStats();
+}
@@ -0,0 +1,116 @@
+#ifndef NET_CLIENT_H
+#define NET_CLIENT_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <memory>
+#include <chrono>
+
+#include "simulation.h"
+#include "netSocket.h"
+#include "netSnapshot.h"
+#include "commandInput.h"
+
+//what the client has seen since the stats were last reset
+struct NetClientStats
+{
+	unsigned long long ticks = 0;
+	unsigned long long snapshots = 0;
+	unsigned long long bytes = 0;
+	//sent without a baseline
+	unsigned long long fullSnapshots = 0;
+	//couldn't be read, or their baseline was gone
+	unsigned long long damagedSnapshots = 0;
+	//ticks with no snapshot to draw, the world held still
+	unsigned long long missingTicks = 0;
+	//ticks the client caught up with the newest snapshot and had to wait for the next
+	unsigned long long starvedTicks = 0;
+	double serverTickMilliseconds = 0.0;
+	//how far behind the newest snapshot the drawn one was, added up every tick
+	unsigned long long interpolationTicks = 0;
+	//how far the predicted camera was from where the server put it, in units
+	double predictionError = 0.0;
+	float worstPredictionError = 0.0f;
+	unsigned long long predictions = 0;
+	//from sending a command to getting a snapshot that ran it
+	double roundTripSeconds = 0.0;
+	float worstRoundTrip = 0.0f;
+	unsigned long long roundTrips = 0;
+};
+
+//the renderer's side of a loopback session. the world is a copy that is never ticked: its chunks,
+//enemies and projectiles are filled from the server's snapshots a couple of ticks behind the newest,
+//with each entity's previous position from the snapshot before, so the renderer interpolates between
+//two real server states the same way it does between two ticks. the camera doesn't wait for the server,
+//each tick's input moves it straight away and is sent off, and when a snapshot says which command the
+//server got up to the camera is put where the server had it and the commands since are run again
+class NetClient
+{
+public:
+	NetClient(unsigned short serverPort);
+
+	//sends hellos until the server answers with the settings its world was made with, false if it
+	//hasn't within timeout seconds
+	bool Connect(float timeout, NetWelcome& welcome);
+	//one tick: reads what has arrived, predicts the camera from this tick's input and sends it, then
+	//moves mirror on to the next snapshot to be drawn. mirror has to be made with the welcome's settings
+	void Tick(Simulation& mirror, InputSource& input);
+	//tells the server the session is over
+	void Disconnect();
+	//the server said bye, or hasn't sent anything for a while
+	bool IsServerGone();
+
+	const NetClientStats& getStats();
+	void ResetStats();
+
+	//snapshots the drawn one is kept behind the newest, so the next is usually already there when it is needed
+	static const unsigned int INTERPOLATION_TICKS = 2;
+	//further behind than this and it jumps forward instead of catching up
+	static const unsigned int MAX_INTERPOLATION_TICKS = 8;
+	static const unsigned int SNAPSHOT_HISTORY = 64;
+	static const unsigned int COMMAND_HISTORY = 128;
+	//seconds without a packet before the server is taken to be gone
+	static constexpr float SERVER_TIMEOUT = 3.0f;
+private:
+	//a command that has been sent, and where the camera was predicted to be after it
+	struct SentCommand
+	{
+		NetCommand command;
+		glm::vec3 predicted;
+		std::chrono::steady_clock::time_point sentAt;
+	};
+
+	NetSocket socket;
+	unsigned short serverPort;
+	float tickTime = 1.0f / 60.0f;
+	bool connected = false;
+	bool serverLeft = false;
+	std::chrono::steady_clock::time_point lastHeard;
+
+	std::unique_ptr<NetSnapshot[]> history;
+	unsigned long long newestTick = 0;
+	unsigned long long reconciledTick = 0;
+	unsigned long long renderTick = 0;
+	unsigned long long mirroredTick = 0;
+
+	std::unique_ptr<SentCommand[]> sent;
+	unsigned int commandTick = 0;
+	unsigned int lastRoundTripTick = 0;
+	CommandInput commandInput;
+
+	std::vector<unsigned char> packet;
+	std::vector<unsigned char> received;
+	std::vector<glm::vec3> chunkPositions;
+	std::vector<unsigned int> chunkSeeds;
+	std::vector<int> previousLods;
+	NetClientStats stats;
+
+	void receive();
+	void reconcile(Simulation& mirror);
+	void sendInput();
+	void mirrorSnapshot(Simulation& mirror, const NetSnapshot& current, const NetSnapshot* previous);
+	void mirrorEntities(EntityPool& pool, float radius, const std::vector<NetEntity>& current, const std::vector<NetEntity>* previous, bool keepLods);
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "netPacket.h"
+
+NetPacketWriter::NetPacketWriter(std::vector<unsigned char>& out)
+{
+	this->out = &out;
+}
+
+void NetPacketWriter::Begin(NetMessage type)
+{
+	out->clear();
+	for (char c : NET_MAGIC)
+		out->push_back((unsigned char)c);
+	Put(NET_VERSION);
+	Put(type);
+}
+
+void NetPacketWriter::PutVarint(unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		out->push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	out->push_back((unsigned char)value);
+}
+
+void NetPacketWriter::PutSigned(long long value)
+{
+	PutVarint(((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63));
+}
+
+size_t NetPacketWriter::getSize()
+{
+	return out->size();
+}
+
+NetPacketReader::NetPacketReader(const unsigned char* data, size_t size)
+{
+	this->data = data;
+	this->size = size;
+}
+
+bool NetPacketReader::Begin(NetMessage& type)
+{
+	unsigned short version = 0;
+	if (size < 4 || memcmp(data, NET_MAGIC, 4) != 0)
+		return false;
+	offset = 4;
+	return Get(version) && version == NET_VERSION && Get(type);
+}
+
+bool NetPacketReader::GetVarint(unsigned long long& value)
+{
+	value = 0;
+	for (unsigned int shift = 0; shift < 64; shift += 7)
+	{
+		unsigned char byte;
+		if (!Get(byte))
+			return false;
+		value |= (unsigned long long)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+bool NetPacketReader::GetSigned(long long& value)
+{
+	unsigned long long zigzag;
+	if (!GetVarint(zigzag))
+		return false;
+	value = (long long)(zigzag >> 1) ^ -(long long)(zigzag & 1);
+	return true;
+}
+
+bool NetPacketReader::AtEnd()
+{
+	return offset == size;
+}
@@ -0,0 +1,58 @@
+#ifndef NET_PACKET_H
+#define NET_PACKET_H
+
+#include <vector>
+#include <cstring>
+#include <cstddef>
+
+#include "netProtocol.h"
+
+//builds a packet in the layout netProtocol.h describes, into a buffer kept between packets
+class NetPacketWriter
+{
+public:
+	NetPacketWriter(std::vector<unsigned char>& out);
+
+	//clears the buffer and writes the packet header
+	void Begin(NetMessage type);
+	template <typename T>
+	void Put(const T& value)
+	{
+		const unsigned char* bytes = (const unsigned char*)&value;
+		out->insert(out->end(), bytes, bytes + sizeof(T));
+	}
+	void PutVarint(unsigned long long value);
+	void PutSigned(long long value);
+	size_t getSize();
+private:
+	std::vector<unsigned char>* out;
+};
+
+//reads a packet where it is, every read checks it stays inside the packet
+class NetPacketReader
+{
+public:
+	NetPacketReader(const unsigned char* data, size_t size);
+
+	//checks the header, false if it isn't a packet of this version
+	bool Begin(NetMessage& type);
+	template <typename T>
+	bool Get(T& value)
+	{
+		if (size - offset < sizeof(T))
+			return false;
+		memcpy(&value, data + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+	bool GetVarint(unsigned long long& value);
+	bool GetSigned(long long& value);
+	//true once everything has been read
+	bool AtEnd();
+private:
+	const unsigned char* data;
+	size_t size;
+	size_t offset = 0;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef NET_PROTOCOL_H
+#define NET_PROTOCOL_H
+
+//layout of the packets between NetServer and NetClient. they only ever talk over loopback on one
+//machine, so like replays and snapshots everything is in the machine's byte order.
+//varints are 7 bits a byte with the top bit set when another byte follows, signed values are zigzagged
+//into them first (0, -1, 1, -2...) so small steps either way stay a byte.
+//  every packet: "FSNT", version, then the message type as a byte
+//  hello:        nothing, sent by the client until it is welcomed
+//  welcome:      NetWelcome's fields in order, the settings the client makes its copy of the world with
+//  input:        the newest snapshot tick the client has as an unsigned long long, a count byte, then that
+//                many NetCommands oldest first, each as its fields in order with the keys as a byte
+//                (bit n is InputKey n). every input packet repeats the last few commands so a lost one
+//                doesn't lose any input
+//  snapshot:     the state after one tick, see NetSnapshot::Encode
+//  bye:          nothing, either side is leaving
+
+const char NET_MAGIC[4] = { 'F', 'S', 'N', 'T' };
+const unsigned short NET_VERSION = 1;
+
+enum NetMessage : unsigned char
+{
+	NET_HELLO,
+	NET_WELCOME,
+	NET_INPUT,
+	NET_SNAPSHOT,
+	NET_BYE,
+};
+
+//port the server listens on unless it is given another
+const unsigned short NET_DEFAULT_PORT = 27015;
+//biggest packet either side sends, a udp datagram can be a little under 64k
+const unsigned int NET_MAX_PACKET = 65000;
+//commands repeated in each input packet
+const unsigned int NET_COMMAND_REDUNDANCY = 8;
+
+struct NetWelcome
+{
+	unsigned int seed = 0;
+	float tickTime = 1.0f / 60.0f;
+	unsigned char flocking = 0;
+	int stressEnemies = 0;
+	int chunkRadius = 4;
+};
+
+//one tick of the client's input, numbered from 1
+struct NetCommand
+{
+	unsigned int tick = 0;
+	unsigned char keys = 0;
+	double cursorX = 0.0, cursorY = 0.0;
+};
+
+#endif
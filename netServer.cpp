@@ -0,0 +1,214 @@
+#include "netServer.h"
+
+#include <iostream>
+#include <chrono>
+
+#include "netPacket.h"
+
+NetServer::NetServer(const SimulationSettings& settings, float tickTime, JobSystem& jobs, unsigned short port)
+	: tickTime(tickTime),
+	jobs(&jobs),
+	sim(settings, jobs),
+	socket(port),
+	history(new NetSnapshot[SNAPSHOT_HISTORY])
+{
+	welcome.seed = settings.seed;
+	welcome.tickTime = tickTime;
+	welcome.flocking = settings.flocking ? 1 : 0;
+	welcome.stressEnemies = settings.stressEnemies;
+	welcome.chunkRadius = settings.chunkRadius;
+	//a full input packet of commands can arrive between two ticks
+	commands.reserve(MAX_QUEUED_COMMANDS + NET_COMMAND_REDUNDANCY);
+	packet.reserve(NET_MAX_PACKET);
+	received.resize(NET_MAX_PACKET);
+}
+
+bool NetServer::IsOpen()
+{
+	return socket.IsOpen();
+}
+
+void NetServer::Receive()
+{
+	unsigned short fromPort;
+	int size;
+	while ((size = socket.Receive(received.data(), received.size(), fromPort)) >= 0)
+	{
+		NetPacketReader reader(received.data(), (size_t)size);
+		NetMessage type;
+		if (!reader.Begin(type))
+			continue;
+		//only one client, anyone else is ignored
+		if (connected && fromPort != clientPort)
+			continue;
+		lastHeard = std::chrono::steady_clock::now();
+		if (type == NET_HELLO)
+		{
+			//hellos keep coming until one of these arrives, so each is answered
+			if (!connected)
+				std::cout << "client connected from port " << fromPort << std::endl;
+			connected = true;
+			clientPort = fromPort;
+			NetPacketWriter writer(packet);
+			writer.Begin(NET_WELCOME);
+			writer.Put(welcome.seed);
+			writer.Put(welcome.tickTime);
+			writer.Put(welcome.flocking);
+			writer.Put(welcome.stressEnemies);
+			writer.Put(welcome.chunkRadius);
+			socket.Send(clientPort, packet.data(), packet.size());
+		}
+		else if (type == NET_INPUT && connected)
+		{
+			unsigned long long ack;
+			unsigned char count;
+			if (!reader.Get(ack) || !reader.Get(count))
+				continue;
+			if (ack > ackTick && ack <= sim.ticks)
+				ackTick = ack;
+			for (unsigned char i = 0; i < count; i++)
+			{
+				NetCommand command;
+				if (!reader.Get(command.tick) || !reader.Get(command.keys) || !reader.Get(command.cursorX) || !reader.Get(command.cursorY))
+					break;
+				queueCommand(command);
+			}
+		}
+		else if (type == NET_BYE && connected)
+			left = true;
+	}
+}
+
+void NetServer::queueCommand(const NetCommand& command)
+{
+	//every packet repeats the last few commands, only the ones not seen yet are kept
+	unsigned int newest = commands.empty() ? input.command.tick : commands.back().tick;
+	if (command.tick <= newest)
+		return;
+	commands.push_back(command);
+	//a client running ahead would otherwise see its input later and later
+	if (commands.size() > MAX_QUEUED_COMMANDS)
+	{
+		commands.erase(commands.begin());
+		droppedCommands++;
+	}
+}
+
+void NetServer::Tick()
+{
+	if (!connected || left)
+		return;
+	auto tickStart = std::chrono::high_resolution_clock::now();
+	//with nothing new the last keys are held for another tick, the same as a missed frame would
+	if (!commands.empty())
+	{
+		input.command = commands.front();
+		commands.erase(commands.begin());
+	}
+	else
+		repeatedCommands++;
+	//before the first command the cursor isn't known, looking would jump to wherever it turns out to be
+	if (input.command.tick > 0)
+		sim.Look(input, tickTime);
+	sim.Tick(input, tickTime);
+	double tickTaken = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tickStart).count();
+	tickMilliseconds += tickTaken;
+	ticks++;
+
+	send((unsigned int)(tickTaken * 1000.0));
+}
+
+void NetServer::send(unsigned int tickMicros)
+{
+	auto encodeStart = std::chrono::high_resolution_clock::now();
+	NetSnapshot& snapshot = history[sim.ticks % SNAPSHOT_HISTORY];
+	snapshot.Capture(sim, input.command.tick, tickMicros, jobs->Scratch(0));
+	//the newest snapshot the client has is the baseline, as long as it is still kept
+	NetSnapshot* baseline = nullptr;
+	if (ackTick > 0 && sim.ticks - ackTick < SNAPSHOT_HISTORY && history[ackTick % SNAPSHOT_HISTORY].tick == ackTick)
+		baseline = &history[ackTick % SNAPSHOT_HISTORY];
+	else
+		fullSnapshots++;
+	NetPacketWriter writer(packet);
+	writer.Begin(NET_SNAPSHOT);
+	snapshot.Encode(baseline, writer);
+	encodeMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - encodeStart).count();
+
+	lastSnapshotSize = (unsigned int)packet.size();
+	bytesSent += packet.size();
+	if (packet.size() > NET_MAX_PACKET || !socket.Send(clientPort, packet.data(), packet.size()))
+		std::cout << "failed to send the snapshot for tick " << sim.ticks << " (" << packet.size() << " bytes)" << std::endl;
+}
+
+void NetServer::Disconnect()
+{
+	if (!connected || left)
+		return;
+	NetPacketWriter writer(packet);
+	writer.Begin(NET_BYE);
+	//nothing answers a bye, so it is sent a few times in case one is lost
+	for (int i = 0; i < 3; i++)
+		socket.Send(clientPort, packet.data(), packet.size());
+}
+
+bool NetServer::HasClient()
+{
+	return connected;
+}
+
+bool NetServer::ClientLeft()
+{
+	return left;
+}
+
+float NetServer::getSilence()
+{
+	if (!connected)
+		return 0.0f;
+	return std::chrono::duration<float>(std::chrono::steady_clock::now() - lastHeard).count();
+}
+
+Simulation& NetServer::getSimulation()
+{
+	return sim;
+}
+
+unsigned long long NetServer::getTicks()
+{
+	return ticks;
+}
+
+double NetServer::getTickMilliseconds()
+{
+	return tickMilliseconds;
+}
+
+double NetServer::getEncodeMilliseconds()
+{
+	return encodeMilliseconds;
+}
+
+unsigned long long NetServer::getBytesSent()
+{
+	return bytesSent;
+}
+
+unsigned long long NetServer::getFullSnapshots()
+{
+	return fullSnapshots;
+}
+
+unsigned long long NetServer::getRepeatedCommands()
+{
+	return repeatedCommands;
+}
+
+unsigned long long NetServer::getDroppedCommands()
+{
+	return droppedCommands;
+}
+
+unsigned int NetServer::getLastSnapshotSize()
+{
+	return lastSnapshotSize;
+}
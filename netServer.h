@@ -0,0 +1,86 @@
+#ifndef NET_SERVER_H
+#define NET_SERVER_H
+
+#include <vector>
+#include <memory>
+#include <chrono>
+
+#include "simulation.h"
+#include "netSocket.h"
+#include "netSnapshot.h"
+#include "commandInput.h"
+#include "jobSystem.h"
+
+//hosts the world for one client over loopback. it owns the simulation, runs each tick from the command
+//the client sent for it and sends back a snapshot of the result, delta compressed against the newest
+//snapshot the client says it has
+class NetServer
+{
+public:
+	NetServer(const SimulationSettings& settings, float tickTime, JobSystem& jobs, unsigned short port);
+
+	bool IsOpen();
+	//answers whatever has arrived: welcomes a new client and queues its commands
+	void Receive();
+	//runs a tick and sends its snapshot, nothing happens until a client has connected
+	void Tick();
+	//tells the client the session is over
+	void Disconnect();
+	bool HasClient();
+	//the client said bye
+	bool ClientLeft();
+	//seconds since anything last came from the client
+	float getSilence();
+	Simulation& getSimulation();
+
+	//totals since the client connected
+	unsigned long long getTicks();
+	double getTickMilliseconds();
+	//capturing and encoding the snapshots
+	double getEncodeMilliseconds();
+	unsigned long long getBytesSent();
+	unsigned long long getFullSnapshots();
+	//ticks that ran without a new command, repeating the last one
+	unsigned long long getRepeatedCommands();
+	//commands dropped because too many were waiting
+	unsigned long long getDroppedCommands();
+	//bytes the last snapshot took
+	unsigned int getLastSnapshotSize();
+	//how many ticks the server runs one after the other when commands pile up
+	static const unsigned int MAX_QUEUED_COMMANDS = 4;
+	//snapshots kept for baselines, an ack older than this gets a full snapshot
+	static const unsigned int SNAPSHOT_HISTORY = 64;
+private:
+	NetWelcome welcome;
+	float tickTime;
+	JobSystem* jobs;
+	Simulation sim;
+	NetSocket socket;
+	unsigned short clientPort = 0;
+	bool connected = false;
+	bool left = false;
+	std::chrono::steady_clock::time_point lastHeard;
+
+	//commands in tick order, newer than the last one run
+	std::vector<NetCommand> commands;
+	CommandInput input;
+	unsigned long long ackTick = 0;
+	std::unique_ptr<NetSnapshot[]> history;
+	std::vector<unsigned char> packet;
+	std::vector<unsigned char> received;
+
+	unsigned long long ticks = 0;
+	double tickMilliseconds = 0.0;
+	double encodeMilliseconds = 0.0;
+	unsigned long long bytesSent = 0;
+	unsigned long long fullSnapshots = 0;
+	unsigned long long repeatedCommands = 0;
+	unsigned long long droppedCommands = 0;
+	unsigned int lastSnapshotSize = 0;
+
+	//the snapshot is sent with how long its tick took
+	void send(unsigned int tickMicros);
+	void queueCommand(const NetCommand& command);
+};
+
+#endif
@@ -0,0 +1,301 @@
+#include "netSnapshot.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include "simulation.h"
+
+namespace
+{
+	struct EntityDistance
+	{
+		float distance;
+		unsigned int index;
+	};
+
+	//the nearest max entities in pool to eye, in id order
+	void captureEntities(EntityPool& pool, glm::vec3 eye, unsigned int max, std::vector<NetEntity>& out, LinearAllocator& scratch)
+	{
+		out.clear();
+		unsigned int count = pool.Size();
+		EntityDistance* order = scratch.Allocate<EntityDistance>(count);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			glm::vec3 offset = pool.positions[i] - eye;
+			order[i] = { glm::dot(offset, offset), i };
+		}
+		if (count > max)
+		{
+			std::nth_element(order, order + max, order + count, [](const EntityDistance& a, const EntityDistance& b) { return a.distance < b.distance; });
+			count = max;
+		}
+		for (unsigned int i = 0; i < count; i++)
+		{
+			EntityHandle handle = pool.HandleOf(order[i].index);
+			out.push_back({ handle.slot, (unsigned char)handle.generation, NetSnapshot::Quantize(pool.positions[order[i].index]) });
+		}
+		std::sort(out.begin(), out.end(), [](const NetEntity& a, const NetEntity& b) { return a.id < b.id; });
+	}
+
+	void putVector(NetPacketWriter& writer, glm::ivec3 value)
+	{
+		writer.PutSigned(value.x);
+		writer.PutSigned(value.y);
+		writer.PutSigned(value.z);
+	}
+
+	bool getVector(NetPacketReader& reader, glm::ivec3& value)
+	{
+		long long x, y, z;
+		if (!reader.GetSigned(x) || !reader.GetSigned(y) || !reader.GetSigned(z))
+			return false;
+		value = glm::ivec3((int)x, (int)y, (int)z);
+		return true;
+	}
+
+	void putEntities(NetPacketWriter& writer, const std::vector<NetEntity>& entities, const std::vector<NetEntity>* baseline, glm::ivec3 origin)
+	{
+		writer.PutVarint(entities.size());
+		unsigned int lastId = 0;
+		size_t b = 0;
+		for (const NetEntity& entity : entities)
+		{
+			//both lists are in id order, so the baseline is walked alongside
+			if (baseline)
+			{
+				while (b < baseline->size() && (*baseline)[b].id < entity.id)
+					b++;
+			}
+			bool inBaseline = baseline && b < baseline->size() && (*baseline)[b].id == entity.id && (*baseline)[b].generation == entity.generation;
+			writer.PutVarint((unsigned long long)(entity.id - lastId) << 1 | (inBaseline ? 1 : 0));
+			lastId = entity.id;
+			if (inBaseline)
+				putVector(writer, entity.position - (*baseline)[b].position);
+			else
+			{
+				writer.Put(entity.generation);
+				putVector(writer, entity.position - origin);
+			}
+		}
+	}
+
+	bool getEntities(NetPacketReader& reader, std::vector<NetEntity>& entities, unsigned int max, const std::vector<NetEntity>* baseline, glm::ivec3 origin)
+	{
+		entities.clear();
+		unsigned long long count;
+		if (!reader.GetVarint(count) || count > max)
+			return false;
+		unsigned long long id = 0;
+		size_t b = 0;
+		for (unsigned long long i = 0; i < count; i++)
+		{
+			unsigned long long step;
+			if (!reader.GetVarint(step))
+				return false;
+			id += step >> 1;
+			if (id > 0xFFFFFFFFull)
+				return false;
+			NetEntity entity;
+			entity.id = (unsigned int)id;
+			glm::ivec3 offset;
+			if (step & 1)
+			{
+				if (!baseline)
+					return false;
+				while (b < baseline->size() && (*baseline)[b].id < entity.id)
+					b++;
+				if (b == baseline->size() || (*baseline)[b].id != entity.id || !getVector(reader, offset))
+					return false;
+				entity.generation = (*baseline)[b].generation;
+				entity.position = (*baseline)[b].position + offset;
+			}
+			else
+			{
+				if (!reader.Get(entity.generation) || !getVector(reader, offset))
+					return false;
+				entity.position = origin + offset;
+			}
+			entities.push_back(entity);
+		}
+		return true;
+	}
+}
+
+NetSnapshot::NetSnapshot()
+{
+	chunks.reserve(MAX_CHUNKS);
+	enemies.reserve(MAX_ENEMIES);
+	projectiles.reserve(MAX_PROJECTILES);
+	impacts.reserve(MAX_IMPACTS);
+}
+
+void NetSnapshot::Capture(Simulation& sim, unsigned int inputTick, unsigned int tickMicros, LinearAllocator& scratch)
+{
+	tick = sim.ticks;
+	this->inputTick = inputTick;
+	this->tickMicros = tickMicros;
+	score = sim.score;
+	highscore = sim.highscore;
+	deaths = sim.deaths;
+	danger = (unsigned char)(glm::clamp(sim.danger, 0.0f, 1.0f) * 255.0f + 0.5f);
+	camera = sim.camera.getState();
+
+	chunks.clear();
+	for (unsigned int i = 0; i < sim.chunks.size() && i < MAX_CHUNKS; i++)
+		chunks.push_back({ sim.chunks[i].getPos(), sim.chunks[i].getSeed() });
+	captureEntities(sim.enemies, camera.position, MAX_ENEMIES, enemies, scratch);
+	captureEntities(sim.projectiles, camera.position, MAX_PROJECTILES, projectiles, scratch);
+
+	impacts.clear();
+	for (unsigned int i = 0; i < sim.impacts.size() && i < MAX_IMPACTS; i++)
+	{
+		const Impact& impact = sim.impacts[i];
+		NetImpact sent;
+		sent.position = Quantize(impact.position);
+		for (int a = 0; a < 3; a++)
+			sent.direction[a] = (signed char)std::lround(glm::clamp(impact.direction[a], -1.0f, 1.0f) * 127.0f);
+		sent.kind = (unsigned char)impact.kind;
+		impacts.push_back(sent);
+	}
+}
+
+void NetSnapshot::Encode(const NetSnapshot* baseline, NetPacketWriter& writer)
+{
+	writer.PutVarint(tick);
+	writer.PutVarint(baseline ? tick - baseline->tick : 0);
+	writer.PutVarint(inputTick);
+	writer.PutVarint(tickMicros);
+	writer.PutSigned(score);
+	writer.PutSigned(highscore);
+	writer.PutVarint(deaths);
+	writer.Put(danger);
+
+	writer.Put(camera.position);
+	writer.Put(camera.front);
+	writer.Put(camera.horizontalFront);
+	writer.Put(camera.yaw);
+	writer.Put(camera.pitch);
+	writer.Put(camera.lastMouseX);
+	writer.Put(camera.lastMouseY);
+	writer.Put((unsigned char)(camera.firstMouseUpdate ? 1 : 0));
+
+	//the chunks only change when the player crosses into another one, so nearly every chunk is in the baseline
+	writer.PutVarint(chunks.size());
+	for (const NetChunk& chunk : chunks)
+	{
+		unsigned long long index = 0;
+		if (baseline)
+		{
+			for (size_t b = 0; b < baseline->chunks.size() && index == 0; b++)
+			{
+				if (baseline->chunks[b].position == chunk.position && baseline->chunks[b].seed == chunk.seed)
+					index = b + 1;
+			}
+		}
+		writer.PutVarint(index);
+		if (index == 0)
+		{
+			writer.Put(chunk.position);
+			writer.Put(chunk.seed);
+		}
+	}
+
+	glm::ivec3 origin = Quantize(camera.position);
+	putEntities(writer, enemies, baseline ? &baseline->enemies : nullptr, origin);
+	putEntities(writer, projectiles, baseline ? &baseline->projectiles : nullptr, origin);
+
+	writer.PutVarint(impacts.size());
+	for (const NetImpact& impact : impacts)
+	{
+		putVector(writer, impact.position - origin);
+		writer.Put(impact.direction);
+		writer.Put(impact.kind);
+	}
+}
+
+bool NetSnapshot::ReadTicks(NetPacketReader reader, unsigned long long& tick, unsigned long long& baselineTick)
+{
+	unsigned long long back;
+	if (!reader.GetVarint(tick) || !reader.GetVarint(back) || back > tick)
+		return false;
+	baselineTick = back == 0 ? 0 : tick - back;
+	return true;
+}
+
+bool NetSnapshot::Decode(NetPacketReader& reader, const NetSnapshot* baseline)
+{
+	unsigned long long back, sentInputTick, sentMicros, sentDeaths;
+	long long sentScore, sentHighscore;
+	unsigned char firstMouseUpdate;
+	if (!reader.GetVarint(tick) || !reader.GetVarint(back) || !reader.GetVarint(sentInputTick) || !reader.GetVarint(sentMicros) ||
+		!reader.GetSigned(sentScore) || !reader.GetSigned(sentHighscore) || !reader.GetVarint(sentDeaths) || !reader.Get(danger))
+		return false;
+	//it has to be decoded against the snapshot it was encoded against
+	if ((back != 0) != (baseline != nullptr) || (baseline && baseline->tick != tick - back))
+		return false;
+	inputTick = (unsigned int)sentInputTick;
+	tickMicros = (unsigned int)sentMicros;
+	score = (int)sentScore;
+	highscore = (int)sentHighscore;
+	deaths = (unsigned int)sentDeaths;
+
+	if (!reader.Get(camera.position) || !reader.Get(camera.front) || !reader.Get(camera.horizontalFront) || !reader.Get(camera.yaw) ||
+		!reader.Get(camera.pitch) || !reader.Get(camera.lastMouseX) || !reader.Get(camera.lastMouseY) || !reader.Get(firstMouseUpdate))
+		return false;
+	camera.previousPosition = camera.position;
+	camera.firstMouseUpdate = firstMouseUpdate != 0;
+
+	chunks.clear();
+	unsigned long long chunkCount;
+	if (!reader.GetVarint(chunkCount) || chunkCount > MAX_CHUNKS)
+		return false;
+	for (unsigned long long i = 0; i < chunkCount; i++)
+	{
+		unsigned long long index;
+		NetChunk chunk;
+		if (!reader.GetVarint(index))
+			return false;
+		if (index == 0)
+		{
+			if (!reader.Get(chunk.position) || !reader.Get(chunk.seed))
+				return false;
+		}
+		else if (baseline && index <= baseline->chunks.size())
+			chunk = baseline->chunks[index - 1];
+		else
+			return false;
+		chunks.push_back(chunk);
+	}
+
+	glm::ivec3 origin = Quantize(camera.position);
+	if (!getEntities(reader, enemies, MAX_ENEMIES, baseline ? &baseline->enemies : nullptr, origin) ||
+		!getEntities(reader, projectiles, MAX_PROJECTILES, baseline ? &baseline->projectiles : nullptr, origin))
+		return false;
+
+	impacts.clear();
+	unsigned long long impactCount;
+	if (!reader.GetVarint(impactCount) || impactCount > MAX_IMPACTS)
+		return false;
+	for (unsigned long long i = 0; i < impactCount; i++)
+	{
+		NetImpact impact;
+		glm::ivec3 offset;
+		if (!getVector(reader, offset) || !reader.Get(impact.direction) || !reader.Get(impact.kind))
+			return false;
+		impact.position = origin + offset;
+		impacts.push_back(impact);
+	}
+	return reader.AtEnd();
+}
+
+glm::ivec3 NetSnapshot::Quantize(glm::vec3 position)
+{
+	return glm::ivec3((int)std::lround(position.x * POSITION_SCALE), (int)std::lround(position.y * POSITION_SCALE), (int)std::lround(position.z * POSITION_SCALE));
+}
+
+glm::vec3 NetSnapshot::Dequantize(glm::ivec3 position)
+{
+	return glm::vec3(position) * (1.0f / POSITION_SCALE);
+}
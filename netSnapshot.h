@@ -0,0 +1,93 @@
+#ifndef NET_SNAPSHOT_H
+#define NET_SNAPSHOT_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "camera.h"
+#include "linearAllocator.h"
+#include "netPacket.h"
+
+class Simulation;
+
+//an enemy or projectile, by its pool handle's slot and the low byte of its generation
+struct NetEntity
+{
+	unsigned int id;
+	unsigned char generation;
+	//in 1/POSITION_SCALE units
+	glm::ivec3 position;
+};
+
+struct NetChunk
+{
+	glm::vec3 position;
+	unsigned int seed;
+};
+
+struct NetImpact
+{
+	glm::ivec3 position;
+	//a unit vector times 127
+	signed char direction[3];
+	unsigned char kind;
+};
+
+//what the client is sent after each tick: the camera exactly, so it can correct its prediction, and
+//everything else only as well as it needs to be drawn. positions are rounded to 1/POSITION_SCALE of a
+//unit and only the nearest enemies and projectiles are sent when there are too many. everything is
+//reserved up front, so capturing and decoding never allocate
+class NetSnapshot
+{
+public:
+	NetSnapshot();
+
+	//the state sim was left in by its last tick. inputTick is the last client command it ran, tickMicros
+	//how long the tick took. scratch is only used during the call
+	void Capture(Simulation& sim, unsigned int inputTick, unsigned int tickMicros, LinearAllocator& scratch);
+	//appends the snapshot to a packet. with a baseline the client already has, chunks that are in it are
+	//sent as an index and entities that are in it as how far they moved since, new ones are sent from
+	//the camera. entities are matched by id and generation, both lists are in id order.
+	//  tick, ticks back to the baseline (0 for none), inputTick and tickMicros as varints
+	//  score and highscore as signed varints, deaths as a varint, danger as a byte from 0 to 255
+	//  the camera's CameraState fields in order except previousPosition, firstMouseUpdate as a byte
+	//  chunks:      count, then for each its index in the baseline + 1, or 0 then its position and seed
+	//  enemies:     count, then for each the step from the last id, shifted up one with the low bit set
+	//               if it is in the baseline, its generation byte if it isn't, then x, y and z as signed
+	//               varints from its baseline position or the camera's
+	//  projectiles: the same as enemies
+	//  impacts:     count, then for each its position as signed varints from the camera's, its direction
+	//               as three bytes and its kind
+	void Encode(const NetSnapshot* baseline, NetPacketWriter& writer);
+	//the tick and baseline tick of an encoded snapshot, so the baseline can be found before decoding.
+	//baselineTick is 0 if it doesn't need one
+	static bool ReadTicks(NetPacketReader reader, unsigned long long& tick, unsigned long long& baselineTick);
+	//reads a snapshot Encode wrote against the same baseline, false if it is damaged
+	bool Decode(NetPacketReader& reader, const NetSnapshot* baseline);
+
+	static glm::ivec3 Quantize(glm::vec3 position);
+	static glm::vec3 Dequantize(glm::ivec3 position);
+
+	static const int POSITION_SCALE = 32;
+	static const unsigned int MAX_ENEMIES = 2048;
+	static const unsigned int MAX_PROJECTILES = 1024;
+	static const unsigned int MAX_CHUNKS = 1024;
+	//as many as the particle system takes bursts a frame
+	static const unsigned int MAX_IMPACTS = 64;
+
+	unsigned long long tick = 0;
+	unsigned int inputTick = 0;
+	unsigned int tickMicros = 0;
+	int score = 0;
+	int highscore = 0;
+	unsigned int deaths = 0;
+	unsigned char danger = 0;
+	CameraState camera;
+	std::vector<NetChunk> chunks;
+	std::vector<NetEntity> enemies;
+	std::vector<NetEntity> projectiles;
+	std::vector<NetImpact> impacts;
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "netSocket.h"
+
+#include <iostream>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	//a burst of snapshots or a stalled frame shouldn't drop packets, so both buffers are made big
+	const int SOCKET_BUFFER_SIZE = 1 << 20;
+
+	sockaddr_in loopback(unsigned short port)
+	{
+		sockaddr_in address;
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = htons(port);
+		return address;
+	}
+}
+
+NetSocket::NetSocket(unsigned short port)
+{
+#ifdef _WIN32
+	WSADATA wsaData;
+	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+	{
+		std::cout << "failed to start winsock" << std::endl;
+		handle = INVALID_SOCKET;
+		return;
+	}
+	SOCKET created = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	handle = created;
+	if (created == INVALID_SOCKET)
+	{
+		std::cout << "failed to make a socket" << std::endl;
+		return;
+	}
+	u_long nonBlocking = 1;
+	ioctlsocket(created, FIONBIO, &nonBlocking);
+	setsockopt(created, SOL_SOCKET, SO_RCVBUF, (const char*)&SOCKET_BUFFER_SIZE, sizeof(SOCKET_BUFFER_SIZE));
+	setsockopt(created, SOL_SOCKET, SO_SNDBUF, (const char*)&SOCKET_BUFFER_SIZE, sizeof(SOCKET_BUFFER_SIZE));
+#else
+	handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (handle < 0)
+	{
+		std::cout << "failed to make a socket" << std::endl;
+		return;
+	}
+	fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK);
+	setsockopt(handle, SOL_SOCKET, SO_RCVBUF, &SOCKET_BUFFER_SIZE, sizeof(SOCKET_BUFFER_SIZE));
+	setsockopt(handle, SOL_SOCKET, SO_SNDBUF, &SOCKET_BUFFER_SIZE, sizeof(SOCKET_BUFFER_SIZE));
+#endif
+	sockaddr_in address = loopback(port);
+	if (bind(handle, (const sockaddr*)&address, sizeof(address)) != 0)
+	{
+		std::cout << "failed to bind to port " << port << std::endl;
+		return;
+	}
+	//with port 0 the os picked one, the other end needs to know which
+	socklen_t length = sizeof(address);
+	getsockname(handle, (sockaddr*)&address, &length);
+	this->port = ntohs(address.sin_port);
+	open = true;
+}
+
+NetSocket::~NetSocket()
+{
+#ifdef _WIN32
+	if (handle != INVALID_SOCKET)
+		closesocket(handle);
+	WSACleanup();
+#else
+	if (handle >= 0)
+		close(handle);
+#endif
+}
+
+bool NetSocket::IsOpen()
+{
+	return open;
+}
+
+bool NetSocket::Send(unsigned short port, const unsigned char* data, size_t size)
+{
+	if (!open)
+		return false;
+	sockaddr_in address = loopback(port);
+	return sendto(handle, (const char*)data, (int)size, 0, (const sockaddr*)&address, sizeof(address)) == (int)size;
+}
+
+int NetSocket::Receive(unsigned char* buffer, size_t capacity, unsigned short& fromPort)
+{
+	if (!open)
+		return -1;
+	sockaddr_in address;
+	socklen_t length = sizeof(address);
+	int received = (int)recvfrom(handle, (char*)buffer, (int)capacity, 0, (sockaddr*)&address, &length);
+	if (received < 0)
+		return -1;
+	fromPort = ntohs(address.sin_port);
+	return received;
+}
+
+unsigned short NetSocket::getPort()
+{
+	return port;
+}
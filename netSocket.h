@@ -0,0 +1,32 @@
+#ifndef NET_SOCKET_H
+#define NET_SOCKET_H
+
+#include <cstddef>
+
+//a non blocking udp socket on 127.0.0.1. the server and client only ever run on the same machine, so
+//the other end is just a port
+class NetSocket
+{
+public:
+	//binds to port, 0 lets the os pick a free one
+	NetSocket(unsigned short port = 0);
+	~NetSocket();
+	NetSocket(const NetSocket&) = delete;
+	NetSocket& operator=(const NetSocket&) = delete;
+
+	bool IsOpen();
+	bool Send(unsigned short port, const unsigned char* data, size_t size);
+	//the next waiting packet, its size or -1 if there isn't one. fromPort is where it came from
+	int Receive(unsigned char* buffer, size_t capacity, unsigned short& fromPort);
+	unsigned short getPort();
+private:
+#ifdef _WIN32
+	unsigned long long handle = ~0ull;
+#else
+	int handle = -1;
+#endif
+	bool open = false;
+	unsigned short port = 0;
+};
+
+#endif
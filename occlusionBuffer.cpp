@@ -0,0 +1,319 @@
+#include "occlusionBuffer.h"
+
+#include "collisionKernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define OCCLUSION_SSE
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	//anything closer than the camera's near plane is clipped off before rasterizing
+	const float CLIP_W = 0.1f;
+	const float PIXEL_OFFSETS[4] = { 0.5f, 1.5f, 2.5f, 3.5f };
+
+	glm::vec4 clipLerp(const glm::vec4& a, const glm::vec4& b)
+	{
+		float t = (CLIP_W - a.w) / (b.w - a.w);
+		return a + (b - a) * t;
+	}
+}
+
+OcclusionBuffer::OcclusionBuffer(int width, int height)
+{
+	//whole blocks of 4 pixels per row, so the sse loop never runs off the end of a row
+	this->width = std::max(4, (width + 3) & ~3);
+	this->height = std::max(1, height);
+	int levelWidth = this->width, levelHeight = this->height;
+	while (true)
+	{
+		levels.emplace_back(levelWidth * levelHeight, 0.0f);
+		levelWidths.push_back(levelWidth);
+		levelHeights.push_back(levelHeight);
+		if (levelWidth == 1 && levelHeight == 1)
+			break;
+		levelWidth = (levelWidth + 1) / 2;
+		levelHeight = (levelHeight + 1) / 2;
+	}
+}
+
+void OcclusionBuffer::Begin(const glm::mat4& viewProjection, glm::vec3 eye)
+{
+	this->viewProjection = viewProjection;
+	this->eye = eye;
+	std::fill(levels[0].begin(), levels[0].end(), 0.0f);
+	occluderCount = 0;
+	triangleCount = 0;
+}
+
+void OcclusionBuffer::AddOccluder(glm::vec3 base, const UprightOccluder& shape)
+{
+	glm::vec3 toEye = eye - base;
+	float flatDistance = std::sqrt(toEye.x * toEye.x + toEye.z * toEye.z);
+	//standing on top of it, there is no side to face
+	if (flatDistance < 0.001f)
+		return;
+	glm::vec3 right = glm::vec3(-toEye.z, 0.0f, toEye.x) / flatDistance;
+	glm::vec4 bottomLeft = viewProjection * glm::vec4(base - right * shape.bottomHalfWidth + glm::vec3(0.0f, shape.bottom, 0.0f), 1.0f);
+	glm::vec4 bottomRight = viewProjection * glm::vec4(base + right * shape.bottomHalfWidth + glm::vec3(0.0f, shape.bottom, 0.0f), 1.0f);
+	glm::vec4 topLeft = viewProjection * glm::vec4(base - right * shape.topHalfWidth + glm::vec3(0.0f, shape.top, 0.0f), 1.0f);
+	addTriangle(bottomLeft, bottomRight, topLeft);
+	if (shape.topHalfWidth > 0.0f)
+	{
+		glm::vec4 topRight = viewProjection * glm::vec4(base + right * shape.topHalfWidth + glm::vec3(0.0f, shape.top, 0.0f), 1.0f);
+		addTriangle(bottomRight, topRight, topLeft);
+	}
+	occluderCount++;
+}
+
+void OcclusionBuffer::AddNearestOccluders(std::vector<glm::vec3>& candidates, unsigned int count, const UprightOccluder* shapes, unsigned int shapeCount)
+{
+	glm::vec3 from = eye;
+	if (count < candidates.size())
+	{
+		std::nth_element(candidates.begin(), candidates.begin() + count, candidates.end(), [from](const glm::vec3& a, const glm::vec3& b)
+		{
+			glm::vec3 toA = a - from, toB = b - from;
+			return glm::dot(toA, toA) < glm::dot(toB, toB);
+		});
+	}
+	else
+		count = (unsigned int)candidates.size();
+	for (unsigned int i = 0; i < count; i++)
+	{
+		for (unsigned int j = 0; j < shapeCount; j++)
+			AddOccluder(candidates[i], shapes[j]);
+	}
+}
+
+void OcclusionBuffer::addTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+{
+	if (a.w >= CLIP_W && b.w >= CLIP_W && c.w >= CLIP_W)
+	{
+		rasterize(toScreen(a), toScreen(b), toScreen(c));
+		return;
+	}
+	//cut off the part behind the near plane, which leaves at most a quad
+	const glm::vec4* input[3] = { &a, &b, &c };
+	glm::vec4 clipped[4];
+	int clippedCount = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		const glm::vec4& current = *input[i];
+		const glm::vec4& next = *input[(i + 1) % 3];
+		bool currentIn = current.w >= CLIP_W, nextIn = next.w >= CLIP_W;
+		if (currentIn)
+			clipped[clippedCount++] = current;
+		if (currentIn != nextIn)
+			clipped[clippedCount++] = clipLerp(current, next);
+	}
+	if (clippedCount < 3)
+		return;
+	ScreenVertex first = toScreen(clipped[0]);
+	for (int i = 1; i + 1 < clippedCount; i++)
+		rasterize(first, toScreen(clipped[i]), toScreen(clipped[i + 1]));
+}
+
+OcclusionBuffer::ScreenVertex OcclusionBuffer::toScreen(const glm::vec4& clip)
+{
+	ScreenVertex vertex;
+	vertex.invW = 1.0f / clip.w;
+	vertex.x = (clip.x * vertex.invW * 0.5f + 0.5f) * width;
+	vertex.y = (clip.y * vertex.invW * 0.5f + 0.5f) * height;
+	return vertex;
+}
+
+void OcclusionBuffer::rasterize(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c)
+{
+	float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+	if (std::fabs(area) < 1e-6f)
+		return;
+	//wind every triangle the same way so inside is where all three edges are positive
+	const ScreenVertex* v[3] = { &a, &b, &c };
+	if (area < 0.0f)
+	{
+		std::swap(v[1], v[2]);
+		area = -area;
+	}
+	int minX = std::max(0, (int)std::floor(std::min(a.x, std::min(b.x, c.x))));
+	int maxX = std::min(width - 1, (int)std::floor(std::max(a.x, std::max(b.x, c.x))));
+	int minY = std::max(0, (int)std::floor(std::min(a.y, std::min(b.y, c.y))));
+	int maxY = std::min(height - 1, (int)std::floor(std::max(a.y, std::max(b.y, c.y))));
+	if (minX > maxX || minY > maxY)
+		return;
+	triangleCount++;
+
+	//edge i runs from v[i] to v[i + 1], e = edgeX * x + edgeY * y + edgeC. the edges are moved in
+	//by half a pixel so testing the centre only passes pixels the triangle covers all of
+	float edgeX[3], edgeY[3], edgeC[3];
+	for (int i = 0; i < 3; i++)
+	{
+		const ScreenVertex& from = *v[i];
+		const ScreenVertex& to = *v[(i + 1) % 3];
+		edgeX[i] = from.y - to.y;
+		edgeY[i] = to.x - from.x;
+		edgeC[i] = -(edgeX[i] * from.x + edgeY[i] * from.y) - 0.5f * (std::fabs(edgeX[i]) + std::fabs(edgeY[i]));
+	}
+	//1/w is linear in screen space. each pixel gets its farthest corner, capped at the nearest
+	//vertex, so an occluder is never written in front of where it really is
+	const ScreenVertex& p0 = *v[0];
+	const ScreenVertex& p1 = *v[1];
+	const ScreenVertex& p2 = *v[2];
+	float depthX = ((p1.invW - p0.invW) * (p2.y - p0.y) - (p2.invW - p0.invW) * (p1.y - p0.y)) / area;
+	float depthY = ((p2.invW - p0.invW) * (p1.x - p0.x) - (p1.invW - p0.invW) * (p2.x - p0.x)) / area;
+	float depthC = p0.invW - depthX * p0.x - depthY * p0.y - 0.5f * (std::fabs(depthX) + std::fabs(depthY));
+	float nearest = std::max(p0.invW, std::max(p1.invW, p2.invW));
+
+	float* depth = levels[0].data();
+	int startX = minX & ~3;
+#if defined(OCCLUSION_SSE)
+	if (GetKernelPath() != KernelPath::Scalar)
+	{
+		__m128 offsets = _mm_loadu_ps(PIXEL_OFFSETS);
+		__m128 zero = _mm_setzero_ps();
+		__m128 nearestW = _mm_set1_ps(nearest);
+		__m128 stepX0 = _mm_set1_ps(edgeX[0]), stepX1 = _mm_set1_ps(edgeX[1]), stepX2 = _mm_set1_ps(edgeX[2]);
+		__m128 stepDepth = _mm_set1_ps(depthX);
+		for (int y = minY; y <= maxY; y++)
+		{
+			float pixelY = (float)y + 0.5f;
+			__m128 row0 = _mm_set1_ps(edgeY[0] * pixelY + edgeC[0]);
+			__m128 row1 = _mm_set1_ps(edgeY[1] * pixelY + edgeC[1]);
+			__m128 row2 = _mm_set1_ps(edgeY[2] * pixelY + edgeC[2]);
+			__m128 rowDepth = _mm_set1_ps(depthY * pixelY + depthC);
+			float* row = depth + y * width;
+			for (int x = startX; x <= maxX; x += 4)
+			{
+				__m128 pixelX = _mm_add_ps(_mm_set1_ps((float)x), offsets);
+				__m128 e0 = _mm_add_ps(_mm_mul_ps(stepX0, pixelX), row0);
+				__m128 e1 = _mm_add_ps(_mm_mul_ps(stepX1, pixelX), row1);
+				__m128 e2 = _mm_add_ps(_mm_mul_ps(stepX2, pixelX), row2);
+				__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+				if (_mm_movemask_ps(inside) == 0)
+					continue;
+				__m128 pixelDepth = _mm_min_ps(_mm_add_ps(_mm_mul_ps(stepDepth, pixelX), rowDepth), nearestW);
+				__m128 current = _mm_loadu_ps(row + x);
+				__m128 nearer = _mm_max_ps(current, pixelDepth);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, current)));
+			}
+		}
+		return;
+	}
+#endif
+	for (int y = minY; y <= maxY; y++)
+	{
+		float pixelY = (float)y + 0.5f;
+		float row0 = edgeY[0] * pixelY + edgeC[0];
+		float row1 = edgeY[1] * pixelY + edgeC[1];
+		float row2 = edgeY[2] * pixelY + edgeC[2];
+		float rowDepth = depthY * pixelY + depthC;
+		float* row = depth + y * width;
+		for (int x = startX; x <= maxX; x += 4)
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				float pixelX = (float)x + PIXEL_OFFSETS[i];
+				if (edgeX[0] * pixelX + row0 >= 0.0f && edgeX[1] * pixelX + row1 >= 0.0f && edgeX[2] * pixelX + row2 >= 0.0f)
+				{
+					float pixelDepth = std::min(depthX * pixelX + rowDepth, nearest);
+					if (pixelDepth > row[x + i])
+						row[x + i] = pixelDepth;
+				}
+			}
+		}
+	}
+}
+
+void OcclusionBuffer::Finish()
+{
+	for (unsigned int level = 1; level < levels.size(); level++)
+	{
+		const std::vector<float>& below = levels[level - 1];
+		std::vector<float>& current = levels[level];
+		int belowWidth = levelWidths[level - 1], belowHeight = levelHeights[level - 1];
+		for (int y = 0; y < levelHeights[level]; y++)
+		{
+			int y0 = y * 2, y1 = std::min(y * 2 + 1, belowHeight - 1);
+			for (int x = 0; x < levelWidths[level]; x++)
+			{
+				int x0 = x * 2, x1 = std::min(x * 2 + 1, belowWidth - 1);
+				current[y * levelWidths[level] + x] = std::min(std::min(below[y0 * belowWidth + x0], below[y0 * belowWidth + x1]),
+					std::min(below[y1 * belowWidth + x0], below[y1 * belowWidth + x1]));
+			}
+		}
+	}
+}
+
+bool OcclusionBuffer::IsVisible(glm::vec3 boundsMin, glm::vec3 boundsMax) const
+{
+	float minX = 3.402823466e+38f, minY = 3.402823466e+38f;
+	float maxX = -3.402823466e+38f, maxY = -3.402823466e+38f;
+	float nearestW = 3.402823466e+38f;
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec3 corner = glm::vec3(i & 1 ? boundsMax.x : boundsMin.x, i & 2 ? boundsMax.y : boundsMin.y, i & 4 ? boundsMax.z : boundsMin.z);
+		glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+		//reaches behind the near plane, so it is right in front of the camera
+		if (clip.w < CLIP_W)
+			return true;
+		float invW = 1.0f / clip.w;
+		float x = (clip.x * invW * 0.5f + 0.5f) * width;
+		float y = (clip.y * invW * 0.5f + 0.5f) * height;
+		minX = std::min(minX, x);
+		maxX = std::max(maxX, x);
+		minY = std::min(minY, y);
+		maxY = std::max(maxY, y);
+		nearestW = std::min(nearestW, clip.w);
+	}
+	//entirely off the side of the screen isn't visible either
+	if (maxX < 0.0f || maxY < 0.0f || minX >= (float)width || minY >= (float)height)
+		return false;
+	int x0 = std::max(0, (int)std::floor(minX)), x1 = std::min(width - 1, (int)std::floor(maxX));
+	int y0 = std::max(0, (int)std::floor(minY)), y1 = std::min(height - 1, (int)std::floor(maxY));
+	float boxDepth = 1.0f / nearestW;
+
+	//the level where the box covers at most 4x4 texels, each of which holds the farthest
+	//occluder over its block, so a few reads stand for every pixel
+	unsigned int level = 0;
+	while (level + 1 < levels.size() && ((x1 >> level) - (x0 >> level) > 3 || (y1 >> level) - (y0 >> level) > 3))
+		level++;
+	const std::vector<float>& texels = levels[level];
+	int levelWidth = levelWidths[level];
+	for (int y = y0 >> level; y <= (y1 >> level); y++)
+	{
+		for (int x = x0 >> level; x <= (x1 >> level); x++)
+		{
+			if (texels[y * levelWidth + x] <= boxDepth)
+				return true;
+		}
+	}
+	return false;
+}
+
+int OcclusionBuffer::getWidth()
+{
+	return width;
+}
+
+int OcclusionBuffer::getHeight()
+{
+	return height;
+}
+
+const float* OcclusionBuffer::getDepth()
+{
+	return levels[0].data();
+}
+
+unsigned int OcclusionBuffer::getOccluderCount()
+{
+	return occluderCount;
+}
+
+unsigned int OcclusionBuffer::getTriangleCount()
+{
+	return triangleCount;
+}
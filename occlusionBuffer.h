@@ -0,0 +1,68 @@
+#ifndef OCCLUSION_BUFFER_H
+#define OCCLUSION_BUFFER_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+//a flat shape standing upright on the ground and turned to face the camera, narrowing from
+//bottomHalfWidth at height bottom to topHalfWidth at top (0 makes a triangle). it stands in for
+//part of a model, so it has to fit inside that part from every side or it hides things it shouldn't
+struct UprightOccluder
+{
+	float bottom;
+	float top;
+	float bottomHalfWidth;
+	float topHalfWidth;
+};
+
+//small software depth buffer for occlusion culling on the cpu. a few big occluders close to the
+//camera are rasterized into it each frame and everything else tests its bounding box against it
+//before being drawn. it holds 1/w so nearer is larger and the empty buffer is 0.
+//the rasterizer does 4 pixels at a time with sse unless the collision kernels are forced to the
+//scalar path, which is the reference it must match exactly
+class OcclusionBuffer
+{
+public:
+	OcclusionBuffer(int width = 256, int height = 128);
+
+	//clears the buffer for a new frame seen from eye through viewProjection
+	void Begin(const glm::mat4& viewProjection, glm::vec3 eye);
+	void AddOccluder(glm::vec3 base, const UprightOccluder& shape);
+	//picks the count candidates closest to the eye and adds shapes at each of them.
+	//reorders candidates
+	void AddNearestOccluders(std::vector<glm::vec3>& candidates, unsigned int count, const UprightOccluder* shapes, unsigned int shapeCount);
+	//builds the hierarchy the tests read, call it after the last occluder
+	void Finish();
+	//false only if every pixel the box covers has an occluder in front of all of it.
+	//only reads the buffer, so it can be called from several threads at once
+	bool IsVisible(glm::vec3 boundsMin, glm::vec3 boundsMax) const;
+
+	int getWidth();
+	int getHeight();
+	//1/w of the nearest occluder per pixel, row 0 at the bottom of the screen
+	const float* getDepth();
+	//shapes added and triangles that reached the screen since Begin
+	unsigned int getOccluderCount();
+	unsigned int getTriangleCount();
+private:
+	//vertex after the viewport transform, invW is 1/w
+	struct ScreenVertex
+	{
+		float x, y, invW;
+	};
+	void addTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+	void rasterize(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c);
+	ScreenVertex toScreen(const glm::vec4& clip);
+
+	int width, height;
+	glm::mat4 viewProjection = glm::mat4(1.0f);
+	glm::vec3 eye = glm::vec3(0.0f);
+	//level 0 is the depth buffer, each level after it is half the size and keeps the
+	//farthest (smallest) value of the 2x2 pixels under it
+	std::vector<std::vector<float>> levels;
+	std::vector<int> levelWidths, levelHeights;
+	unsigned int occluderCount = 0, triangleCount = 0;
+};
+
+#endif
@@ -0,0 +1,160 @@
+#include "particleSystem.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const ParticleKindSettings KINDS[PARTICLE_KIND_COUNT] =
+	{
+		//sparks off a trunk, a quick spray back the way the projectile came
+		{ 24, 9.0f, 0.6f, 0.6f, 1.5f, 0.08f, glm::vec3(1.0f, 0.7f, 0.3f) },
+		//an enemy going, a bigger and slower cloud carried on the way the projectile was going
+		{ 96, 6.0f, 0.8f, 1.4f, 2.0f, 0.15f, glm::vec3(0.9f, 0.15f, 0.1f) },
+	};
+
+	//lowbias32, the same integer hash the update shader uses
+	uint32_t hash(uint32_t x)
+	{
+		x ^= x >> 16;
+		x *= 0x7feb352du;
+		x ^= x >> 15;
+		x *= 0x846ca68bu;
+		x ^= x >> 16;
+		return x;
+	}
+
+	//0 to 1 from the top 24 bits of the hash, which a float holds exactly
+	float unitFloat(uint32_t x)
+	{
+		return (float)(hash(x) >> 8) * (1.0f / 16777216.0f);
+	}
+}
+
+ParticleSystem::ParticleSystem(unsigned int capacity)
+{
+	this->capacity = capacity;
+	bursts.reserve(MAX_BURSTS);
+}
+
+bool ParticleSystem::Emit(glm::vec3 position, glm::vec3 direction, ParticleKind kind)
+{
+	const ParticleKindSettings& settings = KINDS[kind];
+	if (bursts.size() == MAX_BURSTS || spawnCount + settings.count > capacity)
+	{
+		droppedBursts++;
+		return false;
+	}
+	bursts.push_back({ position, direction, kind, (ringStart + spawnCount) % capacity, settings.count });
+	spawnCount += settings.count;
+	activeTime = std::max(activeTime, settings.lifetime);
+	return true;
+}
+
+Particle ParticleSystem::Spawn(const ParticleBurst& burst, unsigned int index, unsigned int frame)
+{
+	const ParticleKindSettings& settings = KINDS[burst.kind];
+	uint32_t seed = hash(burst.first ^ hash(frame)) + index * 4u;
+	//a random direction on the sphere, pulled towards the burst's own
+	float z = unitFloat(seed) * 2.0f - 1.0f;
+	float angle = unitFloat(seed + 1u) * 6.2831853f;
+	float ring = std::sqrt(std::max(1.0f - z * z, 0.0f));
+	glm::vec3 randomDirection(ring * std::cos(angle), ring * std::sin(angle), z);
+	glm::vec3 direction = burst.direction * (1.0f - settings.spread) + randomDirection * settings.spread;
+	float length = glm::length(direction);
+	direction = length > 0.0001f ? direction / length : randomDirection;
+
+	Particle particle;
+	particle.position = burst.position;
+	particle.velocity = direction * settings.speed * (0.5f + 0.5f * unitFloat(seed + 2u));
+	particle.life = settings.lifetime * (0.6f + 0.4f * unitFloat(seed + 3u));
+	particle.kind = (float)burst.kind;
+	return particle;
+}
+
+void ParticleSystem::Move(Particle& particle, float timeElapsed)
+{
+	if (particle.life <= 0.0f)
+		return;
+	const ParticleKindSettings& settings = KINDS[(int)particle.kind];
+	particle.life -= timeElapsed;
+	particle.velocity.y += GRAVITY * timeElapsed;
+	particle.velocity *= std::max(1.0f - settings.drag * timeElapsed, 0.0f);
+	particle.position += particle.velocity * timeElapsed;
+	if (particle.position.y < 0.0f)
+	{
+		particle.position.y = 0.0f;
+		particle.velocity.y = -particle.velocity.y * BOUNCE;
+	}
+}
+
+void ParticleSystem::Simulate(float timeElapsed)
+{
+	if (!IsActive())
+		return;
+	if (particles.empty())
+		particles.resize(capacity, { glm::vec3(0.0f), 0.0f, glm::vec3(0.0f), 0.0f });
+	for (const ParticleBurst& burst : bursts)
+	{
+		for (unsigned int i = 0; i < burst.count; i++)
+			particles[(burst.first + i) % capacity] = Spawn(burst, i, frame);
+	}
+	for (Particle& particle : particles)
+		Move(particle, timeElapsed);
+}
+
+void ParticleSystem::EndFrame(float timeElapsed)
+{
+	ringStart = (ringStart + spawnCount) % capacity;
+	spawnCount = 0;
+	bursts.clear();
+	frame++;
+	activeTime = std::max(activeTime - timeElapsed, 0.0f);
+}
+
+bool ParticleSystem::IsActive()
+{
+	return activeTime > 0.0f || !bursts.empty();
+}
+
+unsigned int ParticleSystem::getCapacity()
+{
+	return capacity;
+}
+
+unsigned int ParticleSystem::getRingStart()
+{
+	return ringStart;
+}
+
+unsigned int ParticleSystem::getSpawnCount()
+{
+	return spawnCount;
+}
+
+unsigned int ParticleSystem::getFrame()
+{
+	return frame;
+}
+
+const std::vector<ParticleBurst>& ParticleSystem::getBursts()
+{
+	return bursts;
+}
+
+const std::vector<Particle>& ParticleSystem::getParticles()
+{
+	return particles;
+}
+
+unsigned int ParticleSystem::getDroppedBursts()
+{
+	return droppedBursts;
+}
+
+const ParticleKindSettings& ParticleSystem::getKindSettings(ParticleKind kind)
+{
+	return KINDS[kind];
+}
@@ -0,0 +1,110 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+//one particle, laid out the way GpuParticles keeps them in its vertex buffers. it is dead once life
+//runs out, and every slot starts dead
+struct Particle
+{
+	glm::vec3 position;
+	//seconds left
+	float life;
+	glm::vec3 velocity;
+	//a ParticleKind
+	float kind;
+};
+
+enum ParticleKind
+{
+	PARTICLE_SPARKS,
+	PARTICLE_DEATH,
+	PARTICLE_KIND_COUNT
+};
+
+//how a kind of burst looks and moves, shared by both versions so they can't drift apart
+struct ParticleKindSettings
+{
+	unsigned int count;
+	//fastest a particle starts, the slowest go half as fast
+	float speed;
+	//0 sprays straight along the burst's direction, 1 in every direction
+	float spread;
+	//longest a particle lives, the shortest live 60% of it
+	float lifetime;
+	//fraction of the velocity lost per second
+	float drag;
+	float size;
+	glm::vec3 colour;
+};
+
+//a burst of particles from one place, taking up count slots from first
+struct ParticleBurst
+{
+	glm::vec3 position;
+	glm::vec3 direction;
+	ParticleKind kind;
+	unsigned int first;
+	unsigned int count;
+};
+
+//impact and death particles. the particles live in a fixed ring of slots: each frame's bursts take the
+//slots after the last frame's, so the oldest particles are the ones written over when it is full. a
+//particle's start is worked out from its slot, its burst and the frame alone, with a hash for the
+//randomness, so the gpu can spawn and move all of them with transform feedback from the few bursts
+//sent each frame (GpuParticles) and nothing is done per particle on the cpu. Simulate does the same
+//on the cpu, as the reference the shader follows and for when transform feedback isn't wanted
+class ParticleSystem
+{
+public:
+	ParticleSystem(unsigned int capacity = 65536);
+
+	//adds a burst to this frame. false if the frame already has as many bursts or particles as it can take
+	bool Emit(glm::vec3 position, glm::vec3 direction, ParticleKind kind);
+	//the cpu reference: spawns this frame's bursts and moves every particle, like vParticleUpdate.vert.
+	//the particles are only kept on the cpu when it is used
+	void Simulate(float timeElapsed);
+	//moves the ring past this frame's bursts and clears them, call once a frame after the particles are updated
+	void EndFrame(float timeElapsed);
+	//false once every particle emitted has died, then there is nothing to update or draw
+	bool IsActive();
+
+	unsigned int getCapacity();
+	//the slot this frame's first burst starts at
+	unsigned int getRingStart();
+	//slots this frame's bursts take up altogether
+	unsigned int getSpawnCount();
+	//seeds the hash, so slots reused in a later frame get new particles
+	unsigned int getFrame();
+	const std::vector<ParticleBurst>& getBursts();
+	const std::vector<Particle>& getParticles();
+	//bursts that didn't fit since the start
+	unsigned int getDroppedBursts();
+
+	//the particle at index within burst, spawned in frame
+	static Particle Spawn(const ParticleBurst& burst, unsigned int index, unsigned int frame);
+	static void Move(Particle& particle, float timeElapsed);
+	static const ParticleKindSettings& getKindSettings(ParticleKind kind);
+	//a uniform array in the update shader, so it is fixed
+	static const unsigned int MAX_BURSTS = 64;
+	static constexpr float GRAVITY = -9.8f;
+	//velocity kept across a bounce off the ground
+	static constexpr float BOUNCE = 0.3f;
+
+private:
+	unsigned int capacity;
+	unsigned int ringStart = 0;
+	unsigned int spawnCount = 0;
+	//starts at 1 so the first frame's hash differs from an unseeded one
+	unsigned int frame = 1;
+	std::vector<ParticleBurst> bursts;
+	std::vector<Particle> particles;
+	//seconds until the longest lived particle emitted so far dies
+	float activeTime = 0.0f;
+	unsigned int droppedBursts = 0;
+};
+
+#endif
@@ -4,18 +4,20 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#include "gameObject.h"
-#include "model.h"
+#include "entityPool.h"
 
-class Projectile : public GameObject
+//every live bullet, they fly in a straight line and bounce off the ground
+class ProjectilePool : public EntityPool
 {
 public:
-	Projectile(glm::vec3 position, glm::vec3 velocity, Model* objectModel);
+	ProjectilePool(unsigned int capacity);
+	EntityHandle Fire(glm::vec3 position, glm::vec3 direction);
 	void Update(float timeElapsed);
+	//the same for indices [begin, end) only
+	void UpdateRange(float timeElapsed, unsigned int begin, unsigned int end);
 
-private:
-	glm::vec3 velocity;
-	float speed = 40.0f;
+	const float speed = 40.0f;
+	const float radius = 0.2f;
 };
 
 
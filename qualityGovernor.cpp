@@ -0,0 +1,125 @@
+#include "qualityGovernor.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+	//fractions of the full quality levels, each step down gives up a little more, starting with what
+	//is hardest to notice: coarser lods, then fewer far trees, then the distance and chunks drawn
+	struct QualityStep
+	{
+		float drawDistance;
+		float chunkRadius;
+		float treeDensity;
+		float lodBias;
+	};
+	const QualityStep STEPS[] = {
+		{ 1.0f, 1.0f, 1.0f, 1.0f },
+		{ 1.0f, 1.0f, 1.0f, 0.8f },
+		{ 1.0f, 1.0f, 0.8f, 0.65f },
+		{ 0.9f, 1.0f, 0.65f, 0.65f },
+		{ 0.85f, 0.75f, 0.65f, 0.5f },
+		{ 0.75f, 0.75f, 0.5f, 0.5f },
+		{ 0.7f, 0.5f, 0.4f, 0.4f },
+		{ 0.6f, 0.5f, 0.3f, 0.35f },
+	};
+	const int STEP_COUNT = sizeof(STEPS) / sizeof(STEPS[0]);
+
+	//over budget by this much steps down, under this fraction of it for upDelay frames steps up
+	const float DOWN_MARGIN = 1.1f;
+	const float UP_FRACTION = 0.7f;
+	//a step up waits this many windows, doubled each time one fails up to the most
+	const int UP_DELAY_WINDOWS = 2;
+	const int MAX_UP_DELAY_WINDOWS = 32;
+}
+
+QualityGovernor::QualityGovernor(const QualityLevels& full, float budget)
+	: full(full), levels(full), budget(budget)
+{
+	upDelay = UP_DELAY_WINDOWS * WINDOW;
+}
+
+bool QualityGovernor::AddFrame(float frameTime)
+{
+	frameTimeSum += frameTime - frameTimes[nextFrame];
+	frameTimes[nextFrame] = frameTime;
+	nextFrame = (nextFrame + 1) % WINDOW;
+	framesAtLevel++;
+	//the last change has been given long enough to show whether it was right, so the next step up
+	//goes back to waiting the shortest time
+	if (framesAtLevel == upDelay && steppedUp)
+	{
+		steppedUp = false;
+		upDelay = UP_DELAY_WINDOWS * WINDOW;
+	}
+	if (framesAtLevel < WINDOW)
+		return false;
+
+	float average = frameTimeSum / WINDOW;
+	if (average > budget * DOWN_MARGIN && level < STEP_COUNT - 1)
+	{
+		//stepping up didn't fit, so wait longer before trying it again
+		if (steppedUp)
+			upDelay = std::min(upDelay * 2, MAX_UP_DELAY_WINDOWS * WINDOW);
+		steppedUp = false;
+		setLevel(level + 1);
+		return true;
+	}
+	if (average < budget * UP_FRACTION)
+		framesUnder++;
+	else
+		framesUnder = 0;
+	if (framesUnder >= upDelay && level > 0)
+	{
+		steppedUp = true;
+		setLevel(level - 1);
+		return true;
+	}
+	return false;
+}
+
+void QualityGovernor::setLevel(int newLevel)
+{
+	level = newLevel;
+	const QualityStep& step = STEPS[level];
+	levels.drawDistance = full.drawDistance * step.drawDistance;
+	levels.chunkRadius = std::max(1, (int)std::lround(full.chunkRadius * step.chunkRadius));
+	levels.treeDensity = full.treeDensity * step.treeDensity;
+	levels.lodBias = full.lodBias * step.lodBias;
+	framesAtLevel = 0;
+	framesUnder = 0;
+	changes++;
+}
+
+const QualityLevels& QualityGovernor::getLevels()
+{
+	return levels;
+}
+
+int QualityGovernor::getLevel()
+{
+	return level;
+}
+
+int QualityGovernor::getLevelCount()
+{
+	return STEP_COUNT;
+}
+
+float QualityGovernor::getBudget()
+{
+	return budget;
+}
+
+float QualityGovernor::getAverageFrameTime()
+{
+	if (changes == 0 && framesAtLevel < WINDOW)
+		return 0.0f;
+	return frameTimeSum / WINDOW;
+}
+
+unsigned int QualityGovernor::getChanges()
+{
+	return changes;
+}
@@ -0,0 +1,64 @@
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+//how much of the world is drawn. the simulation always loads and collides with the same chunks,
+//these only decide what the renderer spends its time on
+struct QualityLevels
+{
+	//the far plane and fog, at most the camera's render distance
+	float drawDistance = 100.0f;
+	//rings of chunks drawn around the player's
+	int chunkRadius = 4;
+	//fraction of the trees past Chunk::THINNING_DISTANCE that are drawn
+	float treeDensity = 1.0f;
+	//LodSettings::bias, lower picks coarser lods sooner
+	float lodBias = 1.0f;
+};
+
+//holds the frame time to a budget by stepping quality down when frames run long and back up when
+//there is plenty of room. the average over a window of frames is compared, never a single frame, and
+//a level has to have been running for a whole window before it is judged. stepping down happens as soon
+//as the window is over budget, stepping up only after a long stretch well under it, and a level that
+//had to be left again straight after stepping up to it waits twice as long before it is tried again
+class QualityGovernor
+{
+public:
+	//full is the best quality, budget is the frame time to stay under in seconds
+	QualityGovernor(const QualityLevels& full, float budget);
+
+	//call once a frame with how long its work took, not counting waiting for vsync.
+	//returns true if the level changed
+	bool AddFrame(float frameTime);
+	const QualityLevels& getLevels();
+	//0 is full quality, higher levels draw less
+	int getLevel();
+	int getLevelCount();
+	float getBudget();
+	//average over the window, 0 until it has filled
+	float getAverageFrameTime();
+	//times the level has changed since the start
+	unsigned int getChanges();
+
+	static const int WINDOW = 60;
+private:
+	QualityLevels full;
+	QualityLevels levels;
+	float budget;
+	int level = 0;
+
+	float frameTimes[WINDOW] = {};
+	float frameTimeSum = 0.0f;
+	int nextFrame = 0;
+	//frames added since the level last changed, decisions wait for a full window of them
+	int framesAtLevel = 0;
+	//consecutive frames with the average well under budget, and how many are needed to step up
+	int framesUnder = 0;
+	int upDelay;
+	//whether the last change was a step up, if the next is a step down straight after it failed
+	bool steppedUp = false;
+	unsigned int changes = 0;
+
+	void setLevel(int newLevel);
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef REPLAY_FILE_H
+#define REPLAY_FILE_H
+
+//layout of a recorded run, written by InputRecorder and played back by ReplayInput.
+//everything is stored in the machine's byte order, replays are for comparing builds on the same machine.
+//  header: "FSRP", version, then ReplayHeader's fields in order
+//  frame:  flags byte, cursor x and y as doubles if FRAME_CURSOR is set, render alpha as a float,
+//          tick count as a varint, then one byte of held keys per tick (bit n is InputKey n)
+//  end:    FRAME_END instead of the flags byte, then the tick count and Simulation::StateHash at the end of the run
+
+const char REPLAY_MAGIC[4] = { 'F', 'S', 'R', 'P' };
+const unsigned short REPLAY_VERSION = 1;
+
+const unsigned char FRAME_CURSOR = 1;
+const unsigned char FRAME_END = 0xff;
+
+//everything needed to start the simulation the same way again
+struct ReplayHeader
+{
+	unsigned int seed = 0;
+	float tickTime = 1.0f / 60.0f;
+	unsigned char flocking = 0;
+	int stressEnemies = 0;
+	int chunkRadius = 4;
+};
+
+#endif
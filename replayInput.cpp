@@ -0,0 +1,152 @@
+#include "replayInput.h"
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+
+ReplayInput::ReplayInput(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "failed to open replay " << path << std::endl;
+		return;
+	}
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	unsigned short version = 0;
+	if (data.size() < 4 || memcmp(data.data(), REPLAY_MAGIC, 4) != 0)
+	{
+		std::cout << path << " is not a replay" << std::endl;
+		return;
+	}
+	offset = 4;
+	if (!get(version) || version != REPLAY_VERSION)
+	{
+		std::cout << path << " is replay version " << version << ", expected " << REPLAY_VERSION << std::endl;
+		return;
+	}
+	if (!get(header.seed) || !get(header.tickTime) || !get(header.flocking) || !get(header.stressEnemies) || !get(header.chunkRadius))
+	{
+		std::cout << path << " is truncated" << std::endl;
+		return;
+	}
+	loaded = true;
+}
+
+bool ReplayInput::IsLoaded()
+{
+	return loaded;
+}
+
+const ReplayHeader& ReplayInput::getHeader()
+{
+	return header;
+}
+
+bool ReplayInput::IsDown(InputKey key)
+{
+	return (keys >> (unsigned int)key) & 1;
+}
+
+void ReplayInput::GetCursor(double& x, double& y)
+{
+	x = cursorX;
+	y = cursorY;
+}
+
+bool ReplayInput::NextFrame()
+{
+	if (!loaded || ended)
+		return false;
+	frameTicks = 0;
+	tickInFrame = 0;
+
+	unsigned char flags;
+	unsigned long long ticks;
+	if (!get(flags))
+	{
+		std::cout << "replay ended without an end marker" << std::endl;
+		ended = true;
+		return false;
+	}
+	if (flags == FRAME_END)
+	{
+		get(recordedTicks);
+		get(recordedHash);
+		ended = true;
+		return false;
+	}
+	if ((flags & FRAME_CURSOR) && (!get(cursorX) || !get(cursorY)))
+		ended = true;
+	if (ended || !get(frameAlpha) || !getVarint(ticks) || offset + ticks > data.size())
+	{
+		std::cout << "replay is truncated" << std::endl;
+		ended = true;
+		return false;
+	}
+	//the keys are read from where they are, so the next frame is found even if not every tick is played
+	frameTicks = (unsigned int)ticks;
+	frameKeys = offset;
+	offset += frameTicks;
+	return true;
+}
+
+void ReplayInput::NextTick()
+{
+	keys = tickInFrame < frameTicks ? data[frameKeys + tickInFrame] : 0;
+	tickInFrame++;
+}
+
+unsigned int ReplayInput::getFrameTicks()
+{
+	return frameTicks;
+}
+
+float ReplayInput::getFrameAlpha()
+{
+	return frameAlpha;
+}
+
+bool ReplayInput::Verify(unsigned long long ticks, unsigned long long stateHash)
+{
+	if (recordedTicks == 0 && recordedHash == 0)
+	{
+		std::cout << "replay has no end state to check against" << std::endl;
+		return false;
+	}
+	if (ticks != recordedTicks || stateHash != recordedHash)
+	{
+		std::cout << "replay diverged: " << ticks << " ticks, state " << std::hex << stateHash << ", recorded "
+			<< std::dec << recordedTicks << " ticks, state " << std::hex << recordedHash << std::dec << std::endl;
+		return false;
+	}
+	std::cout << "replay matches the recording after " << ticks << " ticks" << std::endl;
+	return true;
+}
+
+template <typename T>
+bool ReplayInput::get(T& value)
+{
+	if (offset + sizeof(T) > data.size())
+		return false;
+	memcpy(&value, data.data() + offset, sizeof(T));
+	offset += sizeof(T);
+	return true;
+}
+
+bool ReplayInput::getVarint(unsigned long long& value)
+{
+	value = 0;
+	for (unsigned int shift = 0; shift < 64; shift += 7)
+	{
+		unsigned char byte;
+		if (!get(byte))
+			return false;
+		value |= (unsigned long long)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
@@ -0,0 +1,49 @@
+#ifndef REPLAY_INPUT_H
+#define REPLAY_INPUT_H
+
+#include <string>
+#include <vector>
+
+#include "input.h"
+#include "replayFile.h"
+
+//plays back a run written by InputRecorder. start the simulation from getHeader(), then for each frame
+//call NextFrame, look, and call NextTick before each of getFrameTicks() ticks. on the same build the
+//simulation ends up in exactly the state it was recorded in, which Verify checks
+class ReplayInput : public InputSource
+{
+public:
+	ReplayInput(const std::string& path);
+	bool IsLoaded();
+	const ReplayHeader& getHeader();
+	bool IsDown(InputKey key) override;
+	void GetCursor(double& x, double& y) override;
+	//moves on to the next recorded frame, false once they have all been played
+	bool NextFrame();
+	void NextTick();
+	unsigned int getFrameTicks();
+	float getFrameAlpha();
+	//compares the end of the run with the recording, prints where it differs
+	bool Verify(unsigned long long ticks, unsigned long long stateHash);
+private:
+	std::vector<unsigned char> data;
+	size_t offset = 0;
+	bool loaded = false;
+	ReplayHeader header;
+
+	unsigned char keys = 0;
+	double cursorX = 0.0, cursorY = 0.0;
+	float frameAlpha = 1.0f;
+	unsigned int frameTicks = 0;
+	unsigned int tickInFrame = 0;
+	size_t frameKeys = 0;
+	bool ended = false;
+	unsigned long long recordedTicks = 0;
+	unsigned long long recordedHash = 0;
+
+	template <typename T>
+	bool get(T& value);
+	bool getVarint(unsigned long long& value);
+};
+
+#endif
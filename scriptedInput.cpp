@@ -0,0 +1,110 @@
+#include "scriptedInput.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+namespace
+{
+	const char* DEFAULT_SCRIPT =
+		"120 forward fire turn 2 0\n"
+		"60 forward sprint fire\n"
+		"90 left fire turn -3 0\n"
+		"60 back fire turn 0 1\n"
+		"90 right forward fire turn 1 -1\n";
+
+	unsigned int keyBit(InputKey key)
+	{
+		return 1u << (unsigned int)key;
+	}
+}
+
+ScriptedInput::ScriptedInput(const std::string& path)
+{
+	if (path != "")
+	{
+		std::ifstream file(path);
+		if (!file)
+			std::cout << "failed to open input script " << path << ", using the default" << std::endl;
+		else if (!parse(file))
+			std::cout << "invalid input script " << path << ", using the default" << std::endl;
+	}
+	if (steps.empty())
+	{
+		std::istringstream script(DEFAULT_SCRIPT);
+		parse(script);
+	}
+}
+
+bool ScriptedInput::parse(std::istream& script)
+{
+	steps.clear();
+	std::string line;
+	while (std::getline(script, line))
+	{
+		size_t comment = line.find('#');
+		if (comment != std::string::npos)
+			line.erase(comment);
+		std::istringstream words(line);
+		Step current;
+		if (!(words >> current.ticks))
+		{
+			if (line.find_first_not_of(" \t\r") == std::string::npos)
+				continue;
+			steps.clear();
+			return false;
+		}
+		std::string word;
+		while (words >> word)
+		{
+			if (word == "forward")
+				current.keys |= keyBit(InputKey::Forward);
+			else if (word == "back")
+				current.keys |= keyBit(InputKey::Back);
+			else if (word == "left")
+				current.keys |= keyBit(InputKey::Left);
+			else if (word == "right")
+				current.keys |= keyBit(InputKey::Right);
+			else if (word == "sprint")
+				current.keys |= keyBit(InputKey::Sprint);
+			else if (word == "fire")
+				current.keys |= keyBit(InputKey::Fire);
+			else if (word == "regenerate")
+				current.keys |= keyBit(InputKey::RegenerateChunks);
+			else if (word == "toggle")
+				current.keys |= keyBit(InputKey::ToggleEnemies);
+			else if (word == "turn" && (words >> current.turnX >> current.turnY))
+				continue;
+			else
+			{
+				steps.clear();
+				return false;
+			}
+		}
+		if (current.ticks > 0)
+			steps.push_back(current);
+	}
+	return !steps.empty();
+}
+
+bool ScriptedInput::IsDown(InputKey key)
+{
+	return (steps[step].keys & keyBit(key)) != 0;
+}
+
+void ScriptedInput::GetCursor(double& x, double& y)
+{
+	x = cursorX;
+	y = cursorY;
+}
+
+void ScriptedInput::Advance()
+{
+	cursorX += steps[step].turnX;
+	cursorY += steps[step].turnY;
+	if (++tickInStep >= steps[step].ticks)
+	{
+		tickInStep = 0;
+		step = (step + 1) % steps.size();
+	}
+}
@@ -0,0 +1,37 @@
+#ifndef SCRIPTED_INPUT_H
+#define SCRIPTED_INPUT_H
+
+#include <string>
+#include <vector>
+#include <istream>
+
+#include "input.h"
+
+//input played from a script, one step per line, looping when it reaches the end:
+//  <ticks> [forward] [back] [left] [right] [sprint] [fire] [regenerate] [toggle] [turn <dx> <dy>]
+//keys are held for the whole step and turn moves the cursor every tick. # starts a comment
+class ScriptedInput : public InputSource
+{
+public:
+	//an empty path, or a script that fails to load, uses a built in one that walks, turns and shoots
+	ScriptedInput(const std::string& path = "");
+	bool IsDown(InputKey key) override;
+	void GetCursor(double& x, double& y) override;
+	//call after each tick to move on to the next one
+	void Advance();
+private:
+	struct Step
+	{
+		unsigned int ticks = 1;
+		unsigned int keys = 0;
+		double turnX = 0.0, turnY = 0.0;
+	};
+	std::vector<Step> steps;
+	unsigned int step = 0;
+	unsigned int tickInStep = 0;
+	double cursorX = 0.0, cursorY = 0.0;
+
+	bool parse(std::istream& script);
+};
+
+#endif
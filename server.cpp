@@ -0,0 +1,109 @@
+//hosts the world for one client on this machine, the stand in for a real server. it waits for the game
+//or headless to connect with --connect, then runs the simulation at the tick rate from the client's
+//commands and sends it a snapshot after every tick. reports the tick and encoding costs and the bytes
+//sent every few seconds, and exits when the client leaves or goes quiet:
+//  forestServer [--port <n>] [--seed <n>] [--tick-rate <n>] [--threads <n>] [--flocking] [--stress <n>] [--ticks <n>]
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <stdlib.h>
+
+#include "netServer.h"
+#include "framePacer.h"
+#include "jobSystem.h"
+
+namespace
+{
+	const float REPORT_TIME = 5.0f;
+	//a client that stops sending without saying bye has gone
+	const float CLIENT_TIMEOUT = 5.0f;
+
+	void report(NetServer& server, unsigned long long& lastTicks, unsigned long long& lastBytes, double& lastTickTime, double& lastEncodeTime, float tickTime)
+	{
+		unsigned long long ticks = server.getTicks() - lastTicks;
+		if (ticks == 0)
+			return;
+		double bytes = (double)(server.getBytesSent() - lastBytes) / ticks;
+		Simulation& sim = server.getSimulation();
+		std::cout << "server: tick " << sim.ticks << ", " << (server.getTickMilliseconds() - lastTickTime) / ticks << "ms per tick, "
+			<< (server.getEncodeMilliseconds() - lastEncodeTime) / ticks << "ms encoding, " << bytes << " bytes per tick ("
+			<< bytes / tickTime / 1024.0 << "KB/s), " << sim.enemies.Size() << " enemies, " << sim.projectiles.Size() << " projectiles" << std::endl;
+		lastTicks = server.getTicks();
+		lastBytes = server.getBytesSent();
+		lastTickTime = server.getTickMilliseconds();
+		lastEncodeTime = server.getEncodeMilliseconds();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	unsigned short port = NET_DEFAULT_PORT;
+	float tickRate = 60.0f;
+	int threadCount = 0;
+	unsigned long long tickLimit = 0;
+	SimulationSettings settings;
+	settings.seed = 1;
+	settings.printScore = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--port" && i + 1 < argc)
+			port = (unsigned short)atoi(argv[++i]);
+		else if (std::string(argv[i]) == "--seed" && i + 1 < argc)
+			settings.seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+		else if (std::string(argv[i]) == "--tick-rate" && i + 1 < argc)
+			tickRate = (float)atof(argv[++i]);
+		else if (std::string(argv[i]) == "--threads" && i + 1 < argc)
+			threadCount = atoi(argv[++i]);
+		else if (std::string(argv[i]) == "--flocking")
+			settings.flocking = true;
+		else if (std::string(argv[i]) == "--stress" && i + 1 < argc)
+			settings.stressEnemies = atoi(argv[++i]);
+		else if (std::string(argv[i]) == "--ticks" && i + 1 < argc)
+			tickLimit = strtoull(argv[++i], nullptr, 10);
+	}
+	if (threadCount < 0)
+		threadCount = 0;
+	if (settings.stressEnemies < 0)
+		settings.stressEnemies = 0;
+	if (tickRate < 1.0f)
+		tickRate = 1.0f;
+	float tickTime = 1.0f / tickRate;
+
+	JobSystem jobs(threadCount);
+	NetServer server(settings, tickTime, jobs, port);
+	if (!server.IsOpen())
+		return 1;
+	std::cout << "waiting for a client on port " << port << std::endl;
+
+	//the server keeps its own time, the client's commands are queued until their tick comes round
+	FramePacer pacer(tickRate);
+	unsigned long long lastTicks = 0, lastBytes = 0;
+	double lastTickTime = 0.0, lastEncodeTime = 0.0;
+	float sinceReport = 0.0f;
+	while (!server.ClientLeft() && server.getSilence() < CLIENT_TIMEOUT && (tickLimit == 0 || server.getTicks() < tickLimit))
+	{
+		pacer.Wait();
+		server.Receive();
+		if (!server.HasClient())
+			continue;
+		server.Tick();
+		sinceReport += tickTime;
+		if (sinceReport >= REPORT_TIME)
+		{
+			sinceReport = 0.0f;
+			report(server, lastTicks, lastBytes, lastTickTime, lastEncodeTime, tickTime);
+		}
+	}
+	report(server, lastTicks, lastBytes, lastTickTime, lastEncodeTime, tickTime);
+	server.Disconnect();
+
+	unsigned long long ticks = server.getTicks() > 0 ? server.getTicks() : 1;
+	std::cout << (server.ClientLeft() ? "client left" : server.getSilence() >= CLIENT_TIMEOUT ? "client stopped sending" : "stopped") << " after " << server.getTicks() << " ticks: "
+		<< server.getTickMilliseconds() / ticks << "ms per tick, " << server.getEncodeMilliseconds() / ticks << "ms encoding, "
+		<< (double)server.getBytesSent() / ticks << " bytes per tick, " << server.getFullSnapshots() << " full snapshots, "
+		<< server.getRepeatedCommands() << " ticks without a new command, " << server.getDroppedCommands() << " commands dropped" << std::endl;
+	Simulation& sim = server.getSimulation();
+	std::cout << "score " << sim.score << ", highscore " << sim.highscore << ", deaths " << sim.deaths << ", state " << std::hex << sim.StateHash() << std::dec << std::endl;
+	return 0;
+}
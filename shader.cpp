@@ -13,10 +13,23 @@ Shader::Shader(const char* VertexShaderPath, const char* FragmentShaderPath)
 
 	vShader = compileShader(VertexShaderPath, false);
 	fShader = compileShader(FragmentShaderPath, true);
-	
+	link(vShader, fShader, nullptr, 0);
+}
+
+Shader::Shader(const char* VertexShaderPath, const char* const* feedbackVaryings, int feedbackCount)
+{
+	link(compileShader(VertexShaderPath, false), 0, feedbackVaryings, feedbackCount);
+}
+
+void Shader::link(unsigned int vShader, unsigned int fShader, const char* const* feedbackVaryings, int feedbackCount)
+{
 	shaderProgram = glCreateProgram();
 	glAttachShader(shaderProgram, vShader);
-	glAttachShader(shaderProgram, fShader);
+	if (fShader != 0)
+		glAttachShader(shaderProgram, fShader);
+	//has to be set before linking
+	if (feedbackCount > 0)
+		glTransformFeedbackVaryings(shaderProgram, feedbackCount, feedbackVaryings, GL_INTERLEAVED_ATTRIBS);
 	glLinkProgram(shaderProgram);
 
 	int isLinked = 0;
@@ -36,9 +49,12 @@ Shader::Shader(const char* VertexShaderPath, const char* FragmentShaderPath)
 		glDeleteProgram(shaderProgram);
 	}
 	glDetachShader(shaderProgram, vShader);
-	glDetachShader(shaderProgram, fShader);
 	glDeleteShader(vShader);
-	glDeleteShader(fShader);
+	if (fShader != 0)
+	{
+		glDetachShader(shaderProgram, fShader);
+		glDeleteShader(fShader);
+	}
 }
 
 Shader::~Shader()
@@ -90,7 +106,7 @@ void Shader::Use()
 	glUseProgram(shaderProgram);
 }
 
-unsigned int Shader::Location(const std::string &uniformName) const
+unsigned int Shader::Location(const char* uniformName) const
 {
-	return glGetUniformLocation(shaderProgram, uniformName.c_str());
+	return glGetUniformLocation(shaderProgram, uniformName);
 }
\ No newline at end of file
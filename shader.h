@@ -12,13 +12,18 @@ class Shader
 {
 public:
 	Shader(const char* VertexShaderPath, const char* FragmentShaderPath);
+	//a vertex shader on its own for transform feedback, the named outputs are written out interleaved in order
+	Shader(const char* VertexShaderPath, const char* const* feedbackVaryings, int feedbackCount);
 	~Shader();
 	void Use();
-	unsigned int Location(const std::string& uniformName) const;
+	//takes a plain string so looking up a literal never allocates
+	unsigned int Location(const char* uniformName) const;
 	
 private:
 	unsigned int shaderProgram;
 	unsigned int compileShader(const char* path, bool isFragmentShader);
+	//fShader can be 0
+	void link(unsigned int vShader, unsigned int fShader, const char* const* feedbackVaryings, int feedbackCount);
 };
 
 
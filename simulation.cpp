@@ -0,0 +1,805 @@
+#include "simulation.h"
+
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+namespace
+{
+	const unsigned int PROJECTILE_CAPACITY = 4096;
+	const unsigned int ENEMY_CAPACITY = 4096;
+	const float SHOT_DELAY = 0.1f;
+	const float INITIAL_ENEMY_DELAY = 6.0f;
+	const float DIFFICULTY_DELAY = 5.0f;
+	const float DANGER_RANGE = 30.0f;
+	//enemies path around trees with one field shared by all of them, over the chunks kept around the player
+	const int FLOW_CELLS_PER_CHUNK = 15;
+	const float TREE_CLEARANCE = Simulation::TRUNK_RADIUS + 1.0f;
+	//entities per parallel range, small enough to spread a few thousand across the workers
+	const unsigned int ENTITY_GRAIN = 512;
+	const unsigned int PROJECTILE_GRAIN = 64;
+
+	unsigned int enemyCapacity(const SimulationSettings& settings)
+	{
+		return settings.stressEnemies > (int)ENEMY_CAPACITY ? (unsigned int)settings.stressEnemies : ENEMY_CAPACITY;
+	}
+
+	//fnv-1a, hashes the raw bytes so a difference in the last bit of a float shows up
+	void hashBytes(unsigned long long& hash, const void* data, size_t size)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	template <typename T>
+	void put(std::vector<unsigned char>& out, const T& value)
+	{
+		const unsigned char* bytes = (const unsigned char*)&value;
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	void putEntities(std::vector<unsigned char>& out, EntityPool& pool)
+	{
+		unsigned int count = pool.Size();
+		put(out, count);
+		const unsigned char* arrays[3] = { (const unsigned char*)pool.positions.data(), (const unsigned char*)pool.previousPositions.data(), (const unsigned char*)pool.velocities.data() };
+		for (const unsigned char* array : arrays)
+			out.insert(out.end(), array, array + count * sizeof(glm::vec3));
+	}
+
+	//reads a snapshot where it is, every read checks it stays inside the data
+	struct SnapshotReader
+	{
+		const unsigned char* data;
+		size_t size;
+		size_t offset;
+
+		template <typename T>
+		bool get(T& value)
+		{
+			if (size - offset < sizeof(T))
+				return false;
+			memcpy(&value, data + offset, sizeof(T));
+			offset += sizeof(T);
+			return true;
+		}
+		bool skip(size_t bytes)
+		{
+			if (size - offset < bytes)
+				return false;
+			offset += bytes;
+			return true;
+		}
+	};
+
+	bool getHeader(SnapshotReader& reader, SnapshotHeader& header)
+	{
+		unsigned short version = 0;
+		if (reader.size < 4 || memcmp(reader.data, SNAPSHOT_MAGIC, 4) != 0)
+		{
+			std::cout << "not a snapshot" << std::endl;
+			return false;
+		}
+		reader.offset = 4;
+		if (!reader.get(version) || version != SNAPSHOT_VERSION)
+		{
+			std::cout << "snapshot version " << version << ", expected " << SNAPSHOT_VERSION << std::endl;
+			return false;
+		}
+		if (!reader.get(header.seed) || !reader.get(header.flocking) || !reader.get(header.stressEnemies) || !reader.get(header.chunkRadius))
+		{
+			std::cout << "snapshot is truncated" << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	//skips over count entities, false if they aren't all there or there are more than pool has room for
+	bool skipEntities(SnapshotReader& reader, EntityPool& pool, unsigned int& count)
+	{
+		return reader.get(count) && count <= pool.positions.capacity() && reader.skip((size_t)count * 3 * sizeof(glm::vec3));
+	}
+
+	//adds count entities to pool, which has been cleared, from where skipEntities checked them
+	void getEntities(SnapshotReader& reader, EntityPool& pool, float radius)
+	{
+		unsigned int count = 0;
+		reader.get(count);
+		const unsigned char* positions = reader.data + reader.offset;
+		const unsigned char* previousPositions = positions + count * sizeof(glm::vec3);
+		const unsigned char* velocities = previousPositions + count * sizeof(glm::vec3);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			glm::vec3 position, previousPosition, velocity;
+			memcpy(&position, positions + i * sizeof(glm::vec3), sizeof(glm::vec3));
+			memcpy(&previousPosition, previousPositions + i * sizeof(glm::vec3), sizeof(glm::vec3));
+			memcpy(&velocity, velocities + i * sizeof(glm::vec3), sizeof(glm::vec3));
+			pool.Add(position, velocity, radius);
+			pool.previousPositions[i] = previousPosition;
+		}
+		reader.offset += (size_t)count * 3 * sizeof(glm::vec3);
+	}
+}
+
+Simulation::Simulation(const SimulationSettings& settings, JobSystem& jobs)
+	: projectiles(PROJECTILE_CAPACITY),
+	enemies(enemyCapacity(settings)),
+	settings(settings),
+	jobs(&jobs),
+	randomGen(settings.seed),
+	numChunks(settings.chunkRadius),
+	spawnXRange(-(CHUNK_WIDTH / 2), (CHUNK_WIDTH / 2)),
+	spawnZRange(-(CHUNK_HEIGHT / 2), (CHUNK_HEIGHT / 2)),
+	treeRange(0, MAX_TREES),
+	flowField(numChunks * 2 + 1, CHUNK_WIDTH, FLOW_CELLS_PER_CHUNK),
+	enemyDelay(INITIAL_ENEMY_DELAY),
+	spawnDirection(0.0f, 90.0f),
+	spawnHeight(0.1f, 10.0f),
+	spawnQuadrant(0, 1),
+	enemyGrid(4.0f, enemyCapacity(settings))
+{
+	range = (int)(camera.getRenderDistance() + 100.0f);
+	//a wide chunk radius must not evict its own corners
+	int windowReach = (int)(numChunks * CHUNK_WIDTH * 1.4143f + CHUNK_WIDTH);
+	if (range < windowReach)
+		range = windowReach;
+	nearbyEnemies.reserve(enemyCapacity(settings));
+	//everything within range can be loaded at once. the chunks are made up front and
+	//passed between chunks and spareChunks from then on
+	loadedAcross = range / (int)CHUNK_WIDTH * 2 + 3;
+	chunks.reserve(loadedAcross * loadedAcross);
+	spareChunks.reserve(loadedAcross * loadedAcross);
+	//a chunk is kept until it is range from the camera, and the camera can be a chunk away from currentSquare
+	chunkCellsAcross = loadedAcross + 2;
+	chunkCells.assign(chunkCellsAcross * chunkCellsAcross, -1);
+	for (int i = 0; i < loadedAcross * loadedAcross; i++)
+		spareChunks.emplace_back(MAX_TREES);
+	//room for every projectile in a range touching a few enemies, a bigger pile up grows its list once
+	projectileHits.resize(JobSystem::RangeCount(PROJECTILE_CAPACITY, PROJECTILE_GRAIN));
+	for (unsigned int i = 0; i < projectileHits.size(); i++)
+		projectileHits[i].reserve(PROJECTILE_GRAIN * 2 * 4);
+	trunkImpacts.resize(JobSystem::RangeCount(PROJECTILE_CAPACITY, ENTITY_GRAIN));
+	for (unsigned int i = 0; i < trunkImpacts.size(); i++)
+		trunkImpacts[i].reserve(ENTITY_GRAIN);
+	//a projectile can take out a few enemies at once, but never more than there are
+	impacts.reserve(PROJECTILE_CAPACITY + enemyCapacity(settings));
+	collidingChunks.reserve(4);
+	workerNearbyEnemies.resize(jobs.getWorkerCount());
+	for (unsigned int i = 0; i < workerNearbyEnemies.size(); i++)
+		workerNearbyEnemies[i].reserve(enemyCapacity(settings));
+}
+
+void Simulation::Look(InputSource& input, float timeElapsed)
+{
+	double xPos, yPos;
+	input.GetCursor(xPos, yPos);
+	camera.CursorPosCallback(xPos, yPos, timeElapsed);
+}
+
+void Simulation::Tick(InputSource& input, float tickTime)
+{
+	ticks++;
+	jobs->ResetScratch();
+	impacts.clear();
+	camera.SaveState();
+	projectiles.SaveState();
+	enemies.SaveState();
+
+	difficultyTimer += tickTime;
+	if (difficultyTimer > DIFFICULTY_DELAY)
+	{
+		difficultyTimer = 0.0f;
+		enemyDelay -= 0.2f;
+		if (enemyDelay < 1.0f)
+			enemyDelay = 1.0f;
+	}
+
+	camera.KeyHandler(input, tickTime);
+	if (input.IsDown(InputKey::Fire))
+	{
+		addProjectile();
+	}
+	if (input.IsDown(InputKey::RegenerateChunks))
+	{
+		clearChunks();
+	}
+	if (input.IsDown(InputKey::ToggleEnemies) && !holdingButton)
+	{
+		enemiesEnabled = !enemiesEnabled;
+		holdingButton = true;
+		enemies.Clear();
+	}
+	if (holdingButton)
+	{
+		if (!input.IsDown(InputKey::ToggleEnemies))
+		{
+			holdingButton = false;
+		}
+	}
+	if (settings.stressEnemies > 0 && enemiesEnabled)
+	{
+		//topped straight back up instead of waiting on the spawn timer
+		while (enemies.Size() < (unsigned int)settings.stressEnemies)
+			addEnemy();
+	}
+	else if (enemyTimer > enemyDelay && enemiesEnabled)
+	{
+		enemyTimer = 0;
+		addEnemy();
+	}
+
+	UpdateChunks();
+
+	shotTimer += tickTime;
+	enemyTimer += tickTime;
+	bool playerHit = collide();
+
+	//each projectile only writes its own index, so ranges run in parallel
+	unsigned int projectileRanges = JobSystem::RangeCount(projectiles.Size(), ENTITY_GRAIN);
+	if (trunkImpacts.size() < projectileRanges)
+		trunkImpacts.resize(projectileRanges);
+	jobs->ParallelFor(projectiles.Size(), ENTITY_GRAIN, [&](unsigned int begin, unsigned int end, unsigned int /*worker*/)
+	{
+		std::vector<Impact>& rangeImpacts = trunkImpacts[begin / ENTITY_GRAIN];
+		rangeImpacts.clear();
+		projectiles.UpdateRange(tickTime, begin, end);
+		for (unsigned int i = begin; i < end; i++)
+		{
+			if (glm::distance(projectiles.positions[i], camera.getPos()) > range * 2)
+			{
+				projectiles.Kill(i);
+				continue;
+			}
+			//sweep the whole move this tick so fast projectiles can't skip through a trunk
+			float fraction;
+			if (segmentHitsTrunk(projectiles.previousPositions[i], projectiles.positions[i], TRUNK_RADIUS + projectiles.radius, fraction))
+			{
+				//one that already hit an enemy this tick isn't there any more to hit the tree
+				if (projectiles.alive[i])
+					rangeImpacts.push_back({ glm::mix(projectiles.previousPositions[i], projectiles.positions[i], fraction), -glm::normalize(projectiles.velocities[i]), Impact::Tree });
+				projectiles.Kill(i);
+			}
+		}
+	});
+	for (unsigned int r = 0; r < projectileRanges; r++)
+		impacts.insert(impacts.end(), trunkImpacts[r].begin(), trunkImpacts[r].end());
+	projectiles.RemoveDead();
+
+	if (playerHit)
+	{
+		enemies.Clear();
+		projectiles.Clear();
+		clearChunks();
+		deaths++;
+		if (settings.printScore)
+			std::cout << "\nYOU DIED\nHighscore: " << highscore << "\nFinal Score: " << score << std::endl;
+		if (score > highscore)
+			highscore = score;
+		score = 0;
+		enemyDelay = INITIAL_ENEMY_DELAY;
+	}
+	else
+	{
+		auto pos = camera.getPos();
+		pos.y -= 0.3f;
+		if (settings.flocking)
+		{
+			enemies.UpdateFlock(tickTime, pos, flockSettings, enemyGrid, *jobs, ENTITY_GRAIN, &flowField);
+		}
+		else
+		{
+			jobs->ParallelFor(enemies.Size(), ENTITY_GRAIN, [&](unsigned int begin, unsigned int end, unsigned int /*worker*/)
+			{
+				enemies.UpdateRange(tickTime, pos, begin, end, &flowField);
+			});
+		}
+	}
+}
+
+int Simulation::getLoadedAcross()
+{
+	return loadedAcross;
+}
+
+void Simulation::UpdateChunks()
+{
+	auto currentPos = camera.getPos();
+	collidingChunks.clear();
+	for (unsigned int i = 0; i < chunks.size(); i++)
+	{
+		if (glm::distance(chunks[i].getPos(), currentPos) > range)
+		{
+			flowField.RemoveObstacles(chunks[i].getTreePositions(), TREE_CLEARANCE);
+			spareChunks.push_back(std::move(chunks[i]));
+			chunks.erase(chunks.begin() + i--);
+			continue;
+		}
+		auto chunkPos = chunks[i].getPos();
+		chunkPos.x -= CHUNK_WIDTH / 2;
+		chunkPos.z -= CHUNK_HEIGHT / 2;
+		if (currentPos.x > chunkPos.x - 1.0f && currentPos.x < chunkPos.x + CHUNK_WIDTH + 1.0f &&
+			currentPos.z > chunkPos.z - 1.0f && currentPos.z < chunkPos.z + CHUNK_HEIGHT + 1.0f)
+		{
+			collidingChunks.push_back(&chunks[i]);
+		}
+	}
+	unsigned int loadedChunks = chunks.size();
+	if (collidingChunks.size() == 0)
+	{
+		clearChunks();
+		loadedChunks = 0;
+		currentSquare.x = camera.getPos().x;
+		currentSquare.z = camera.getPos().z;
+		addChunks();
+	}
+	else
+	{
+		bool chunkFound = false;
+		for (unsigned int i = 0; i < collidingChunks.size(); i++)
+		{
+			if (currentSquare.x == collidingChunks[i]->getPos().x && currentSquare.z == collidingChunks[i]->getPos().z)
+			{
+				chunkFound = true;
+			}
+		}
+		if (!chunkFound)
+		{
+			currentSquare.x = collidingChunks[0]->getPos().x;
+			currentSquare.z = collidingChunks[0]->getPos().z;
+			addChunks();
+		}
+	}
+
+	//the field follows the player's chunk, when it moves every chunk is added again, otherwise just the new ones
+	if (flowField.SetOrigin(currentSquare))
+		loadedChunks = 0;
+	for (unsigned int i = loadedChunks; i < chunks.size(); i++)
+		flowField.AddObstacles(chunks[i].getTreePositions(), TREE_CLEARANCE);
+	flowField.SetTarget(camera.getPos());
+	indexChunks();
+}
+
+void Simulation::indexChunks()
+{
+	//every loaded chunk is on the lattice through currentSquare, addChunks only ever adds to it and a
+	//new currentSquare is either one of those chunks or comes with every chunk cleared
+	std::fill(chunkCells.begin(), chunkCells.end(), -1);
+	int half = chunkCellsAcross / 2;
+	for (unsigned int i = 0; i < chunks.size(); i++)
+	{
+		int x = (int)std::lround((chunks[i].getPos().x - currentSquare.x) / CHUNK_WIDTH) + half;
+		int z = (int)std::lround((chunks[i].getPos().z - currentSquare.z) / CHUNK_HEIGHT) + half;
+		if (x >= 0 && x < chunkCellsAcross && z >= 0 && z < chunkCellsAcross)
+			chunkCells[z * chunkCellsAcross + x] = (int)i;
+	}
+}
+
+bool Simulation::segmentHitsTrunk(glm::vec3 start, glm::vec3 end, float radius, float& fraction)
+{
+	//the chunks the move's bounds touch, widened by the radius since trunks poke out of their chunk.
+	//a move is far shorter than a chunk, so this is one chunk or the two or four around a corner
+	glm::vec3 low = glm::min(start, end) - glm::vec3(radius);
+	glm::vec3 high = glm::max(start, end) + glm::vec3(radius);
+	int half = chunkCellsAcross / 2;
+	int minX = std::max((int)std::floor((low.x - currentSquare.x) / CHUNK_WIDTH + 0.5f) + half, 0);
+	int maxX = std::min((int)std::floor((high.x - currentSquare.x) / CHUNK_WIDTH + 0.5f) + half, chunkCellsAcross - 1);
+	int minZ = std::max((int)std::floor((low.z - currentSquare.z) / CHUNK_HEIGHT + 0.5f) + half, 0);
+	int maxZ = std::min((int)std::floor((high.z - currentSquare.z) / CHUNK_HEIGHT + 0.5f) + half, chunkCellsAcross - 1);
+	bool hit = false;
+	fraction = 1.0f;
+	for (int z = minZ; z <= maxZ; z++)
+	{
+		for (int x = minX; x <= maxX; x++)
+		{
+			int chunk = chunkCells[z * chunkCellsAcross + x];
+			float chunkFraction;
+			if (chunk >= 0 && chunks[chunk].SegmentHitsTrunk(start, end, radius, TRUNK_HEIGHT, chunkFraction) && chunkFraction <= fraction)
+			{
+				fraction = chunkFraction;
+				hit = true;
+			}
+		}
+	}
+	return hit;
+}
+
+void Simulation::addChunks()
+{
+	//at most the whole window is new, the lists only last this call so they come from the tick's scratch
+	unsigned int window = (unsigned int)((numChunks * 2 + 1) * (numChunks * 2 + 1));
+	LinearAllocator& scratch = jobs->Scratch(0);
+	glm::vec3* newPositions = scratch.Allocate<glm::vec3>(window);
+	unsigned int* seeds = scratch.Allocate<unsigned int>(window);
+	unsigned int newCount = 0;
+	for (int i = -numChunks; i <= numChunks; i++)
+	{
+		for (int j = -numChunks; j <= numChunks; j++)
+		{
+			auto x = currentSquare.x + (float)i * CHUNK_WIDTH;
+			auto z = currentSquare.z + (float)j * CHUNK_HEIGHT;
+
+			bool chunkFound = false;
+			for (unsigned int k = 0; k < chunks.size(); k++)
+			{
+				if (chunks[k].getPos().x == x && chunks[k].getPos().z == z)
+					chunkFound = true;
+			}
+			if (!chunkFound)
+			{
+				newPositions[newCount] = glm::vec3(x, 0.0f, z);
+				seeds[newCount++] = randomGen();
+			}
+		}
+	}
+
+	generateChunks(newPositions, seeds, newCount);
+}
+
+void Simulation::MirrorChunks(const glm::vec3* positions, const unsigned int* seeds, unsigned int count)
+{
+	//used instead of Tick, so the scratch is reset here instead
+	jobs->ResetScratch();
+	//chunks still in the list are kept as they are, so nothing built from their trees goes out of date
+	for (unsigned int i = 0; i < chunks.size(); i++)
+	{
+		bool kept = false;
+		for (unsigned int j = 0; j < count && !kept; j++)
+			kept = chunks[i].getPos() == positions[j] && chunks[i].getSeed() == seeds[j];
+		if (!kept)
+		{
+			spareChunks.push_back(std::move(chunks[i]));
+			chunks.erase(chunks.begin() + i--);
+		}
+	}
+	LinearAllocator& scratch = jobs->Scratch(0);
+	glm::vec3* newPositions = scratch.Allocate<glm::vec3>(count);
+	unsigned int* newSeeds = scratch.Allocate<unsigned int>(count);
+	unsigned int newCount = 0;
+	for (unsigned int j = 0; j < count; j++)
+	{
+		bool chunkFound = false;
+		for (unsigned int k = 0; k < chunks.size() && !chunkFound; k++)
+			chunkFound = chunks[k].getPos() == positions[j] && chunks[k].getSeed() == seeds[j];
+		if (!chunkFound)
+		{
+			newPositions[newCount] = positions[j];
+			newSeeds[newCount++] = seeds[j];
+		}
+	}
+	generateChunks(newPositions, newSeeds, newCount);
+}
+
+void Simulation::generateChunks(const glm::vec3* positions, const unsigned int* seeds, unsigned int count)
+{
+	//new chunks reuse dropped ones, then every new chunk gets its own generator, seeded in a fixed
+	//order, so the world is the same however the chunks are shared out between the workers
+	unsigned int first = (unsigned int)chunks.size();
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (spareChunks.empty())
+			chunks.emplace_back(MAX_TREES);
+		else
+		{
+			chunks.push_back(std::move(spareChunks.back()));
+			spareChunks.pop_back();
+		}
+	}
+	jobs->ParallelFor(count, 1, [&](unsigned int begin, unsigned int end, unsigned int worker)
+	{
+		for (unsigned int i = begin; i < end; i++)
+		{
+			std::mt19937 chunkGen(seeds[i]);
+			std::uniform_real_distribution<float> xRange = spawnXRange;
+			std::uniform_real_distribution<float> zRange = spawnZRange;
+			std::uniform_int_distribution<int> treeCount = treeRange;
+			chunks[first + i].Generate(positions[i], CHUNK_WIDTH, CHUNK_HEIGHT, chunkGen, xRange, zRange, treeCount, jobs->Scratch(worker), seeds[i]);
+		}
+	});
+}
+
+void Simulation::clearChunks()
+{
+	for (unsigned int i = 0; i < chunks.size(); i++)
+		spareChunks.push_back(std::move(chunks[i]));
+	chunks.clear();
+	std::fill(chunkCells.begin(), chunkCells.end(), -1);
+	flowField.Clear();
+}
+
+bool Simulation::collide()
+{
+	enemyGrid.Build(enemies.positions);
+	//every projectile's overlaps are found in parallel, then resolved in projectile order
+	//so an enemy hit by two projectiles goes to the same one as a serial loop would
+	unsigned int hitRanges = JobSystem::RangeCount(projectiles.Size(), PROJECTILE_GRAIN);
+	if (projectileHits.size() < hitRanges)
+		projectileHits.resize(hitRanges);
+	jobs->ParallelFor(projectiles.Size(), PROJECTILE_GRAIN, [&](unsigned int begin, unsigned int end, unsigned int worker)
+	{
+		std::vector<unsigned int>& hits = projectileHits[begin / PROJECTILE_GRAIN];
+		std::vector<unsigned int>& nearby = workerNearbyEnemies[worker];
+		hits.clear();
+		for (unsigned int i = begin; i < end; i++)
+		{
+			enemyGrid.QueryRadius(projectiles.positions[i], enemies.radius, nearby, &jobs->Scratch(worker));
+			for (unsigned int j = 0; j < nearby.size(); j++)
+			{
+				hits.push_back(i);
+				hits.push_back(nearby[j]);
+			}
+		}
+	});
+	for (unsigned int r = 0; r < hitRanges; r++)
+	{
+		for (unsigned int j = 0; j < projectileHits[r].size(); j += 2)
+		{
+			unsigned int enemy = projectileHits[r][j + 1];
+			if (enemies.alive[enemy])
+			{
+				impacts.push_back({ enemies.positions[enemy], glm::normalize(projectiles.velocities[projectileHits[r][j]]), Impact::Enemy });
+				enemies.Kill(enemy);
+				projectiles.Kill(projectileHits[r][j]);
+				score++;
+				if (settings.printScore)
+					std::cout << "\nHighscore: " << highscore << "\nScore:     " << score << std::endl;
+			}
+		}
+	}
+
+	danger = 0.0f;
+	float nearestDistance;
+	if (enemyGrid.Nearest(camera.getPos(), DANGER_RANGE, enemies.alive, nearestDistance) >= 0)
+		danger = 1.0f - ((nearestDistance + 1.0f) / DANGER_RANGE);
+	if (danger < 0.0f)
+		danger = 0.0f;
+	bool playerHit = false;
+	enemyGrid.QueryRadius(camera.getPos(), enemies.radius, nearbyEnemies);
+	for (unsigned int j = 0; j < nearbyEnemies.size(); j++)
+	{
+		if (enemies.alive[nearbyEnemies[j]])
+			playerHit = true;
+	}
+
+	enemies.RemoveDead();
+	projectiles.RemoveDead();
+	return playerHit;
+}
+
+unsigned long long Simulation::StateHash()
+{
+	unsigned long long hash = 14695981039346656037ull;
+	glm::vec3 position = camera.getPos();
+	glm::vec3 front = camera.getFront();
+	hashBytes(hash, &ticks, sizeof(ticks));
+	hashBytes(hash, &score, sizeof(score));
+	hashBytes(hash, &deaths, sizeof(deaths));
+	hashBytes(hash, &position, sizeof(position));
+	hashBytes(hash, &front, sizeof(front));
+	hashBytes(hash, &shotTimer, sizeof(shotTimer));
+	hashBytes(hash, &enemyTimer, sizeof(enemyTimer));
+	hashBytes(hash, &enemyDelay, sizeof(enemyDelay));
+	hashBytes(hash, enemies.positions.data(), enemies.Size() * sizeof(glm::vec3));
+	hashBytes(hash, enemies.velocities.data(), enemies.Size() * sizeof(glm::vec3));
+	hashBytes(hash, projectiles.positions.data(), projectiles.Size() * sizeof(glm::vec3));
+	hashBytes(hash, projectiles.velocities.data(), projectiles.Size() * sizeof(glm::vec3));
+	unsigned int chunkCount = (unsigned int)chunks.size();
+	hashBytes(hash, &chunkCount, sizeof(chunkCount));
+	for (unsigned int i = 0; i < chunks.size(); i++)
+	{
+		glm::vec3 chunkPos = chunks[i].getPos();
+		hashBytes(hash, &chunkPos, sizeof(chunkPos));
+		const std::vector<glm::vec3>& trees = chunks[i].getTreePositions();
+		hashBytes(hash, trees.data(), trees.size() * sizeof(glm::vec3));
+	}
+	return hash;
+}
+
+void Simulation::SaveSnapshot(std::vector<unsigned char>& out)
+{
+	out.insert(out.end(), SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + 4);
+	put(out, SNAPSHOT_VERSION);
+	put(out, settings.seed);
+	put(out, (unsigned char)(settings.flocking ? 1 : 0));
+	put(out, settings.stressEnemies);
+	put(out, settings.chunkRadius);
+
+	put(out, ticks);
+	put(out, score);
+	put(out, highscore);
+	put(out, deaths);
+	put(out, danger);
+
+	CameraState cameraState = camera.getState();
+	put(out, cameraState.position);
+	put(out, cameraState.previousPosition);
+	put(out, cameraState.front);
+	put(out, cameraState.horizontalFront);
+	put(out, cameraState.yaw);
+	put(out, cameraState.pitch);
+	put(out, cameraState.lastMouseX);
+	put(out, cameraState.lastMouseY);
+	put(out, (unsigned char)(cameraState.firstMouseUpdate ? 1 : 0));
+
+	//the standard library only hands out a generator's state as text
+	std::ostringstream generator;
+	generator << randomGen;
+	std::string generatorState = generator.str();
+	put(out, (unsigned int)generatorState.size());
+	out.insert(out.end(), generatorState.begin(), generatorState.end());
+
+	put(out, currentSquare);
+	put(out, shotTimer);
+	put(out, enemyTimer);
+	put(out, enemyDelay);
+	put(out, difficultyTimer);
+	put(out, (unsigned char)(enemiesEnabled ? 1 : 0));
+	put(out, (unsigned char)(holdingButton ? 1 : 0));
+
+	put(out, (unsigned int)chunks.size());
+	for (unsigned int i = 0; i < chunks.size(); i++)
+	{
+		const std::vector<glm::vec3>& trees = chunks[i].getTreePositions();
+		put(out, chunks[i].getPos());
+		put(out, chunks[i].getSeed());
+		put(out, (unsigned int)trees.size());
+		out.insert(out.end(), (const unsigned char*)trees.data(), (const unsigned char*)(trees.data() + trees.size()));
+	}
+	putEntities(out, enemies);
+	putEntities(out, projectiles);
+}
+
+bool Simulation::ReadSnapshotHeader(const unsigned char* data, size_t size, SnapshotHeader& header)
+{
+	SnapshotReader reader = { data, size, 0 };
+	return getHeader(reader, header);
+}
+
+bool Simulation::LoadSnapshot(const unsigned char* data, size_t size)
+{
+	SnapshotReader reader = { data, size, 0 };
+	SnapshotHeader header;
+	if (!getHeader(reader, header))
+		return false;
+	if (header.seed != settings.seed || (header.flocking != 0) != settings.flocking || header.stressEnemies != settings.stressEnemies || header.chunkRadius != settings.chunkRadius)
+	{
+		std::cout << "snapshot was saved with different settings" << std::endl;
+		return false;
+	}
+
+	//everything is read and checked before any of it is used
+	unsigned long long savedTicks = 0;
+	int savedScore = 0, savedHighscore = 0;
+	unsigned int savedDeaths = 0;
+	float savedDanger = 0.0f;
+	CameraState cameraState{};
+	unsigned char firstMouseUpdate = 0;
+	unsigned int generatorLength = 0;
+	bool valid = reader.get(savedTicks) && reader.get(savedScore) && reader.get(savedHighscore) && reader.get(savedDeaths) && reader.get(savedDanger) &&
+		reader.get(cameraState.position) && reader.get(cameraState.previousPosition) && reader.get(cameraState.front) && reader.get(cameraState.horizontalFront) &&
+		reader.get(cameraState.yaw) && reader.get(cameraState.pitch) && reader.get(cameraState.lastMouseX) && reader.get(cameraState.lastMouseY) &&
+		reader.get(firstMouseUpdate) && reader.get(generatorLength);
+
+	std::mt19937 generator;
+	if (valid)
+	{
+		const char* generatorText = (const char*)data + reader.offset;
+		valid = reader.skip(generatorLength);
+		if (valid)
+		{
+			std::istringstream generatorStream(std::string(generatorText, generatorLength));
+			generatorStream >> generator;
+			valid = !generatorStream.fail();
+		}
+	}
+
+	glm::vec3 savedSquare = glm::vec3(0.0f);
+	float savedShotTimer = 0.0f, savedEnemyTimer = 0.0f, savedEnemyDelay = 0.0f, savedDifficultyTimer = 0.0f;
+	unsigned char savedEnemiesEnabled = 0, savedHoldingButton = 0;
+	unsigned int chunkCount = 0;
+	valid = valid && reader.get(savedSquare) && reader.get(savedShotTimer) && reader.get(savedEnemyTimer) && reader.get(savedEnemyDelay) &&
+		reader.get(savedDifficultyTimer) && reader.get(savedEnemiesEnabled) && reader.get(savedHoldingButton) &&
+		reader.get(chunkCount) && chunkCount <= chunks.capacity();
+	size_t chunkStart = reader.offset;
+	for (unsigned int i = 0; valid && i < chunkCount; i++)
+	{
+		unsigned int treeCount = 0;
+		valid = reader.skip(sizeof(glm::vec3) + sizeof(unsigned int)) && reader.get(treeCount) && treeCount <= (unsigned int)MAX_TREES && reader.skip(treeCount * sizeof(glm::vec3));
+	}
+	unsigned int enemyCount = 0, projectileCount = 0;
+	size_t entityStart = reader.offset;
+	valid = valid && skipEntities(reader, enemies, enemyCount) && skipEntities(reader, projectiles, projectileCount);
+	if (!valid || reader.offset != size)
+	{
+		std::cout << "snapshot is damaged" << std::endl;
+		return false;
+	}
+
+	ticks = savedTicks;
+	score = savedScore;
+	highscore = savedHighscore;
+	deaths = savedDeaths;
+	danger = savedDanger;
+	cameraState.firstMouseUpdate = firstMouseUpdate != 0;
+	camera.setState(cameraState);
+	randomGen = generator;
+	currentSquare = savedSquare;
+	shotTimer = savedShotTimer;
+	enemyTimer = savedEnemyTimer;
+	enemyDelay = savedEnemyDelay;
+	difficultyTimer = savedDifficultyTimer;
+	enemiesEnabled = savedEnemiesEnabled != 0;
+	holdingButton = savedHoldingButton != 0;
+
+	//chunks are put back in the same order, the ones they replace go back to the spares
+	clearChunks();
+	reader.offset = chunkStart;
+	LinearAllocator& scratch = jobs->Scratch(0);
+	for (unsigned int i = 0; i < chunkCount; i++)
+	{
+		glm::vec3 chunkPos = glm::vec3(0.0f);
+		unsigned int chunkSeed = 0, treeCount = 0;
+		reader.get(chunkPos);
+		reader.get(chunkSeed);
+		reader.get(treeCount);
+		scratch.Reset();
+		glm::vec3* trees = scratch.Allocate<glm::vec3>(treeCount);
+		memcpy(trees, data + reader.offset, treeCount * sizeof(glm::vec3));
+		reader.offset += treeCount * sizeof(glm::vec3);
+		if (spareChunks.empty())
+			chunks.emplace_back(MAX_TREES);
+		else
+		{
+			chunks.push_back(std::move(spareChunks.back()));
+			spareChunks.pop_back();
+		}
+		chunks.back().Restore(chunkPos, CHUNK_WIDTH, CHUNK_HEIGHT, trees, treeCount, scratch, chunkSeed);
+	}
+	scratch.Reset();
+	flowField.SetOrigin(currentSquare);
+	for (unsigned int i = 0; i < chunks.size(); i++)
+		flowField.AddObstacles(chunks[i].getTreePositions(), TREE_CLEARANCE);
+	flowField.SetTarget(camera.getPos());
+
+	reader.offset = entityStart;
+	enemies.Clear();
+	projectiles.Clear();
+	getEntities(reader, enemies, enemies.radius);
+	getEntities(reader, projectiles, projectiles.radius);
+	return true;
+}
+
+void Simulation::addProjectile()
+{
+	if (shotTimer > SHOT_DELAY)
+	{
+		projectiles.Fire(camera.getPos(), glm::normalize(camera.getFront()));
+		shotTimer = 0.0f;
+	}
+}
+
+void Simulation::addEnemy()
+{
+	auto playerPos = camera.getPos();
+	auto direction = glm::vec3(spawnDirection(randomGen), spawnHeight(randomGen), spawnDirection(randomGen));
+	direction.x = cos(glm::radians(direction.x));
+	direction.z = sin(glm::radians(direction.z));
+	if (spawnQuadrant(randomGen) == 0)
+		direction.x *= -1;
+	if (spawnQuadrant(randomGen) == 0)
+		direction.z *= -1;
+	direction.x *= (camera.getRenderDistance() + 10.0f);
+	direction.z *= (camera.getRenderDistance() + 10.0f);
+	direction.x += playerPos.x;
+	direction.z += playerPos.z;
+	enemies.Spawn(direction);
+}
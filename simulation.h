@@ -0,0 +1,149 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <random>
+
+#include "camera.h"
+#include "chunk.h"
+#include "projectile.h"
+#include "enemy.h"
+#include "spatialHash.h"
+#include "flowField.h"
+#include "jobSystem.h"
+#include "input.h"
+#include "snapshotFile.h"
+
+struct SimulationSettings
+{
+	unsigned int seed = 0;
+	//enemies steer as a swarm instead of straight at the player
+	bool flocking = false;
+	//keeps this many enemies alive instead of spawning them on a timer, 0 for normal play
+	int stressEnemies = 0;
+	//print the score as it changes
+	bool printScore = true;
+	//chunks generated on each side of the one the player is in
+	int chunkRadius = 4;
+};
+
+//a hit the renderer can show, the simulation itself forgets it straight away
+struct Impact
+{
+	enum Kind : unsigned char
+	{
+		Tree,
+		Enemy
+	};
+	glm::vec3 position;
+	//the way the projectile was going, or back the way it came off a trunk
+	glm::vec3 direction;
+	Kind kind;
+};
+
+//everything the game does between frames: the player, chunks, enemies and projectiles.
+//it has no window or gl, so it runs the same headless as it does under the renderer,
+//which only reads the public state between ticks
+class Simulation
+{
+public:
+	Simulation(const SimulationSettings& settings, JobSystem& jobs);
+
+	//mouse look, applied every frame rather than waiting for a tick
+	void Look(InputSource& input, float timeElapsed);
+	void Tick(InputSource& input, float tickTime);
+	//drops chunks that are too far away and generates any missing around the player, part of every tick
+	void UpdateChunks();
+	//for a copy of the world that is never ticked: makes the chunks exactly the count given, from
+	//their positions and seeds, keeping the ones already there and generating the rest
+	void MirrorChunks(const glm::vec3* positions, const unsigned int* seeds, unsigned int count);
+	//hash of everything the ticks decide, two runs that ended the same way have the same hash
+	unsigned long long StateHash();
+	//writes everything needed to carry on from this point into out, laid out as in snapshotFile.h.
+	//call between ticks
+	void SaveSnapshot(std::vector<unsigned char>& out);
+	//the settings a snapshot was saved with, false if data isn't a snapshot this build can load
+	static bool ReadSnapshotHeader(const unsigned char* data, size_t size, SnapshotHeader& header);
+	//puts the simulation back how it was when the snapshot was saved. it has to have been made with the
+	//settings from ReadSnapshotHeader. the whole snapshot is checked first, if it is damaged nothing changes
+	bool LoadSnapshot(const unsigned char* data, size_t size);
+	//most chunks that can be loaded along one axis at once
+	int getLoadedAcross();
+
+	static constexpr float CHUNK_WIDTH = 30.0f;
+	static constexpr float CHUNK_HEIGHT = 30.0f;
+	static constexpr int MAX_TREES = 45;
+	//the tree model's trunk, projectiles stop when they pass through it
+	static constexpr float TRUNK_RADIUS = 0.5f;
+	static constexpr float TRUNK_HEIGHT = 3.8f;
+
+	Camera camera;
+	std::vector<Chunk> chunks;
+	ProjectilePool projectiles;
+	EnemyPool enemies;
+	//0 to 1, how close the nearest enemy is
+	float danger = 0.0f;
+	int score = 0;
+	int highscore = 0;
+	unsigned int deaths = 0;
+	unsigned long long ticks = 0;
+	//every hit in the last tick, in the same order each run. not part of the state hash or snapshots
+	std::vector<Impact> impacts;
+
+private:
+	SimulationSettings settings;
+	JobSystem* jobs;
+	std::mt19937 randomGen;
+
+	int numChunks;
+	int range;
+	int loadedAcross;
+	glm::vec3 currentSquare = glm::vec3(0.0f);
+	std::uniform_real_distribution<float> spawnXRange;
+	std::uniform_real_distribution<float> spawnZRange;
+	std::uniform_int_distribution<int> treeRange;
+	std::vector<Chunk*> collidingChunks;
+	//the loaded chunks by their place on the chunk lattice around currentSquare, -1 where there is none,
+	//so a projectile only tests the chunks it is passing through
+	std::vector<int> chunkCells;
+	int chunkCellsAcross;
+	//chunks that went out of range, regenerated in place of allocating new ones
+	std::vector<Chunk> spareChunks;
+	FlowField flowField;
+
+	float shotTimer = 0.1f;
+	bool enemiesEnabled = true;
+	bool holdingButton = false;
+	float enemyDelay;
+	float enemyTimer = 0.0f;
+	float difficultyTimer = 0.0f;
+	std::uniform_real_distribution<float> spawnDirection;
+	std::uniform_real_distribution<float> spawnHeight;
+	std::uniform_int_distribution<int> spawnQuadrant;
+	FlockSettings flockSettings;
+
+	//broadphase for bullet hits, player hits and danger, cells are a few enemies wide
+	SpatialHash enemyGrid;
+	std::vector<unsigned int> nearbyEnemies;
+	//bullet hits are found in parallel, one query buffer per worker and one hit list per range
+	std::vector<std::vector<unsigned int>> workerNearbyEnemies;
+	std::vector<std::vector<unsigned int>> projectileHits;
+	//trunk hits are found in parallel too, one list per range, and added to impacts in range order
+	std::vector<std::vector<Impact>> trunkImpacts;
+
+	void addChunks();
+	//generates count chunks into spare ones, each from its own seed
+	void generateChunks(const glm::vec3* positions, const unsigned int* seeds, unsigned int count);
+	void clearChunks();
+	void indexChunks();
+	//tests the move from start to end against the trunks in the chunks it passes through
+	bool segmentHitsTrunk(glm::vec3 start, glm::vec3 end, float radius, float& fraction);
+	//bullet hits, danger and whether an enemy reached the player
+	bool collide();
+	void addProjectile();
+	void addEnemy();
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SNAPSHOT_FILE_H
+#define SNAPSHOT_FILE_H
+
+//layout of a saved world, written by Simulation::SaveSnapshot and read back by Simulation::LoadSnapshot.
+//like replays everything is in the machine's byte order, and a snapshot only loads into the same version.
+//  header:      "FSSN", version, then SnapshotHeader's fields in order
+//  simulation:  ticks, score, highscore, deaths, danger
+//  camera:      CameraState's fields in order, firstMouseUpdate as a byte
+//  generator:   length as an unsigned int, then the random generator's state as text
+//  timers:      currentSquare, shotTimer, enemyTimer, enemyDelay, difficultyTimer, then enemiesEnabled
+//               and holdingButton as bytes
+//  chunks:      count, then for each its position, seed, tree count and tree positions
+//  enemies:     count, then every position, every previous position and every velocity
+//  projectiles: the same as enemies
+//positions are glm::vec3s, three floats. the flow field, enemy grid and anything drawn are worked out
+//again from the rest when it is loaded
+
+const char SNAPSHOT_MAGIC[4] = { 'F', 'S', 'S', 'N' };
+const unsigned short SNAPSHOT_VERSION = 2;
+
+//the settings the simulation has to be made with before the snapshot is loaded into it
+struct SnapshotHeader
+{
+	unsigned int seed = 0;
+	unsigned char flocking = 0;
+	int stressEnemies = 0;
+	int chunkRadius = 4;
+};
+
+#endif
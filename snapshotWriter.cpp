@@ -0,0 +1,65 @@
+#include "snapshotWriter.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+
+SnapshotWriter::~SnapshotWriter()
+{
+	Wait();
+}
+
+std::vector<unsigned char>& SnapshotWriter::Begin()
+{
+	Wait();
+	buffer.clear();
+	return buffer;
+}
+
+void SnapshotWriter::Write(const std::string& path)
+{
+	Wait();
+	this->path = path;
+	failed = false;
+	writing = true;
+	thread = std::thread(&SnapshotWriter::writeFile, this);
+}
+
+bool SnapshotWriter::Wait()
+{
+	if (thread.joinable())
+		thread.join();
+	return !failed;
+}
+
+bool SnapshotWriter::IsWriting()
+{
+	return writing;
+}
+
+void SnapshotWriter::writeFile()
+{
+	std::string partPath = path + ".part";
+	{
+		std::ofstream file(partPath, std::ios::binary | std::ios::trunc);
+		if (file)
+			file.write((const char*)buffer.data(), buffer.size());
+		if (!file)
+		{
+			std::cout << "failed to write snapshot " << partPath << std::endl;
+			failed = true;
+			writing = false;
+			return;
+		}
+	}
+#ifdef _WIN32
+	//rename won't replace a file on windows
+	std::remove(path.c_str());
+#endif
+	if (std::rename(partPath.c_str(), path.c_str()) != 0)
+	{
+		std::cout << "failed to move snapshot " << partPath << " to " << path << std::endl;
+		failed = true;
+	}
+	writing = false;
+}
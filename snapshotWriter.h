@@ -0,0 +1,38 @@
+#ifndef SNAPSHOT_WRITER_H
+#define SNAPSHOT_WRITER_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+//writes snapshots out on a thread of its own so saving doesn't hold up the frame it was taken in.
+//the simulation is copied into the writer's buffer on the calling thread, which is quick, and only
+//the disk is waited on in the background. the file is written next to path and moved over it once
+//it is complete, so a crash while saving leaves the last snapshot in place
+class SnapshotWriter
+{
+public:
+	SnapshotWriter() = default;
+	~SnapshotWriter();
+	SnapshotWriter(const SnapshotWriter&) = delete;
+	SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+	//the buffer to save the next snapshot into, waits for the last one to finish writing first
+	std::vector<unsigned char>& Begin();
+	//starts writing the buffer to path
+	void Write(const std::string& path);
+	//waits for the write in progress, false if it failed
+	bool Wait();
+	bool IsWriting();
+private:
+	std::thread thread;
+	std::vector<unsigned char> buffer;
+	std::string path;
+	std::atomic<bool> writing{ false };
+	bool failed = false;
+
+	void writeFile();
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include "spatialHash.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "collisionKernels.h"
+
+SpatialHash::SpatialHash(float cellSize, unsigned int tableSize)
+{
+	this->cellSize = cellSize;
+	unsigned int size = 1;
+	while (size < tableSize)
+		size <<= 1;
+	tableMask = size - 1;
+	cellStart.resize(size + 1, 0);
+	pointCells.reserve(tableSize);
+	entries.reserve(tableSize);
+	sortedX.reserve(tableSize);
+	sortedY.reserve(tableSize);
+	sortedZ.reserve(tableSize);
+	hits.reserve(tableSize);
+	queryBuckets.reserve(64);
+}
+
+int SpatialHash::cellCoord(float value)
+{
+	return (int)std::floor(value / cellSize);
+}
+
+unsigned int SpatialHash::bucket(int x, int z)
+{
+	return ((unsigned int)x * 73856093u ^ (unsigned int)z * 19349663u) & tableMask;
+}
+
+void SpatialHash::Build(const std::vector<glm::vec3>& positions)
+{
+	unsigned int count = (unsigned int)positions.size();
+	pointCells.resize(count);
+	entries.resize(count);
+	sortedX.resize(count);
+	sortedY.resize(count);
+	sortedZ.resize(count);
+	hits.resize(count);
+	std::fill(cellStart.begin(), cellStart.end(), 0);
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		pointCells[i] = bucket(cellCoord(positions[i].x), cellCoord(positions[i].z));
+		cellStart[pointCells[i] + 1]++;
+	}
+	for (unsigned int i = 1; i < cellStart.size(); i++)
+		cellStart[i] += cellStart[i - 1];
+	//cellStart[b] is used as the fill cursor then shifted back to the start of bucket b
+	for (unsigned int i = 0; i < count; i++)
+	{
+		unsigned int slot = cellStart[pointCells[i]]++;
+		entries[slot] = i;
+		sortedX[slot] = positions[i].x;
+		sortedY[slot] = positions[i].y;
+		sortedZ[slot] = positions[i].z;
+	}
+	for (unsigned int i = (unsigned int)cellStart.size() - 1; i > 0; i--)
+		cellStart[i] = cellStart[i - 1];
+	cellStart[0] = 0;
+}
+
+void SpatialHash::QueryRadius(glm::vec3 position, float radius, std::vector<unsigned int>& results, LinearAllocator* scratch)
+{
+	results.clear();
+	int minX = cellCoord(position.x - radius), maxX = cellCoord(position.x + radius);
+	int minZ = cellCoord(position.z - radius), maxZ = cellCoord(position.z + radius);
+	float radiusSquared = radius * radius;
+	float point[3] = { position.x, position.y, position.z };
+	//cells can hash to the same bucket, the ones already scanned are skipped. a query is only a few
+	//cells across, so looking back through the list is cheaper than anything cleverer
+	unsigned int cellCount = (unsigned int)((maxX - minX + 1) * (maxZ - minZ + 1));
+	unsigned int* scanned;
+	if (scratch != nullptr)
+		scanned = scratch->Allocate<unsigned int>(cellCount);
+	else
+	{
+		queryBuckets.resize(cellCount);
+		scanned = queryBuckets.data();
+	}
+	unsigned int scannedCount = 0;
+	for (int x = minX; x <= maxX; x++)
+	{
+		for (int z = minZ; z <= maxZ; z++)
+		{
+			unsigned int b = bucket(x, z);
+			if (std::find(scanned, scanned + scannedCount, b) != scanned + scannedCount)
+				continue;
+			scanned[scannedCount++] = b;
+			unsigned int start = cellStart[b];
+			unsigned int count = cellStart[b + 1] - start;
+			if (count == 0)
+				continue;
+			unsigned char* mask = scratch != nullptr ? scratch->Allocate<unsigned char>(count) : &hits[start];
+			if (PointSpheresHits(point, &sortedX[start], &sortedY[start], &sortedZ[start], count, radiusSquared, mask) == 0)
+				continue;
+			for (unsigned int i = 0; i < count; i++)
+			{
+				if (mask[i])
+					results.push_back(entries[start + i]);
+			}
+		}
+	}
+}
+
+int SpatialHash::Nearest(glm::vec3 position, float maxDistance, const std::vector<unsigned char>& alive, float& distance)
+{
+	int nearest = -1;
+	float bestSquared = maxDistance * maxDistance;
+	float point[3] = { position.x, position.y, position.z };
+	int centreX = cellCoord(position.x);
+	int centreZ = cellCoord(position.z);
+	int maxRing = (int)std::ceil(maxDistance / cellSize);
+	for (int ring = 0; ring <= maxRing; ring++)
+	{
+		//every cell on this ring is at least (ring - 1) cells away, stop once that is past the best found
+		float ringDistance = (ring - 1) * cellSize;
+		if (ring > 0 && ringDistance > 0.0f && ringDistance * ringDistance > bestSquared)
+			break;
+		for (int x = centreX - ring; x <= centreX + ring; x++)
+		{
+			//only the outline of the square, the inside was covered by earlier rings
+			int step = (x == centreX - ring || x == centreX + ring) ? 1 : 2 * ring;
+			for (int z = centreZ - ring; z <= centreZ + ring; z += (step > 0 ? step : 1))
+			{
+				unsigned int b = bucket(x, z);
+				unsigned int start = cellStart[b];
+				unsigned int count = cellStart[b + 1] - start;
+				if (count == 0)
+					continue;
+				float distanceSquared;
+				int closest = PointSpheresNearest(point, &sortedX[start], &sortedY[start], &sortedZ[start], count, distanceSquared);
+				if (alive[entries[start + closest]])
+				{
+					if (distanceSquared < bestSquared)
+					{
+						bestSquared = distanceSquared;
+						nearest = (int)entries[start + closest];
+					}
+					continue;
+				}
+				//the closest in this bucket is dead, fall back to checking each one
+				for (unsigned int i = start; i < start + count; i++)
+				{
+					if (!alive[entries[i]])
+						continue;
+					float dx = sortedX[i] - point[0], dy = sortedY[i] - point[1], dz = sortedZ[i] - point[2];
+					distanceSquared = (dx * dx + dy * dy) + dz * dz;
+					if (distanceSquared < bestSquared)
+					{
+						bestSquared = distanceSquared;
+						nearest = (int)entries[i];
+					}
+				}
+			}
+		}
+	}
+	if (nearest >= 0)
+		distance = std::sqrt(bestSquared);
+	return nearest;
+}
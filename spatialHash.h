@@ -0,0 +1,43 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "linearAllocator.h"
+
+//uniform grid over the ground plane (x and z) hashed into a fixed number of buckets.
+//it is rebuilt from scratch each tick with a counting sort, which is linear in the number of points
+//and does not allocate once the arrays have grown to fit.
+//points are copied out in bucket order so each bucket is tested with one batched distance kernel
+class SpatialHash
+{
+public:
+	//tableSize is rounded up to a power of two, and up to that many points fit without allocating
+	SpatialHash(float cellSize, unsigned int tableSize);
+
+	void Build(const std::vector<glm::vec3>& positions);
+	//every point within radius of position, written to results (which is cleared first), each point once
+	//even when two cells of the query share a bucket.
+	//with a scratch allocator the query doesn't touch any shared state, so queries can run in parallel
+	void QueryRadius(glm::vec3 position, float radius, std::vector<unsigned int>& results, LinearAllocator* scratch = nullptr);
+	//closest point within maxDistance whose alive flag is set, -1 if there is none
+	int Nearest(glm::vec3 position, float maxDistance, const std::vector<unsigned char>& alive, float& distance);
+
+private:
+	float cellSize;
+	unsigned int tableMask;
+	std::vector<unsigned int> cellStart;
+	std::vector<unsigned int> entries;
+	std::vector<unsigned int> pointCells;
+	std::vector<float> sortedX, sortedY, sortedZ;
+	std::vector<unsigned char> hits;
+	//the buckets a query without a scratch allocator has scanned so far
+	std::vector<unsigned int> queryBuckets;
+
+	int cellCoord(float value);
+	unsigned int bucket(int x, int z);
+};
+
+#endif
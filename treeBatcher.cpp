@@ -0,0 +1,215 @@
+#include "treeBatcher.h"
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <algorithm>
+
+#include "chunk.h"
+
+namespace
+{
+	//position, normal and texture coordinates
+	const int FLOATS_PER_VERTEX = 8;
+}
+
+TreeBatcher::TreeBatcher(Model& tree, unsigned int maxTrees, unsigned int maxBatches)
+{
+	this->tree = &tree;
+	this->maxTrees = maxTrees;
+	lodCount = tree.getLodCount();
+
+	const std::vector<Mesh>& meshes = tree.getMeshes();
+	for (unsigned int i = 0; i < meshes.size(); i++)
+	{
+		meshFirstVertex.push_back(verticesPerTree);
+		verticesPerTree += (unsigned int)meshes[i].getVertices().size();
+		unsigned int texture = meshes[i].getTextures().empty() ? 0 : meshes[i].getTextures()[0].id;
+		bool grouped = false;
+		for (Group& group : groups)
+		{
+			unsigned int groupTexture = group.textures->getTextures().empty() ? 0 : group.textures->getTextures()[0].id;
+			if (groupTexture == texture)
+			{
+				group.meshes.push_back(i);
+				grouped = true;
+				break;
+			}
+		}
+		if (!grouped)
+			groups.push_back({ &meshes[i], std::vector<unsigned int>(1, i) });
+	}
+	for (const Group& group : groups)
+	{
+		for (int lod = 0; lod < lodCount; lod++)
+		{
+			unsigned int count = 0;
+			for (unsigned int mesh : group.meshes)
+				count += meshes[mesh].getLod(std::min(lod, meshes[mesh].getLodCount() - 1)).indexCount;
+			groupLodOffsets.push_back(indicesPerTree);
+			groupLodIndices.push_back(count);
+			indicesPerTree += count;
+		}
+	}
+
+	//16 bit indices when a full batch can be addressed with them, like Mesh
+	if (verticesPerTree * maxTrees <= 0xFFFF)
+		indexType = GL_UNSIGNED_SHORT;
+	size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+	vertexData.resize((size_t)verticesPerTree * maxTrees * FLOATS_PER_VERTEX);
+	indexData.resize((size_t)indicesPerTree * maxTrees);
+	if (indexType == GL_UNSIGNED_SHORT)
+		shortIndexData.resize(indexData.size());
+
+	//every batch is allocated at full size now, building one only uploads into it
+	batches.resize(maxBatches);
+	for (Batch& batch : batches)
+	{
+		glGenVertexArrays(1, &batch.VAO);
+		glGenBuffers(1, &batch.VBO);
+		glGenBuffers(1, &batch.EBO);
+		glBindVertexArray(batch.VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, batch.VBO);
+		glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.EBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexData.size() * indexSize, NULL, GL_DYNAMIC_DRAW);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)(3 * sizeof(float)));
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)(6 * sizeof(float)));
+		glBindVertexArray(0);
+		gpuBytes += vertexData.size() * sizeof(float) + indexData.size() * indexSize;
+	}
+}
+
+TreeBatcher::~TreeBatcher()
+{
+	for (Batch& batch : batches)
+	{
+		glDeleteBuffers(1, &batch.EBO);
+		glDeleteBuffers(1, &batch.VBO);
+		glDeleteVertexArrays(1, &batch.VAO);
+	}
+}
+
+void TreeBatcher::build(Batch& batch, Chunk& chunk)
+{
+	const std::vector<Mesh>& meshes = tree->getMeshes();
+	const std::vector<glm::vec3>& trees = chunk.getTreePositions();
+	unsigned int treeCount = std::min((unsigned int)trees.size(), maxTrees);
+
+	float* vertex = vertexData.data();
+	for (unsigned int t = 0; t < treeCount; t++)
+	{
+		for (const Mesh& mesh : meshes)
+		{
+			for (const Vertex& source : mesh.getVertices())
+			{
+				*vertex++ = source.Position.x + trees[t].x;
+				*vertex++ = source.Position.y + trees[t].y;
+				*vertex++ = source.Position.z + trees[t].z;
+				*vertex++ = source.Normal.x;
+				*vertex++ = source.Normal.y;
+				*vertex++ = source.Normal.z;
+				*vertex++ = source.TexCoords.x;
+				*vertex++ = source.TexCoords.y;
+			}
+		}
+	}
+
+	unsigned int* index = indexData.data();
+	for (const Group& group : groups)
+	{
+		for (int lod = 0; lod < lodCount; lod++)
+		{
+			for (unsigned int t = 0; t < treeCount; t++)
+			{
+				for (unsigned int m : group.meshes)
+				{
+					const MeshLod& range = meshes[m].getLod(std::min(lod, meshes[m].getLodCount() - 1));
+					const std::vector<unsigned int>& indices = meshes[m].getIndices();
+					unsigned int base = t * verticesPerTree + meshFirstVertex[m];
+					for (unsigned int i = range.indexOffset; i < range.indexOffset + range.indexCount; i++)
+						*index++ = indices[i] + base;
+				}
+			}
+		}
+	}
+
+	size_t vertexFloats = (size_t)treeCount * verticesPerTree * FLOATS_PER_VERTEX;
+	size_t indexCount = (size_t)treeCount * indicesPerTree;
+	glBindBuffer(GL_ARRAY_BUFFER, batch.VBO);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, vertexFloats * sizeof(float), vertexData.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	//the element buffer is part of the vertex array's state, so it is bound through it
+	glBindVertexArray(batch.VAO);
+	if (indexType == GL_UNSIGNED_SHORT)
+	{
+		std::copy(indexData.begin(), indexData.begin() + indexCount, shortIndexData.begin());
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexCount * sizeof(unsigned short), shortIndexData.data());
+	}
+	else
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexCount * sizeof(unsigned int), indexData.data());
+	glBindVertexArray(0);
+
+	batch.generation = chunk.getGeneration();
+	batch.treeCount = treeCount;
+	batchesBuilt++;
+}
+
+void TreeBatcher::Draw(Shader& shader, Chunk& chunk, int lod)
+{
+	if (batches.empty())
+		return;
+	Batch* batch = nullptr;
+	Batch* oldest = &batches[0];
+	for (Batch& candidate : batches)
+	{
+		if (candidate.generation == chunk.getGeneration())
+		{
+			batch = &candidate;
+			break;
+		}
+		if (candidate.lastDrawn < oldest->lastDrawn)
+			oldest = &candidate;
+	}
+	if (batch == nullptr)
+	{
+		batch = oldest;
+		build(*batch, chunk);
+	}
+	batch->lastDrawn = ++drawCounter;
+	if (batch->treeCount == 0)
+		return;
+	if (lod >= lodCount)
+		lod = lodCount - 1;
+
+	glm::mat4 model = glm::mat4(1.0f);
+	glUniformMatrix4fv(shader.Location("model"), 1, GL_FALSE, &model[0][0]);
+	glBindVertexArray(batch->VAO);
+	size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+	for (unsigned int g = 0; g < groups.size(); g++)
+	{
+		unsigned int range = g * lodCount + lod;
+		groups[g].textures->BindTextures(shader);
+		glDrawElements(GL_TRIANGLES, batch->treeCount * groupLodIndices[range], indexType, (void*)(batch->treeCount * groupLodOffsets[range] * indexSize));
+	}
+	glBindVertexArray(0);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+unsigned int TreeBatcher::takeBatchesBuilt()
+{
+	unsigned int built = batchesBuilt;
+	batchesBuilt = 0;
+	return built;
+}
+
+size_t TreeBatcher::getGpuBytes()
+{
+	return gpuBytes;
+}
@@ -0,0 +1,76 @@
+#ifndef TREE_BATCHER_H
+#define TREE_BATCHER_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstddef>
+
+#include "shader.h"
+#include "model.h"
+
+class Chunk;
+
+//static batching, for gl drivers where lots of small draws cost more than the triangles do, like
+//software ones such as llvmpipe. every tree in a chunk is copied into one buffer with its position
+//already added, so the chunk's forest is one draw per material (bark and leaves) instead of one per
+//mesh per tree. the price is a copy of the tree model per tree, so there is a fixed number of
+//batches, sized to the chunks close enough to be drawn as models, and the least recently drawn
+//one is rebuilt for a chunk that needs one
+class TreeBatcher
+{
+public:
+	//tree has to be loaded with its geometry retained. maxTrees is the most trees a chunk can have
+	TreeBatcher(Model& tree, unsigned int maxTrees, unsigned int maxBatches);
+	~TreeBatcher();
+	TreeBatcher(const TreeBatcher&) = delete;
+	TreeBatcher& operator=(const TreeBatcher&) = delete;
+
+	//draws every tree in chunk at one lod, building a batch for it first if its trees have changed
+	void Draw(Shader& shader, Chunk& chunk, int lod);
+	//batches built since the last call
+	unsigned int takeBatchesBuilt();
+	size_t getGpuBytes();
+
+private:
+	struct Batch
+	{
+		unsigned int VAO = 0, VBO = 0, EBO = 0;
+		unsigned long long generation = 0;
+		unsigned long long lastDrawn = 0;
+		unsigned int treeCount = 0;
+	};
+	//meshes that share a texture are merged and drawn together
+	struct Group
+	{
+		const Mesh* textures;
+		std::vector<unsigned int> meshes;
+	};
+
+	Model* tree;
+	unsigned int maxTrees;
+	int lodCount;
+	std::vector<Group> groups;
+	std::vector<Batch> batches;
+	//per tree: the first vertex of each mesh, and the index count of each group at each lod with
+	//where that range starts. a batch's index buffer is every group at every lod, each range holding
+	//that group at that lod for all its trees, so the offsets are these times the tree count
+	std::vector<unsigned int> meshFirstVertex;
+	std::vector<unsigned int> groupLodIndices;
+	std::vector<unsigned int> groupLodOffsets;
+	unsigned int verticesPerTree = 0, indicesPerTree = 0;
+	GLenum indexType = GL_UNSIGNED_INT;
+	//the merged geometry is built here before it is uploaded, sized for maxTrees up front
+	std::vector<float> vertexData;
+	std::vector<unsigned int> indexData;
+	std::vector<unsigned short> shortIndexData;
+	unsigned long long drawCounter = 0;
+	unsigned int batchesBuilt = 0;
+	size_t gpuBytes = 0;
+
+	void build(Batch& batch, Chunk& chunk);
+};
+
+#endif
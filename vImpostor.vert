@@ -0,0 +1,36 @@
+#version 330 core
+layout (location = 0) in vec3 aCenter;
+layout (location = 1) in vec2 aCorner;
+
+out vec2 TexCoords;
+out vec3 FragPos;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 viewPos;
+uniform float halfWidth;
+uniform float bottom;
+uniform float height;
+uniform int angles;
+
+const float TWO_PI = 6.28318530718;
+
+void main()
+{
+    // turn around the vertical axis to face the camera
+    vec2 toCamera = viewPos.xz - aCenter.xz;
+    if (dot(toCamera, toCamera) < 0.0001)
+        toCamera = vec2(1.0, 0.0);
+    toCamera = normalize(toCamera);
+    vec3 right = vec3(toCamera.y, 0.0, -toCamera.x);
+
+    // pick the atlas tile baked from the nearest angle
+    float angle = atan(toCamera.y, toCamera.x);
+    if (angle < 0.0)
+        angle += TWO_PI;
+    float tile = mod(floor(angle / TWO_PI * float(angles) + 0.5), float(angles));
+    TexCoords = vec2((tile + aCorner.x * 0.5 + 0.5) / float(angles), aCorner.y);
+
+    FragPos = aCenter + right * aCorner.x * halfWidth + vec3(0.0, bottom + aCorner.y * height, 0.0);
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
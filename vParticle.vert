@@ -0,0 +1,34 @@
+#version 330 core
+layout (location = 0) in vec4 aPositionLife;
+layout (location = 1) in vec4 aVelocityKind;
+
+out vec4 Colour;
+
+const int MAX_KINDS = 4;
+
+uniform mat4 view;
+uniform mat4 projection;
+// pixels a point one unit wide covers one unit from the camera
+uniform float pointScale;
+// colour and size, and the longest lifetime of each kind
+uniform vec4 kindColourSize[MAX_KINDS];
+uniform float kindLifetime[MAX_KINDS];
+
+void main()
+{
+    int kind = int(aVelocityKind.w);
+    vec4 viewPos = view * vec4(aPositionLife.xyz, 1.0);
+    // dead slots go outside the clip volume and are dropped before rasterizing
+    if (aPositionLife.w <= 0.0 || viewPos.z > -0.05)
+    {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        gl_PointSize = 0.0;
+        Colour = vec4(0.0);
+        return;
+    }
+    gl_Position = projection * viewPos;
+    gl_PointSize = max(kindColourSize[kind].w * pointScale / -viewPos.z, 1.0);
+    // fades out over the end of its life
+    float fade = clamp(aPositionLife.w / kindLifetime[kind] * 2.0, 0.0, 1.0);
+    Colour = vec4(kindColourSize[kind].rgb, fade);
+}
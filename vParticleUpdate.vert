@@ -0,0 +1,94 @@
+#version 330 core
+// moves every particle one frame and spawns this frame's bursts, written back out with transform
+// feedback. ParticleSystem::Spawn and ParticleSystem::Move are the same thing on the cpu
+layout (location = 0) in vec4 aPositionLife;
+layout (location = 1) in vec4 aVelocityKind;
+
+out vec4 positionLife;
+out vec4 velocityKind;
+
+// ParticleSystem::MAX_BURSTS, and room for every ParticleKind
+const int MAX_BURSTS = 64;
+const int MAX_KINDS = 4;
+
+uniform int burstCount;
+// position and kind, direction, and where each burst's slots end counted from ringStart
+uniform vec4 burstPositionKind[MAX_BURSTS];
+uniform vec3 burstDirection[MAX_BURSTS];
+uniform int burstEnd[MAX_BURSTS];
+uniform int ringStart;
+uniform int capacity;
+uniform uint frame;
+uniform float timeElapsed;
+// speed, spread, lifetime and drag of each kind
+uniform vec4 kindMotion[MAX_KINDS];
+uniform float gravity;
+uniform float bounce;
+
+const float TWO_PI = 6.28318530718;
+
+// lowbias32
+uint hash(uint x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+float unitFloat(uint x)
+{
+    return float(hash(x) >> 8) * (1.0 / 16777216.0);
+}
+
+void main()
+{
+    vec3 position = aPositionLife.xyz;
+    float life = aPositionLife.w;
+    vec3 velocity = aVelocityKind.xyz;
+    int kind = int(aVelocityKind.w);
+
+    // slots after ringStart belong to this frame's bursts, in order
+    int slot = (gl_VertexID - ringStart + capacity) % capacity;
+    int start = 0;
+    for (int b = 0; b < burstCount; b++)
+    {
+        if (slot < burstEnd[b])
+        {
+            kind = int(burstPositionKind[b].w);
+            vec4 motion = kindMotion[kind];
+            uint first = uint((ringStart + start) % capacity);
+            uint seed = hash(first ^ hash(frame)) + uint(slot - start) * 4u;
+            float z = unitFloat(seed) * 2.0 - 1.0;
+            float angle = unitFloat(seed + 1u) * TWO_PI;
+            float ring = sqrt(max(1.0 - z * z, 0.0));
+            vec3 randomDirection = vec3(ring * cos(angle), ring * sin(angle), z);
+            vec3 direction = burstDirection[b] * (1.0 - motion.y) + randomDirection * motion.y;
+            float directionLength = length(direction);
+            direction = directionLength > 0.0001 ? direction / directionLength : randomDirection;
+            position = burstPositionKind[b].xyz;
+            velocity = direction * motion.x * (0.5 + 0.5 * unitFloat(seed + 2u));
+            life = motion.z * (0.6 + 0.4 * unitFloat(seed + 3u));
+            break;
+        }
+        start = burstEnd[b];
+    }
+
+    if (life > 0.0)
+    {
+        life -= timeElapsed;
+        velocity.y += gravity * timeElapsed;
+        velocity *= max(1.0 - kindMotion[kind].w * timeElapsed, 0.0);
+        position += velocity * timeElapsed;
+        if (position.y < 0.0)
+        {
+            position.y = 0.0;
+            velocity.y = -velocity.y * bounce;
+        }
+    }
+
+    positionLife = vec4(position, life);
+    velocityKind = vec4(velocity, float(kind));
+}